@@ -2,6 +2,7 @@
 #include "utils/timeutils.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QHash>
 #include <algorithm>
 #include <QDebug>
 
@@ -106,107 +107,189 @@ tl::expected<QVector<Trials::TrialInfo>, QString> Aggregates::EventAggregate::ge
     return m_trialsRepo->getAllTrials();
 }
 
-tl::expected<QVector<Aggregates::CrossTrialRanking>, QString> Aggregates::EventAggregate::getCrossTrialRanking() const {
+tl::expected<QVector<Aggregates::CrossTrialRanking>, QString> Aggregates::EventAggregate::getCrossTrialRanking(const int limit) const {
+    return collectCrossTrialRanking(limit, true);
+}
+
+tl::expected<QVector<Athletes::Athlete>, QString> Aggregates::EventAggregate::getTopParticipatingAthletes(const int limit) const {
+    auto crossRankingResult = collectCrossTrialRanking(limit, false);
+    if (!crossRankingResult) {
+        return tl::unexpected(crossRankingResult.error());
+    }
+
+    QVector<Athletes::Athlete> topAthletes;
+    topAthletes.reserve(crossRankingResult->size());
+    for (const auto& ranking : crossRankingResult.value()) {
+        topAthletes.append(ranking.athlete);
+    }
+
+    return topAthletes;
+}
+
+tl::expected<QHash<int, Utils::DurationStatistics>, QString> Aggregates::EventAggregate::getDurationStatisticsByTrial() const {
+    return collectDurationStatistics("reg.trialId");
+}
+
+tl::expected<QHash<int, Utils::DurationStatistics>, QString> Aggregates::EventAggregate::getDurationStatisticsByCategory() const {
+    return collectDurationStatistics("reg.categoryId");
+}
+
+tl::expected<QHash<int, Utils::DurationStatistics>, QString> Aggregates::EventAggregate::getDurationStatisticsByModality() const {
+    return collectDurationStatistics("reg.modalityId");
+}
+
+tl::expected<QHash<int, Utils::DurationStatistics>, QString> Aggregates::EventAggregate::collectDurationStatistics(const QString& keyColumn) const {
     QSqlQuery query(m_db);
-    
-    // simplified query - formatting done in C++
+    query.setForwardOnly(true);
+    const QString sql = QString(R"(
+        SELECT %1, r.durationMs
+        FROM results r
+        JOIN registrations reg ON r.registrationId = reg.id
+        JOIN categories c ON reg.categoryId = c.id
+        JOIN modalities m ON reg.modalityId = m.id
+        ORDER BY %1
+    )").arg(keyColumn);
+
+    if (!query.exec(sql)) {
+        return tl::unexpected("[EA] Error getting duration statistics: " + query.lastError().text());
+    }
+
+    // The buffer is reused for every key, so each group is one contiguous array
+    QHash<int, Utils::DurationStatistics> statistics;
+    QVector<int> durations;
+    int currentKey = 0;
+    while (query.next()) {
+        const int key = query.value(0).toInt();
+        if (key != currentKey && !durations.isEmpty()) {
+            statistics.insert(currentKey, Utils::DurationStats::compute(durations));
+            durations.clear();
+        }
+        currentKey = key;
+        durations.append(query.value(1).toInt());
+    }
+    if (!durations.isEmpty()) {
+        statistics.insert(currentKey, Utils::DurationStats::compute(durations));
+    }
+    return statistics;
+}
+
+tl::expected<QVector<Aggregates::CrossTrialRanking>, QString> Aggregates::EventAggregate::collectCrossTrialRanking(const int limit, const bool includeTrialResults) const {
+    // One ordered scan over every result; rows arrive grouped by trial and fastest first,
+    // so the trial position is a running counter and each athlete is folded into its accumulator
     const QString sql = R"(
-        SELECT 
-            a.id as athlete_id,
-            a.name as athlete_name,
-            COUNT(DISTINCT reg.trialId) as total_participations,
-            MIN(r.durationMs) as best_time_ms,
-            AVG(CAST(r.durationMs AS REAL)) as average_time
-        FROM athletes a
-        JOIN registrations reg ON a.id = reg.athleteId
-        JOIN results r ON reg.id = r.registrationId
-        GROUP BY a.id, a.name
-        HAVING COUNT(DISTINCT reg.trialId) > 0
-        ORDER BY total_participations DESC, average_time ASC
+        SELECT
+            reg.trialId,
+            a.id as athlete_id, a.name as athlete_name,
+            c.id as category_id, c.name as category_name,
+            m.id as modality_id, m.name as modality_name,
+            reg.plateCode,
+            r.id as result_id, r.registrationId, r.startTime, r.endTime, r.durationMs, r.notes, r.elapsedNs
+        FROM results r
+        JOIN registrations reg ON r.registrationId = reg.id
+        JOIN athletes a ON reg.athleteId = a.id
+        LEFT JOIN categories c ON reg.categoryId = c.id
+        LEFT JOIN modalities m ON reg.modalityId = m.id
+        ORDER BY reg.trialId, r.durationMs ASC, r.id ASC
     )";
 
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+
     if (!query.exec(sql)) {
         return tl::unexpected("[EA] Error getting cross-trial ranking: " + query.lastError().text());
     }
 
-    QVector<CrossTrialRanking> crossRanking;
-    
-    while (query.next()) {
+    struct Accumulator {
         CrossTrialRanking ranking;
-        
-        ranking.athlete = Athletes::Athlete {
-            .id = query.value(0).toInt(),
-            .name = query.value(1).toString()
-        };
-        
-        ranking.totalParticipations = query.value(2).toInt();
-        ranking.averageTime = query.value(4).toDouble();
-        ranking.bestTime = Utils::TimeFormatter::formatTime(query.value(3).toInt());
-        
-        // Fetch detailed results of this athlete in all trials
-        QSqlQuery detailQuery(m_db);
-        const QString detailSql = R"(
-            SELECT 
-                ROW_NUMBER() OVER (PARTITION BY reg.trialId ORDER BY r.durationMs ASC) as position,
-                a.id as athlete_id, a.name as athlete_name,
-                c.id as category_id, c.name as category_name,
-                m.id as modality_id, m.name as modality_name,
-                reg.plateCode,
-                r.id as result_id, r.registrationId, r.startTime, r.endTime, r.durationMs, r.notes
-            FROM results r
-            JOIN registrations reg ON r.registrationId = reg.id  
-            JOIN athletes a ON reg.athleteId = a.id
-            JOIN categories c ON reg.categoryId = c.id
-            JOIN modalities m ON reg.modalityId = m.id
-            WHERE a.id = :athleteId
-            ORDER BY reg.trialId, r.durationMs ASC
-        )";
-        
-        detailQuery.prepare(detailSql);
-        detailQuery.bindValue(":athleteId", ranking.athlete.id);
-        
-        if (detailQuery.exec()) {
-            while (detailQuery.next()) {
-                const Athletes::Athlete athlete { .id = detailQuery.value(1).toInt(), .name = detailQuery.value(2).toString() };
-                const Categories::Category category { .id = detailQuery.value(3).toInt(), .name = detailQuery.value(4).toString() };
-                const Modalities::Modality modality { .id = detailQuery.value(5).toInt(), .name = detailQuery.value(6).toString() };
-                const Results::Result result {
-                    .id = detailQuery.value(8).toInt(), .registrationId = detailQuery.value(9).toInt(),
-                    .startTime = QDateTime::fromString(detailQuery.value(10).toString(), Qt::ISODate),
-                    .endTime = QDateTime::fromString(detailQuery.value(11).toString(), Qt::ISODate),
-                    .durationMs = detailQuery.value(12).toInt(), .notes = detailQuery.value(13).toString()
-                };
-
-                ranking.trialResults.append({
-                    .position = detailQuery.value(0).toInt(), .athlete = athlete, .category = category,
-                    .modality = modality, .plateCode = detailQuery.value(7).toString(),
-                    .result = result, .formattedTime = Utils::TimeFormatter::formatTime(result.durationMs)
-                });
-            }
+        int lastTrialId = 0;
+        int bestMs = 0;
+        qint64 sumMs = 0;
+        int resultCount = 0;
+    };
+
+    QVector<Accumulator> accumulators;
+    QHash<int, qsizetype> accumulatorByAthlete;
+
+    int currentTrialId = 0;
+    int position = 0;
+
+    while (query.next()) {
+        const int trialId = query.value(0).toInt();
+        if (trialId != currentTrialId) {
+            currentTrialId = trialId;
+            position = 0;
+        }
+        ++position;
+
+        const int athleteId = query.value(1).toInt();
+        auto slot = accumulatorByAthlete.constFind(athleteId);
+        if (slot == accumulatorByAthlete.constEnd()) {
+            Accumulator created;
+            created.ranking.athlete = Athletes::Athlete { .id = athleteId, .name = query.value(2).toString() };
+            created.ranking.totalParticipations = 0;
+            created.ranking.averageTime = 0.0;
+            slot = accumulatorByAthlete.insert(athleteId, accumulators.size());
+            accumulators.push_back(std::move(created));
         }
-        
-        crossRanking.append(ranking);
-    }
 
-    return crossRanking;
-}
+        Accumulator& acc = accumulators[slot.value()];
+        const int durationMs = query.value(12).toInt();
 
-tl::expected<QVector<Athletes::Athlete>, QString> Aggregates::EventAggregate::getTopParticipatingAthletes(const int limit) const {
-    auto crossRankingResult = getCrossTrialRanking();
-    if (!crossRankingResult) {
-        return tl::unexpected(crossRankingResult.error());
+        if (acc.lastTrialId != trialId) {
+            acc.lastTrialId = trialId;
+            acc.ranking.totalParticipations++;
+        }
+        acc.bestMs = acc.resultCount == 0 ? durationMs : std::min(acc.bestMs, durationMs);
+        acc.sumMs += durationMs;
+        acc.resultCount++;
+
+        if (!includeTrialResults) {
+            continue;
+        }
+
+        const auto category = Categories::CategoryRef::of(query.value(3).toInt(), [&query]() { return query.value(4).toString(); });
+        const auto modality = Modalities::ModalityRef::of(query.value(5).toInt(), [&query]() { return query.value(6).toString(); });
+        const Results::Result result {
+            .id = query.value(8).toInt(), .registrationId = query.value(9).toInt(),
+            .startTime = Utils::DateTimeUtils::fromEpochMs(query.value(10)),
+            .endTime = Utils::DateTimeUtils::fromEpochMs(query.value(11)),
+            .durationMs = durationMs, .notes = query.value(13).toString(),
+            .elapsedNs = query.value(14).toLongLong()
+        };
+
+        acc.ranking.trialResults.append({
+            .position = position, .athlete = acc.ranking.athlete, .category = category,
+            .modality = modality, .plateCode = query.value(7).toString(),
+            .result = result, .formattedTime = Utils::TimeFormatter::formatTime(durationMs)
+        });
     }
 
-    QVector<Athletes::Athlete> topAthletes;
-    int count = 0;
-    
-    for (const auto& ranking : crossRankingResult.value()) {
-        if (count >= limit) break;
-        topAthletes.append(ranking.athlete);
-        count++;
+    // Most participations first, then the lowest average time
+    for (auto& acc : accumulators) {
+        acc.ranking.averageTime = static_cast<double>(acc.sumMs) / acc.resultCount;
     }
+    const auto ranksBefore = [](const Accumulator& lhs, const Accumulator& rhs) {
+        if (lhs.ranking.totalParticipations != rhs.ranking.totalParticipations) {
+            return lhs.ranking.totalParticipations > rhs.ranking.totalParticipations;
+        }
+        if (lhs.ranking.averageTime != rhs.ranking.averageTime) {
+            return lhs.ranking.averageTime < rhs.ranking.averageTime;
+        }
+        return lhs.ranking.athlete.id < rhs.ranking.athlete.id;
+    };
 
-    return topAthletes;
+    const qsizetype count = limit >= 0 ? std::min<qsizetype>(limit, accumulators.size()) : accumulators.size();
+    std::partial_sort(accumulators.begin(), accumulators.begin() + count, accumulators.end(), ranksBefore);
+
+    QVector<CrossTrialRanking> crossRanking;
+    crossRanking.reserve(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        Accumulator& acc = accumulators[i];
+        acc.ranking.bestTime = Utils::TimeFormatter::formatTime(acc.bestMs);
+        crossRanking.append(std::move(acc.ranking));
+    }
+
+    return crossRanking;
 }
 
 tl::expected<Trials::TrialInfo, QString> Aggregates::EventAggregate::createTrial(
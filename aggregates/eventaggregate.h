@@ -18,6 +18,7 @@
 #include <QVector>
 #include <QDateTime>
 #include <QMap>
+#include <QHash>
 #include <memory>
 #include <optional>
 #include <QSqlDatabase>
@@ -55,8 +56,14 @@ public:
 
     [[nodiscard]] tl::expected<EventStatistics, QString> getEventStatistics() const;
     [[nodiscard]] tl::expected<QVector<Trials::TrialInfo>, QString> getAllTrials() const;
-    [[nodiscard]] tl::expected<QVector<CrossTrialRanking>, QString> getCrossTrialRanking() const;
+    // Athletes ordered by participations, then average time; limit < 0 returns everyone
+    [[nodiscard]] tl::expected<QVector<CrossTrialRanking>, QString> getCrossTrialRanking(int limit = -1) const;
     [[nodiscard]] tl::expected<QVector<Athletes::Athlete>, QString> getTopParticipatingAthletes(int limit = 10) const;
+
+    // Duration statistics of every ranked result, keyed by trial / category / modality id
+    [[nodiscard]] tl::expected<QHash<int, Utils::DurationStatistics>, QString> getDurationStatisticsByTrial() const;
+    [[nodiscard]] tl::expected<QHash<int, Utils::DurationStatistics>, QString> getDurationStatisticsByCategory() const;
+    [[nodiscard]] tl::expected<QHash<int, Utils::DurationStatistics>, QString> getDurationStatisticsByModality() const;
     
     // Create new trial
     [[nodiscard]] tl::expected<Trials::TrialInfo, QString> createTrial(
@@ -83,6 +90,11 @@ private:
     std::shared_ptr<Results::Repository> m_resultsRepo;
     
     std::unique_ptr<TrialAggregate> m_trialAggregate;
+
+    // Single ordered scan folded into per-athlete accumulators; only the first `limit` rankings are materialized
+    [[nodiscard]] tl::expected<QVector<CrossTrialRanking>, QString> collectCrossTrialRanking(int limit, bool includeTrialResults) const;
+    // One scan ordered by the key column; each contiguous run of durations goes through the kernel
+    [[nodiscard]] tl::expected<QHash<int, Utils::DurationStatistics>, QString> collectDurationStatistics(const QString& keyColumn) const;
 };
 
 };
@@ -0,0 +1,138 @@
+#include "rankingindex.h"
+#include "trialsnapshot.h"
+#include <QDebug>
+#include <algorithm>
+
+tl::expected<void, QString> Aggregates::RankingIndex::rebuild(const QSqlDatabase& db, const int trialId) {
+    auto snapshot = TrialSnapshot::load(db, trialId, true);
+    if (!snapshot.has_value()) {
+        return tl::unexpected("[RK] Error loading results of trial " + QString::number(trialId) + ": " + snapshot.error());
+    }
+
+    rebuild(snapshot.value());
+    return {};
+}
+
+void Aggregates::RankingIndex::rebuild(const TrialSnapshot& snapshot) {
+    clear();
+    m_trialId = snapshot.trialId;
+    m_entries.reserve(snapshot.resultCount());
+
+    for (qsizetype i = 0; i < snapshot.resultCount(); ++i) {
+        if (snapshot.isRanked(snapshot.resultRows[i])) {
+            insert(snapshot.rankingEntry(static_cast<int>(i)));
+        }
+    }
+
+    qDebug() << "[RK] Ranking of trial" << m_trialId << "rebuilt with" << m_entries.size() << "results";
+}
+
+void Aggregates::RankingIndex::clear() {
+    m_trialId = -1;
+    m_entries.clear();
+    m_overall.clear();
+    m_byCategory.clear();
+    m_byModality.clear();
+}
+
+void Aggregates::RankingIndex::insert(const RankingEntry& entry) {
+    remove(entry.result.id);
+
+    const Key key = keyOf(entry);
+    m_overall.insert(key);
+    m_byCategory[entry.category.id].insert(key);
+    m_byModality[entry.modality.id].insert(key);
+    m_entries.insert(entry.result.id, entry);
+}
+
+bool Aggregates::RankingIndex::remove(const int resultId) {
+    const auto it = m_entries.constFind(resultId);
+    if (it == m_entries.constEnd()) {
+        return false;
+    }
+
+    const Key key = keyOf(it.value());
+    m_overall.erase(key);
+
+    if (const auto category = m_byCategory.find(it->category.id); category != m_byCategory.end()) {
+        category->second.erase(key);
+        if (category->second.isEmpty()) {
+            m_byCategory.erase(category);
+        }
+    }
+    if (const auto modality = m_byModality.find(it->modality.id); modality != m_byModality.end()) {
+        modality->second.erase(key);
+        if (modality->second.isEmpty()) {
+            m_byModality.erase(modality);
+        }
+    }
+
+    m_entries.erase(it);
+    return true;
+}
+
+int Aggregates::RankingIndex::position(const int resultId) const {
+    return positionIn(&m_overall, resultId);
+}
+
+int Aggregates::RankingIndex::categoryPosition(const int resultId) const {
+    const RankingEntry* entry = find(resultId);
+    if (!entry) {
+        return 0;
+    }
+    const auto partition = m_byCategory.find(entry->category.id);
+    return partition != m_byCategory.end() ? positionIn(&partition->second, resultId) : 0;
+}
+
+int Aggregates::RankingIndex::modalityPosition(const int resultId) const {
+    const RankingEntry* entry = find(resultId);
+    if (!entry) {
+        return 0;
+    }
+    const auto partition = m_byModality.find(entry->modality.id);
+    return partition != m_byModality.end() ? positionIn(&partition->second, resultId) : 0;
+}
+
+QVector<Aggregates::RankingEntry> Aggregates::RankingIndex::top(const int limit) const {
+    return collect(&m_overall, limit);
+}
+
+QVector<Aggregates::RankingEntry> Aggregates::RankingIndex::topByCategory(const int categoryId, const int limit) const {
+    const auto partition = m_byCategory.find(categoryId);
+    return collect(partition != m_byCategory.end() ? &partition->second : nullptr, limit);
+}
+
+QVector<Aggregates::RankingEntry> Aggregates::RankingIndex::topByModality(const int modalityId, const int limit) const {
+    const auto partition = m_byModality.find(modalityId);
+    return collect(partition != m_byModality.end() ? &partition->second : nullptr, limit);
+}
+
+const Aggregates::RankingEntry* Aggregates::RankingIndex::find(const int resultId) const {
+    const auto it = m_entries.constFind(resultId);
+    return it != m_entries.constEnd() ? &it.value() : nullptr;
+}
+
+int Aggregates::RankingIndex::positionIn(const Partition* partition, const int resultId) const {
+    const RankingEntry* entry = find(resultId);
+    if (!partition || !entry) {
+        return 0;
+    }
+    return static_cast<int>(partition->rank(keyOf(*entry))) + 1;
+}
+
+QVector<Aggregates::RankingEntry> Aggregates::RankingIndex::collect(const Partition* partition, const int limit) const {
+    QVector<RankingEntry> ranking;
+    if (!partition) {
+        return ranking;
+    }
+
+    ranking.reserve(limit >= 0 ? std::min<qsizetype>(limit, partition->size()) : partition->size());
+    partition->forEach([this, &ranking](const Key& key) {
+        RankingEntry entry = m_entries.value(key.resultId);
+        entry.position = static_cast<int>(ranking.size()) + 1;
+        ranking.append(std::move(entry));
+        return true;
+    }, limit);
+
+    return ranking;
+}
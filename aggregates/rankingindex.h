@@ -0,0 +1,74 @@
+#ifndef RANKINGINDEX_H
+#define RANKINGINDEX_H
+
+#include "trialaggregate.h"
+#include "utils/orderstatistictree.h"
+#include <QHash>
+#include <QVector>
+#include <QSqlDatabase>
+#include <tl/expected.hpp>
+#include <unordered_map>
+
+namespace Aggregates {
+
+struct TrialSnapshot;
+
+// In-memory ranking of one trial, kept up to date result by result.
+// Results are ordered by duration (result id breaks ties) in an overall partition
+// plus one partition per category and per modality, so inserting a finish,
+// asking for a position or reading the top N never touches the database.
+class RankingIndex
+{
+public:
+    // Loads the trial's snapshot and ranks every result in it
+    [[nodiscard]] tl::expected<void, QString> rebuild(const QSqlDatabase& db, int trialId);
+    void rebuild(const TrialSnapshot& snapshot);
+    void clear();
+
+    // O(log n); an entry with an id already present replaces the previous one
+    void insert(const RankingEntry& entry);
+    bool remove(int resultId);
+
+    // 1-based positions, 0 when the result is not ranked
+    [[nodiscard]] int position(int resultId) const;
+    [[nodiscard]] int categoryPosition(int resultId) const;
+    [[nodiscard]] int modalityPosition(int resultId) const;
+
+    // Entries in ranking order with `position` set within the partition; limit < 0 returns all
+    [[nodiscard]] QVector<RankingEntry> top(int limit = -1) const;
+    [[nodiscard]] QVector<RankingEntry> topByCategory(int categoryId, int limit = -1) const;
+    [[nodiscard]] QVector<RankingEntry> topByModality(int modalityId, int limit = -1) const;
+
+    [[nodiscard]] const RankingEntry* find(int resultId) const;
+    [[nodiscard]] int trialId() const { return m_trialId; }
+    [[nodiscard]] qsizetype size() const { return m_entries.size(); }
+    [[nodiscard]] bool isEmpty() const { return m_entries.isEmpty(); }
+
+private:
+    struct Key {
+        int durationMs;
+        int resultId;
+
+        bool operator<(const Key& other) const {
+            return durationMs != other.durationMs ? durationMs < other.durationMs : resultId < other.resultId;
+        }
+        bool operator==(const Key& other) const {
+            return durationMs == other.durationMs && resultId == other.resultId;
+        }
+    };
+    using Partition = Utils::OrderStatisticTree<Key>;
+
+    int m_trialId = -1;
+    QHash<int, RankingEntry> m_entries;
+    Partition m_overall;
+    std::unordered_map<int, Partition> m_byCategory;
+    std::unordered_map<int, Partition> m_byModality;
+
+    static Key keyOf(const RankingEntry& entry) { return { entry.result.durationMs, entry.result.id }; }
+    [[nodiscard]] int positionIn(const Partition* partition, int resultId) const;
+    [[nodiscard]] QVector<RankingEntry> collect(const Partition* partition, int limit) const;
+};
+
+};
+
+#endif // RANKINGINDEX_H
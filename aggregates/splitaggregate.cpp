@@ -0,0 +1,206 @@
+#include "splitaggregate.h"
+#include "utils/timeutils.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <cmath>
+
+namespace {
+
+// Shared tail of the ranking queries: `firsts(registrationId, elapsedMs)` ranked with names
+const QString rankedSelect = R"(
+    SELECT
+        ROW_NUMBER() OVER (ORDER BY f.elapsedMs, f.registrationId) as position,
+        f.elapsedMs - MIN(f.elapsedMs) OVER () as gapMs,
+        a.id, a.name,
+        c.id, c.name,
+        m.id, m.name,
+        reg.id, reg.plateCode,
+        f.elapsedMs
+    FROM firsts f
+    JOIN registrations reg ON reg.id = f.registrationId
+    JOIN athletes a ON reg.athleteId = a.id
+    JOIN categories c ON reg.categoryId = c.id
+    JOIN modalities m ON reg.modalityId = m.id
+    WHERE (:anyCategory OR reg.categoryId = :categoryId)
+    ORDER BY f.elapsedMs, f.registrationId
+    LIMIT :limit
+)";
+
+QVector<Aggregates::SplitEntry> readRanking(QSqlQuery& query) {
+    QVector<Aggregates::SplitEntry> ranking;
+    while (query.next()) {
+        const int elapsedMs = query.value(10).toInt();
+        ranking.append({
+            .position = query.value(0).toInt(),
+            .athlete = { .id = query.value(2).toInt(), .name = query.value(3).toString() },
+            .category = Categories::CategoryRef::of(query.value(4).toInt(), [&query]() { return query.value(5).toString(); }),
+            .modality = Modalities::ModalityRef::of(query.value(6).toInt(), [&query]() { return query.value(7).toString(); }),
+            .registrationId = query.value(8).toInt(),
+            .plateCode = query.value(9).toString(),
+            .elapsedMs = elapsedMs,
+            .gapMs = query.value(1).toInt(),
+            .formattedTime = Utils::TimeFormatter::formatTime(elapsedMs)
+        });
+    }
+    return ranking;
+}
+
+};
+
+Aggregates::SplitAggregate::SplitAggregate(const QSqlDatabase& db) : m_db(db) {
+}
+
+tl::expected<QVector<Aggregates::SplitEntry>, QString> Aggregates::SplitAggregate::getSplitRanking(const int checkpointId, const int limit) const {
+    return splitRanking(checkpointId, 0, limit);
+}
+
+tl::expected<QVector<Aggregates::SplitEntry>, QString> Aggregates::SplitAggregate::getSplitRankingByCategory(
+    const int checkpointId, const int categoryId, const int limit) const {
+    return splitRanking(checkpointId, categoryId, limit);
+}
+
+tl::expected<QVector<Aggregates::SplitEntry>, QString> Aggregates::SplitAggregate::splitRanking(
+    const int checkpointId, const int categoryId, const int limit) const {
+
+    // The grouping reads one primary key range of the crossings table
+    QSqlQuery query(m_db);
+    query.prepare(R"(
+        WITH firsts AS (
+            SELECT registrationId, MIN(elapsedMs) as elapsedMs
+            FROM crossings
+            WHERE checkpointId = :checkpointId
+            GROUP BY registrationId
+        )
+    )" + rankedSelect);
+    query.bindValue(":checkpointId", checkpointId);
+    query.bindValue(":anyCategory", categoryId == 0);
+    query.bindValue(":categoryId", categoryId);
+    query.bindValue(":limit", limit);
+
+    if (!query.exec()) {
+        return tl::unexpected("[SA] Error getting split ranking: " + query.lastError().text());
+    }
+    return readRanking(query);
+}
+
+tl::expected<QVector<Aggregates::SplitEntry>, QString> Aggregates::SplitAggregate::getSegmentRanking(
+    const int fromCheckpointId, const int toCheckpointId, const int limit) const {
+
+    QSqlQuery query(m_db);
+    query.prepare(R"(
+        WITH
+            fromFirsts AS (
+                SELECT registrationId, MIN(elapsedMs) as elapsedMs
+                FROM crossings
+                WHERE checkpointId = :fromCheckpointId
+                GROUP BY registrationId
+            ),
+            toFirsts AS (
+                SELECT registrationId, MIN(elapsedMs) as elapsedMs
+                FROM crossings
+                WHERE checkpointId = :toCheckpointId
+                GROUP BY registrationId
+            ),
+            firsts AS (
+                SELECT t.registrationId, t.elapsedMs - f.elapsedMs as elapsedMs
+                FROM toFirsts t
+                JOIN fromFirsts f ON f.registrationId = t.registrationId
+                WHERE t.elapsedMs > f.elapsedMs
+            )
+    )" + rankedSelect);
+    query.bindValue(":fromCheckpointId", fromCheckpointId);
+    query.bindValue(":toCheckpointId", toCheckpointId);
+    query.bindValue(":anyCategory", true);
+    query.bindValue(":categoryId", 0);
+    query.bindValue(":limit", limit);
+
+    if (!query.exec()) {
+        return tl::unexpected("[SA] Error getting segment ranking: " + query.lastError().text());
+    }
+    return readRanking(query);
+}
+
+tl::expected<QVector<Aggregates::SplitPace>, QString> Aggregates::SplitAggregate::getAthleteSplits(const int registrationId) const {
+    // The position at each checkpoint counts the athletes whose first crossing came earlier;
+    // it is a range count on the (checkpointId, elapsedMs) primary key.
+    QSqlQuery query(m_db);
+    query.prepare(R"(
+        WITH firsts AS (
+            SELECT checkpointId, MIN(elapsedMs) as elapsedMs
+            FROM crossings
+            WHERE registrationId = :registrationId
+            GROUP BY checkpointId
+        )
+        SELECT
+            cp.id, cp.trialId, cp.code, cp.name, cp.sequence, cp.distanceM,
+            f.elapsedMs,
+            (
+                SELECT COUNT(DISTINCT x.registrationId)
+                FROM crossings x
+                WHERE x.checkpointId = cp.id AND x.elapsedMs < f.elapsedMs
+            ) + 1 as position
+        FROM firsts f
+        JOIN checkpoints cp ON cp.id = f.checkpointId
+        ORDER BY cp.sequence, cp.id
+    )");
+    query.bindValue(":registrationId", registrationId);
+
+    if (!query.exec()) {
+        return tl::unexpected("[SA] Error getting athlete splits: " + query.lastError().text());
+    }
+
+    QVector<SplitPace> splits;
+    int previousElapsedMs = 0;
+    int previousDistanceM = 0;      // the start is at 0 m
+    bool previousDistanceKnown = true;
+    // Pace reaches back to the last checkpoint with a known distance, so a checkpoint without
+    // one never pairs the time of one segment with the distance of several
+    int knownElapsedMs = 0;
+    int knownDistanceM = 0;
+
+    while (query.next()) {
+        const Checkpoints::Checkpoint checkpoint {
+            .id = query.value(0).toInt(),
+            .trialId = query.value(1).toInt(),
+            .code = query.value(2).toString(),
+            .name = query.value(3).toString(),
+            .sequence = query.value(4).toInt(),
+            .distanceM = query.value(5).toInt()
+        };
+        const int elapsedMs = query.value(6).toInt();
+        const bool distanceKnown = checkpoint.distanceM > 0;
+        const int segmentMs = elapsedMs - previousElapsedMs;
+        const int segmentDistanceM = distanceKnown && previousDistanceKnown && checkpoint.distanceM > previousDistanceM
+                                         ? checkpoint.distanceM - previousDistanceM : 0;
+        const int paceDistanceM = distanceKnown && checkpoint.distanceM > knownDistanceM ? checkpoint.distanceM - knownDistanceM : 0;
+        const double pace = paceDistanceM > 0 ? ((elapsedMs - knownElapsedMs) / 1000.0) / (paceDistanceM / 1000.0) : 0.0;
+
+        splits.append({
+            .checkpoint = checkpoint,
+            .elapsedMs = elapsedMs,
+            .segmentMs = segmentMs,
+            .segmentDistanceM = segmentDistanceM,
+            .paceSecondsPerKm = pace,
+            .position = query.value(7).toInt(),
+            .formattedTime = Utils::TimeFormatter::formatTime(elapsedMs),
+            .formattedPace = formatPace(pace)
+        });
+
+        previousElapsedMs = elapsedMs;
+        previousDistanceM = checkpoint.distanceM;
+        previousDistanceKnown = distanceKnown;
+        if (distanceKnown) {
+            knownElapsedMs = elapsedMs;
+            knownDistanceM = checkpoint.distanceM;
+        }
+    }
+    return splits;
+}
+
+QString Aggregates::SplitAggregate::formatPace(const double secondsPerKm) {
+    if (secondsPerKm <= 0.0) {
+        return {};
+    }
+    const int totalSeconds = static_cast<int>(std::lround(secondsPerKm));
+    return QString("%1:%2 /km").arg(totalSeconds / 60).arg(totalSeconds % 60, 2, 10, QChar('0'));
+}
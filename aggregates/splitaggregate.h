@@ -0,0 +1,62 @@
+#ifndef SPLITAGGREGATE_H
+#define SPLITAGGREGATE_H
+
+#include "athlete.h"
+#include "category.h"
+#include "modality.h"
+#include "checkpoint.h"
+#include <QSqlDatabase>
+#include <QString>
+#include <QVector>
+#include <tl/expected.hpp>
+
+namespace Aggregates {
+
+// Position at a checkpoint (or over a segment); only the first crossing of each athlete counts
+struct SplitEntry {
+    int position;
+    Athletes::Athlete athlete;
+    Categories::CategoryRef category;
+    Modalities::ModalityRef modality;
+    int registrationId;
+    QString plateCode;
+    int elapsedMs;          // since the start, or over the segment
+    int gapMs;              // behind the first of the ranking
+    QString formattedTime;
+};
+
+// One checkpoint of an athlete's race
+struct SplitPace {
+    Checkpoints::Checkpoint checkpoint;
+    int elapsedMs;
+    int segmentMs;          // since the previous checkpoint (or the start)
+    int segmentDistanceM;   // 0 unless both ends of the segment have a known distance
+    double paceSecondsPerKm;    // since the last checkpoint (or the start) with a known distance; 0 without one here
+    int position;           // overall, at this checkpoint
+    QString formattedTime;
+    QString formattedPace;  // "m:ss /km", empty without distances
+};
+
+class SplitAggregate
+{
+public:
+    explicit SplitAggregate(const QSqlDatabase& db);
+
+    [[nodiscard]] tl::expected<QVector<SplitEntry>, QString> getSplitRanking(int checkpointId, int limit = -1) const;
+    [[nodiscard]] tl::expected<QVector<SplitEntry>, QString> getSplitRankingByCategory(int checkpointId, int categoryId, int limit = -1) const;
+    // Fastest athletes between two checkpoints
+    [[nodiscard]] tl::expected<QVector<SplitEntry>, QString> getSegmentRanking(int fromCheckpointId, int toCheckpointId, int limit = -1) const;
+    // Checkpoints crossed by the registration, in course order, with segment times and pace
+    [[nodiscard]] tl::expected<QVector<SplitPace>, QString> getAthleteSplits(int registrationId) const;
+
+    [[nodiscard]] static QString formatPace(double secondsPerKm);
+
+private:
+    QSqlDatabase m_db;
+
+    [[nodiscard]] tl::expected<QVector<SplitEntry>, QString> splitRanking(int checkpointId, int categoryId, int limit) const;
+};
+
+};
+
+#endif // SPLITAGGREGATE_H
@@ -1,10 +1,14 @@
 #include "trialaggregate.h"
+#include "rankingindex.h"
+#include "trialsnapshot.h"
 #include "utils/timeutils.h"
 #include <QTime>
 #include <algorithm>
+#include <numeric>
 #include <QSqlQuery>
 #include <QSqlError>
 #include <utility>
+#include <QDebug>
 
 Aggregates::TrialAggregate::TrialAggregate(
     const QSqlDatabase& db,
@@ -24,7 +28,60 @@ Aggregates::TrialAggregate::TrialAggregate(
 {
 }
 
+void Aggregates::TrialAggregate::setRankingIndex(std::shared_ptr<RankingIndex> rankingIndex) {
+    m_rankingIndex = std::move(rankingIndex);
+}
+
+const Aggregates::RankingIndex* Aggregates::TrialAggregate::rankingIndexFor(const int trialId) const {
+    return m_rankingIndex && m_rankingIndex->trialId() == trialId ? m_rankingIndex.get() : nullptr;
+}
+
+void Aggregates::TrialAggregate::setSnapshot(std::shared_ptr<TrialSnapshot> snapshot) {
+    m_snapshot = std::move(snapshot);
+}
+
+const Aggregates::TrialSnapshot* Aggregates::TrialAggregate::snapshotFor(const int trialId) const {
+    return m_snapshot && m_snapshot->trialId == trialId ? m_snapshot.get() : nullptr;
+}
+
+QVector<Aggregates::RankingEntry> Aggregates::TrialAggregate::rankingFromSnapshot(const TrialSnapshot& snapshot, const int categoryId, const int modalityId) {
+    const QVector<int> ranked = snapshot.rankedResults(categoryId, modalityId);
+
+    QVector<RankingEntry> ranking;
+    ranking.reserve(ranked.size());
+    for (const int index : ranked) {
+        ranking.append(snapshot.rankingEntry(index, static_cast<int>(ranking.size()) + 1));
+    }
+    return ranking;
+}
+
 tl::expected<Aggregates::TrialSummary, QString> Aggregates::TrialAggregate::getTrialSummary(int trialId) {
+    if (const TrialSnapshot* snapshot = snapshotFor(trialId)) {
+        auto trial = m_trialsRepo->getTrialById(trialId);
+        if (!trial) {
+            return tl::unexpected("[TA] Error getting trial summary: " + trial.error());
+        }
+
+        auto registrations = getTrialRegistrations(trialId);
+        if (!registrations) {
+            return tl::unexpected("Error getting registrations: " + registrations.error());
+        }
+
+        // Counts and the fastest finish are plain scans of the snapshot columns
+        const int finished = snapshot->finishedCount();
+        const int fastest = snapshot->fastestResult();
+
+        return TrialSummary{
+            .trial = trial.value(),
+            .registrations = registrations.value(),
+            .totalRegistrations = static_cast<int>(snapshot->size()),
+            .finishedCount = finished,
+            .pendingCount = static_cast<int>(snapshot->size()) - finished,
+            .fastestTime = fastest >= 0 ? snapshot->result(fastest).endTime : QDateTime(),
+            .fastestAthlete = fastest >= 0 ? snapshot->athleteNames[snapshot->resultRows[fastest]] : QString()
+        };
+    }
+
     QSqlQuery query(m_db);
     
     // A single query to fetch trial + statistics
@@ -67,9 +124,9 @@ tl::expected<Aggregates::TrialSummary, QString> Aggregates::TrialAggregate::getT
     const Trials::TrialInfo trial {
         .id = query.value(0).toInt(),
         .name = query.value(1).toString(),
-        .scheduledDateTime = QDateTime::fromString(query.value(2).toString(), Qt::ISODate),
-        .startDateTime = QDateTime::fromString(query.value(3).toString(), Qt::ISODate),
-        .endDateTime = QDateTime::fromString(query.value(4).toString(), Qt::ISODate)
+        .scheduledDateTime = Utils::DateTimeUtils::fromEpochMsOrDefault(query.value(2)),
+        .startDateTime = Utils::DateTimeUtils::fromEpochMsOrDefault(query.value(3)),
+        .endDateTime = Utils::DateTimeUtils::fromEpochMsOrDefault(query.value(4))
     };
 
     return TrialSummary{
@@ -78,12 +135,59 @@ tl::expected<Aggregates::TrialSummary, QString> Aggregates::TrialAggregate::getT
         .totalRegistrations = query.value(5).toInt(),
         .finishedCount = query.value(6).toInt(),
         .pendingCount = query.value(7).toInt(),
-        .fastestTime = QDateTime::fromString(query.value(9).toString(), Qt::ISODate),
-        .fastestAthlete = query.value(8).toString()
+        .fastestTime = Utils::DateTimeUtils::fromEpochMs(query.value(10)),
+        .fastestAthlete = query.value(9).toString()
     };
 }
 
 tl::expected<QVector<Aggregates::RegistrationDetail>, QString> Aggregates::TrialAggregate::getTrialRegistrations(int trialId) const {
+    if (const TrialSnapshot* snapshot = snapshotFor(trialId)) {
+        // Same rows as the query below: one per result, or one without a result, ordered by plate
+        QVector<int> rows;
+        rows.reserve(snapshot->size());
+        for (int row = 0; row < snapshot->size(); ++row) {
+            if (snapshot->isRanked(row)) {
+                rows.append(row);
+            }
+        }
+        std::ranges::sort(rows, [snapshot](const int a, const int b) { return snapshot->plateCodes[a] < snapshot->plateCodes[b]; });
+
+        QVector<int> resultsByRow(snapshot->resultCount());
+        std::iota(resultsByRow.begin(), resultsByRow.end(), 0);
+        std::ranges::stable_sort(resultsByRow, {}, [snapshot](const int index) { return snapshot->resultRows[index]; });
+
+        QVector<RegistrationDetail> details;
+        details.reserve(rows.size() + snapshot->resultCount());
+
+        for (const int row : rows) {
+            const RegistrationDetail detail {
+                .registration = {
+                    .id = snapshot->registrationIds[row],
+                    .trialId = trialId,
+                    .athleteId = snapshot->athleteIds[row],
+                    .plateCode = snapshot->plateCodes[row],
+                    .modalityId = snapshot->modalityIds[row],
+                    .categoryId = snapshot->categoryIds[row]
+                },
+                .athlete = { .id = snapshot->athleteIds[row], .name = snapshot->athleteNames[row] },
+                .category = { .id = snapshot->categoryIds[row] },
+                .modality = { .id = snapshot->modalityIds[row] },
+                .result = std::nullopt
+            };
+
+            auto first = std::ranges::lower_bound(resultsByRow, row, {}, [snapshot](const int index) { return snapshot->resultRows[index]; });
+            if (first == resultsByRow.end() || snapshot->resultRows[*first] != row) {
+                details.append(detail);
+                continue;
+            }
+            for (auto it = first; it != resultsByRow.end() && snapshot->resultRows[*it] == row; ++it) {
+                details.append(detail);
+                details.last().result = snapshot->result(*it);
+            }
+        }
+        return details;
+    }
+
     QSqlQuery query(m_db);
     
     // A single query with JOINs to fetch all data
@@ -127,23 +231,17 @@ tl::expected<QVector<Aggregates::RegistrationDetail>, QString> Aggregates::Trial
             .name = query.value(6).toString()
         };
 
-        const Categories::Category category {
-            .id = registration.categoryId,
-            .name = query.value(7).toString()
-        };
-
-        const Modalities::Modality modality {
-            .id = registration.modalityId,
-            .name = query.value(8).toString()
-        };
+        // Names are read from the row only the first time their id is seen
+        const auto category = Categories::CategoryRef::of(registration.categoryId, [&query]() { return query.value(7).toString(); });
+        const auto modality = Modalities::ModalityRef::of(registration.modalityId, [&query]() { return query.value(8).toString(); });
 
         std::optional<Results::Result> result;
         if (!query.value(9).isNull()) {
             result = Results::Result {
                 .id = query.value(9).toInt(),
                 .registrationId = registration.id,
-                .startTime = QDateTime::fromString(query.value(10).toString(), Qt::ISODate),
-                .endTime = QDateTime::fromString(query.value(11).toString(), Qt::ISODate),
+                .startTime = Utils::DateTimeUtils::fromEpochMs(query.value(10)),
+                .endTime = Utils::DateTimeUtils::fromEpochMs(query.value(11)),
                 .durationMs = query.value(12).toInt(),
                 .notes = query.value(13).toString()
             };
@@ -162,6 +260,13 @@ tl::expected<QVector<Aggregates::RegistrationDetail>, QString> Aggregates::Trial
 }
 
 tl::expected<QVector<Aggregates::RankingEntry>, QString> Aggregates::TrialAggregate::getTrialRanking(const int trialId) const {
+    if (const RankingIndex* index = rankingIndexFor(trialId)) {
+        return index->top();
+    }
+    if (const TrialSnapshot* snapshot = snapshotFor(trialId)) {
+        return rankingFromSnapshot(*snapshot, 0, 0);
+    }
+
     QSqlQuery query(m_db);
     
     // Simplified query with ROW_NUMBER for automatic positioning
@@ -197,21 +302,14 @@ tl::expected<QVector<Aggregates::RankingEntry>, QString> Aggregates::TrialAggreg
             .name = query.value(2).toString()
         };
 
-        const Categories::Category category {
-            .id = query.value(3).toInt(),
-            .name = query.value(4).toString()
-        };
-
-        const Modalities::Modality modality {
-            .id = query.value(5).toInt(),
-            .name = query.value(6).toString()
-        };
+        const auto category = Categories::CategoryRef::of(query.value(3).toInt(), [&query]() { return query.value(4).toString(); });
+        const auto modality = Modalities::ModalityRef::of(query.value(5).toInt(), [&query]() { return query.value(6).toString(); });
 
         const Results::Result result {
             .id = query.value(8).toInt(),
             .registrationId = query.value(9).toInt(),
-            .startTime = QDateTime::fromString(query.value(10).toString(), Qt::ISODate),
-            .endTime = QDateTime::fromString(query.value(11).toString(), Qt::ISODate),
+            .startTime = Utils::DateTimeUtils::fromEpochMs(query.value(10)),
+            .endTime = Utils::DateTimeUtils::fromEpochMs(query.value(11)),
             .durationMs = query.value(12).toInt(),
             .notes = query.value(13).toString()
         };
@@ -231,6 +329,13 @@ tl::expected<QVector<Aggregates::RankingEntry>, QString> Aggregates::TrialAggreg
 }
 
 tl::expected<QVector<Aggregates::RankingEntry>, QString> Aggregates::TrialAggregate::getRankingByCategory(const int trialId, const int categoryId) const {
+    if (const RankingIndex* index = rankingIndexFor(trialId)) {
+        return index->topByCategory(categoryId);
+    }
+    if (const TrialSnapshot* snapshot = snapshotFor(trialId)) {
+        return rankingFromSnapshot(*snapshot, categoryId, 0);
+    }
+
     QSqlQuery query(m_db);
     
     // Simplified query filtering by category
@@ -263,12 +368,12 @@ tl::expected<QVector<Aggregates::RankingEntry>, QString> Aggregates::TrialAggreg
     
     while (query.next()) {
         const Athletes::Athlete athlete { .id = query.value(1).toInt(), .name = query.value(2).toString() };
-        const Categories::Category category { .id = query.value(3).toInt(), .name = query.value(4).toString() };
-        const Modalities::Modality modality { .id = query.value(5).toInt(), .name = query.value(6).toString() };
+        const auto category = Categories::CategoryRef::of(query.value(3).toInt(), [&query]() { return query.value(4).toString(); });
+        const auto modality = Modalities::ModalityRef::of(query.value(5).toInt(), [&query]() { return query.value(6).toString(); });
         const Results::Result result {
             .id = query.value(8).toInt(), .registrationId = query.value(9).toInt(),
-            .startTime = QDateTime::fromString(query.value(10).toString(), Qt::ISODate),
-            .endTime = QDateTime::fromString(query.value(11).toString(), Qt::ISODate),
+            .startTime = Utils::DateTimeUtils::fromEpochMs(query.value(10)),
+            .endTime = Utils::DateTimeUtils::fromEpochMs(query.value(11)),
             .durationMs = query.value(12).toInt(), .notes = query.value(13).toString()
         };
 
@@ -281,6 +386,13 @@ tl::expected<QVector<Aggregates::RankingEntry>, QString> Aggregates::TrialAggreg
 }
 
 tl::expected<QVector<Aggregates::RankingEntry>, QString> Aggregates::TrialAggregate::getRankingByModality(const int trialId, const int modalityId) const {
+    if (const RankingIndex* index = rankingIndexFor(trialId)) {
+        return index->topByModality(modalityId);
+    }
+    if (const TrialSnapshot* snapshot = snapshotFor(trialId)) {
+        return rankingFromSnapshot(*snapshot, 0, modalityId);
+    }
+
     QSqlQuery query(m_db);
     
     // Simplified query filtering by modality
@@ -313,12 +425,12 @@ tl::expected<QVector<Aggregates::RankingEntry>, QString> Aggregates::TrialAggreg
     
     while (query.next()) {
         const Athletes::Athlete athlete { .id = query.value(1).toInt(), .name = query.value(2).toString() };
-        const Categories::Category category { .id = query.value(3).toInt(), .name = query.value(4).toString() };
-        const Modalities::Modality modality { .id = query.value(5).toInt(), .name = query.value(6).toString() };
+        const auto category = Categories::CategoryRef::of(query.value(3).toInt(), [&query]() { return query.value(4).toString(); });
+        const auto modality = Modalities::ModalityRef::of(query.value(5).toInt(), [&query]() { return query.value(6).toString(); });
         const Results::Result result {
             .id = query.value(8).toInt(), .registrationId = query.value(9).toInt(),
-            .startTime = QDateTime::fromString(query.value(10).toString(), Qt::ISODate),
-            .endTime = QDateTime::fromString(query.value(11).toString(), Qt::ISODate),
+            .startTime = Utils::DateTimeUtils::fromEpochMs(query.value(10)),
+            .endTime = Utils::DateTimeUtils::fromEpochMs(query.value(11)),
             .durationMs = query.value(12).toInt(), .notes = query.value(13).toString()
         };
 
@@ -330,6 +442,42 @@ tl::expected<QVector<Aggregates::RankingEntry>, QString> Aggregates::TrialAggreg
     return ranking;
 }
 
+tl::expected<Utils::DurationStatistics, QString> Aggregates::TrialAggregate::getDurationStatistics(
+    const int trialId, const int categoryId, const int modalityId) const {
+    if (const TrialSnapshot* snapshot = snapshotFor(trialId)) {
+        return Utils::DurationStats::compute(snapshot->rankedDurations(categoryId, modalityId));
+    }
+
+    // Only the duration column is read; the joins keep the population equal to the rankings
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare(R"(
+        SELECT r.durationMs
+        FROM results r
+        JOIN registrations reg ON r.registrationId = reg.id
+        JOIN categories c ON reg.categoryId = c.id
+        JOIN modalities m ON reg.modalityId = m.id
+        WHERE reg.trialId = :trialId
+          AND (:anyCategory OR reg.categoryId = :categoryId)
+          AND (:anyModality OR reg.modalityId = :modalityId)
+    )");
+    query.bindValue(":trialId", trialId);
+    query.bindValue(":anyCategory", categoryId == 0);
+    query.bindValue(":categoryId", categoryId);
+    query.bindValue(":anyModality", modalityId == 0);
+    query.bindValue(":modalityId", modalityId);
+
+    if (!query.exec()) {
+        return tl::unexpected("[TA] Error getting duration statistics: " + query.lastError().text());
+    }
+
+    QVector<int> durations;
+    while (query.next()) {
+        durations.append(query.value(0).toInt());
+    }
+    return Utils::DurationStats::compute(durations);
+}
+
 tl::expected<Aggregates::RegistrationDetail, QString> Aggregates::TrialAggregate::registerAthleteForTrial(
     int trialId,
     const QString& athleteName,
@@ -386,8 +534,8 @@ tl::expected<Aggregates::RegistrationDetail, QString> Aggregates::TrialAggregate
     return RegistrationDetail{
         .registration = registrationResult.value(),
         .athlete = athleteResult.value(),
-        .category = categoryResult.value(),
-        .modality = modalityResult.value(),
+        .category = Categories::CategoryRef::of(categoryResult.value()),
+        .modality = Modalities::ModalityRef::of(modalityResult.value()),
         .result = std::nullopt
     };
 }
@@ -395,8 +543,9 @@ tl::expected<Aggregates::RegistrationDetail, QString> Aggregates::TrialAggregate
 tl::expected<Results::Result, QString> Aggregates::TrialAggregate::recordResult(
     const int trialId,
     const QString& plateCode,
-    const QDateTime& startTime,
+    const QDateTime& athleteStart,
     const QDateTime& endTime,
+    const QString& athleteName,
     const QString& notes) const {
 
     // Fetch registration by plate code
@@ -406,7 +555,7 @@ tl::expected<Results::Result, QString> Aggregates::TrialAggregate::recordResult(
     }
 
     // Calculate duration
-    int durationMs = calculateDuration(startTime, endTime);
+    int durationMs = calculateDuration(athleteStart, endTime);
     if (durationMs <= 0) {
         return tl::unexpected("Invalid time duration");
     }
@@ -414,7 +563,7 @@ tl::expected<Results::Result, QString> Aggregates::TrialAggregate::recordResult(
     // Create result
     auto resultResult = m_resultsRepo->createResult(
         registrationResult->id,
-        startTime,
+        athleteStart,
         endTime,
         durationMs,
         notes
@@ -424,9 +573,47 @@ tl::expected<Results::Result, QString> Aggregates::TrialAggregate::recordResult(
         return tl::unexpected("Error creating result: " + resultResult.error());
     }
 
+    if (rankingIndexFor(trialId)) {
+        addToRankingIndex(registrationResult.value(), athleteName, resultResult.value());
+    }
+    if (m_snapshot && m_snapshot->trialId == trialId && m_snapshot->applyResults({ resultResult.value() }) > 0) {
+        // Registered after the snapshot was taken
+        if (auto reloaded = TrialSnapshot::load(m_db, trialId, true); reloaded.has_value()) {
+            *m_snapshot = std::move(reloaded.value());
+        } else {
+            qWarning() << "[TA] Error reloading the trial snapshot:" << reloaded.error();
+        }
+    }
+
     return resultResult.value();
 }
 
+void Aggregates::TrialAggregate::addToRankingIndex(const Registrations::Registration& registration, const QString& athleteName, const Results::Result& result) const {
+    if (registration.categoryId <= 0 || registration.modalityId <= 0) {
+        // Keep the index consistent with the SQL ranking, which only lists fully joined results
+        qWarning() << "[TA] Result" << result.id << "not added to the ranking index: registration"
+                   << registration.id << "has no category/modality";
+        return;
+    }
+
+    // Names come from the pools; the repositories are only asked for an id never seen before
+    m_rankingIndex->insert({
+        .position = 0,
+        .athlete = { .id = registration.athleteId, .name = athleteName },
+        .category = Categories::CategoryRef::of(registration.categoryId, [this, &registration]() {
+            const auto category = m_categoriesRepo->getCategoryById(registration.categoryId);
+            return category ? category->name : QString();
+        }),
+        .modality = Modalities::ModalityRef::of(registration.modalityId, [this, &registration]() {
+            const auto modality = m_modalitiesRepo->getModalityById(registration.modalityId);
+            return modality ? modality->name : QString();
+        }),
+        .plateCode = registration.plateCode,
+        .result = result,
+        .formattedTime = Utils::TimeFormatter::formatTime(result.durationMs)
+    });
+}
+
 
 int Aggregates::TrialAggregate::calculateDuration(const QDateTime& start, const QDateTime& end) {
     if (!start.isValid() || !end.isValid() || start >= end) {
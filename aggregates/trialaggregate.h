@@ -13,6 +13,7 @@
 #include "repository/trials/trialsrepository.h"
 #include "repository/registrations/registrationsrepository.h"
 #include "repository/results/resultsrepository.h"
+#include "utils/durationstats.h"
 #include <QString>
 #include <QVector>
 #include <QDateTime>
@@ -23,11 +24,14 @@
 
 namespace Aggregates {
 
+class RankingIndex;
+struct TrialSnapshot;
+
 struct RegistrationDetail {
     Registrations::Registration registration;
     Athletes::Athlete athlete;
-    Categories::Category category;
-    Modalities::Modality modality;
+    Categories::CategoryRef category;
+    Modalities::ModalityRef modality;
     std::optional<Results::Result> result;
 };
 
@@ -44,8 +48,8 @@ struct TrialSummary {
 struct RankingEntry {
     int position;
     Athletes::Athlete athlete;
-    Categories::Category category;  
-    Modalities::Modality modality;
+    Categories::CategoryRef category;
+    Modalities::ModalityRef modality;
     QString plateCode;
     Results::Result result;
     QString formattedTime;
@@ -62,11 +66,19 @@ public:
                    std::shared_ptr<Registrations::Repository> registrationsRepo,
                    std::shared_ptr<Results::Repository> resultsRepo);
 
+    // Rankings of the index's trial are then served from memory and recordResult keeps the index current
+    void setRankingIndex(std::shared_ptr<RankingIndex> rankingIndex);
+    // Summary, registrations and rankings of the snapshot's trial are then computed from its columns
+    // (it must be loaded with results); recordResult appends to it
+    void setSnapshot(std::shared_ptr<TrialSnapshot> snapshot);
+
     tl::expected<TrialSummary, QString> getTrialSummary(int trialId);
     [[nodiscard]] tl::expected<QVector<RegistrationDetail>, QString> getTrialRegistrations(int trialId) const;
     [[nodiscard]] tl::expected<QVector<RankingEntry>, QString> getTrialRanking(int trialId) const;
     [[nodiscard]] tl::expected<QVector<RankingEntry>, QString> getRankingByCategory(int trialId, int categoryId) const;
     [[nodiscard]] tl::expected<QVector<RankingEntry>, QString> getRankingByModality(int trialId, int modalityId) const;
+    // Over the ranked results of the trial; 0 matches any category / modality
+    [[nodiscard]] tl::expected<Utils::DurationStatistics, QString> getDurationStatistics(int trialId, int categoryId = 0, int modalityId = 0) const;
     
     [[nodiscard]] tl::expected<RegistrationDetail, QString> registerAthleteForTrial(
         int trialId,
@@ -76,11 +88,15 @@ public:
         const QString& modalityName
     ) const;
     
+    // athleteStart is the athlete's own start: the trial start plus their wave or individual offset,
+    // which the caller already holds (Registrations::PlateIndex entry) along with the athlete name,
+    // so ranking is on net time and the ranking index is updated without further lookups
     [[nodiscard]] tl::expected<Results::Result, QString> recordResult(
         int trialId,
         const QString& plateCode,
-        const QDateTime& startTime,
+        const QDateTime& athleteStart,
         const QDateTime& endTime,
+        const QString& athleteName,
         const QString& notes = ""
     ) const;
 
@@ -92,6 +108,13 @@ private:
     std::shared_ptr<Trials::Repository> m_trialsRepo;
     std::shared_ptr<Registrations::Repository> m_registrationsRepo;
     std::shared_ptr<Results::Repository> m_resultsRepo;
+    std::shared_ptr<RankingIndex> m_rankingIndex;
+    std::shared_ptr<TrialSnapshot> m_snapshot;
+
+    [[nodiscard]] const RankingIndex* rankingIndexFor(int trialId) const;
+    [[nodiscard]] const TrialSnapshot* snapshotFor(int trialId) const;
+    [[nodiscard]] static QVector<RankingEntry> rankingFromSnapshot(const TrialSnapshot& snapshot, int categoryId, int modalityId);
+    void addToRankingIndex(const Registrations::Registration& registration, const QString& athleteName, const Results::Result& result) const;
 
     static int calculateDuration(const QDateTime& start, const QDateTime& end);
 };
@@ -0,0 +1,301 @@
+#include "trialsnapshot.h"
+#include "utils/timeutils.h"
+#include "utils/interning.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+#include <algorithm>
+#include <numeric>
+
+tl::expected<Aggregates::TrialSnapshot, QString> Aggregates::TrialSnapshot::load(const QSqlDatabase& db, const int trialId, const bool withResults) {
+    const QString sql = R"(
+        SELECT
+            reg.id, reg.athleteId, reg.categoryId, reg.modalityId, reg.plateCode,
+            a.name as athlete_name,
+            c.name as category_name,
+            m.name as modality_name
+        FROM registrations reg
+        JOIN athletes a ON reg.athleteId = a.id
+        LEFT JOIN categories c ON reg.categoryId = c.id
+        LEFT JOIN modalities m ON reg.modalityId = m.id
+        WHERE reg.trialId = :trialId
+    )";
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    query.bindValue(":trialId", trialId);
+
+    if (!query.exec()) {
+        return tl::unexpected("[TS] Error loading snapshot of trial " + QString::number(trialId) + ": " + query.lastError().text());
+    }
+
+    TrialSnapshot loaded;
+    loaded.trialId = trialId;
+
+    while (query.next()) {
+        const int categoryId = query.value(2).toInt();
+        const int modalityId = query.value(3).toInt();
+
+        loaded.registrationIds.append(query.value(0).toInt());
+        loaded.athleteIds.append(query.value(1).toInt());
+        loaded.categoryIds.append(categoryId);
+        loaded.modalityIds.append(modalityId);
+        loaded.plateCodes.append(query.value(4).toString());
+        loaded.athleteNames.append(query.value(5).toString());
+
+        // Names come from the shared pools and are only read from the row the first time an id shows up
+        if (!loaded.categoryNames.contains(categoryId) && !query.value(6).isNull()) {
+            loaded.categoryNames.insert(categoryId, Utils::NamePool::categories().resolve(categoryId, [&query]() { return query.value(6).toString(); }));
+        }
+        if (!loaded.modalityNames.contains(modalityId) && !query.value(7).isNull()) {
+            loaded.modalityNames.insert(modalityId, Utils::NamePool::modalities().resolve(modalityId, [&query]() { return query.value(7).toString(); }));
+        }
+        loaded.registrationsByCategory[categoryId]++;
+    }
+
+    // Sort keys are computed once per row instead of once per comparison
+    const qsizetype count = loaded.size();
+    QVector<qint64> plateNumbers(count);
+    QVector<bool> plateIsNumber(count);
+    QVector<QString> modalityKeys(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        modalityKeys[i] = loaded.modalityNames.value(loaded.modalityIds[i]);
+        bool ok = false;
+        plateNumbers[i] = loaded.plateCodes[i].toLongLong(&ok);
+        plateIsNumber[i] = ok;
+    }
+
+    QVector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](const int a, const int b) {
+        if (modalityKeys[a] != modalityKeys[b]) {
+            return modalityKeys[a] < modalityKeys[b];
+        }
+        if (plateIsNumber[a] && plateIsNumber[b]) {
+            return plateNumbers[a] < plateNumbers[b];
+        }
+        return loaded.plateCodes[a] < loaded.plateCodes[b];
+    });
+
+    TrialSnapshot snapshot;
+    snapshot.trialId = trialId;
+    snapshot.categoryNames = std::move(loaded.categoryNames);
+    snapshot.modalityNames = std::move(loaded.modalityNames);
+    snapshot.registrationsByCategory = std::move(loaded.registrationsByCategory);
+    snapshot.registrationIds.reserve(count);
+    snapshot.athleteIds.reserve(count);
+    snapshot.categoryIds.reserve(count);
+    snapshot.modalityIds.reserve(count);
+    snapshot.plateCodes.reserve(count);
+    snapshot.athleteNames.reserve(count);
+    snapshot.m_rowByPlate.reserve(count);
+    snapshot.m_rowByRegistration.reserve(count);
+
+    for (const int source : order) {
+        const int row = static_cast<int>(snapshot.registrationIds.size());
+        snapshot.registrationIds.append(loaded.registrationIds[source]);
+        snapshot.athleteIds.append(loaded.athleteIds[source]);
+        snapshot.categoryIds.append(loaded.categoryIds[source]);
+        snapshot.modalityIds.append(loaded.modalityIds[source]);
+        snapshot.plateCodes.append(std::move(loaded.plateCodes[source]));
+        snapshot.athleteNames.append(std::move(loaded.athleteNames[source]));
+
+        snapshot.m_rowByPlate.insert(snapshot.plateCodes.last(), row);
+        snapshot.m_rowByRegistration.insert(snapshot.registrationIds.last(), row);
+    }
+
+    snapshot.bestResults.fill(-1, count);
+
+    if (withResults) {
+        if (auto results = snapshot.loadResults(db); !results) {
+            return tl::unexpected(results.error());
+        }
+    }
+
+    qDebug() << "[TS] Loaded snapshot of trial" << trialId << "with" << snapshot.size() << "registrations and"
+             << snapshot.resultCount() << "results";
+    return snapshot;
+}
+
+tl::expected<void, QString> Aggregates::TrialSnapshot::loadResults(const QSqlDatabase& db) {
+    // Names, plates and ids are already in the registration columns; only the result itself is read
+    const QString sql = R"(
+        SELECT r.id, r.registrationId, r.startTime, r.endTime, r.durationMs, r.notes, r.elapsedNs
+        FROM results r
+        JOIN registrations reg ON r.registrationId = reg.id
+        WHERE reg.trialId = :trialId
+    )";
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    query.bindValue(":trialId", trialId);
+
+    if (!query.exec()) {
+        return tl::unexpected("[TS] Error loading results of trial " + QString::number(trialId) + ": " + query.lastError().text());
+    }
+
+    QVector<Results::Result> results;
+    while (query.next()) {
+        results.append({
+            .id = query.value(0).toInt(),
+            .registrationId = query.value(1).toInt(),
+            .startTime = Utils::DateTimeUtils::fromEpochMs(query.value(2)),
+            .endTime = Utils::DateTimeUtils::fromEpochMs(query.value(3)),
+            .durationMs = query.value(4).toInt(),
+            .notes = query.value(5).toString(),
+            .elapsedNs = query.value(6).toLongLong()
+        });
+    }
+
+    // Results of registrations without an athlete are not part of the snapshot, as in the joins it replaces
+    applyResults(results);
+    return {};
+}
+
+int Aggregates::TrialSnapshot::applyResults(const QVector<Results::Result>& results) {
+    int unknown = 0;
+
+    resultIds.reserve(resultIds.size() + results.size());
+    resultRows.reserve(resultRows.size() + results.size());
+    durationsMs.reserve(durationsMs.size() + results.size());
+    startTimesMs.reserve(startTimesMs.size() + results.size());
+    endTimesMs.reserve(endTimesMs.size() + results.size());
+    elapsedNs.reserve(elapsedNs.size() + results.size());
+    resultNotes.reserve(resultNotes.size() + results.size());
+
+    const auto toMs = [](const QDateTime& dateTime) { return dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : noTime; };
+
+    for (const auto& result : results) {
+        const int row = rowOfRegistration(result.registrationId);
+        if (row < 0) {
+            ++unknown;
+            continue;
+        }
+
+        int index = indexOfResult(result.id);
+        bool slower = false;
+        if (index < 0) {
+            index = static_cast<int>(resultIds.size());
+            resultIds.append(result.id);
+            resultRows.append(row);
+            durationsMs.append(result.durationMs);
+            startTimesMs.append(toMs(result.startTime));
+            endTimesMs.append(toMs(result.endTime));
+            elapsedNs.append(result.elapsedNs);
+            resultNotes.append(result.notes);
+            m_indexByResult.insert(result.id, index);
+        } else {
+            slower = result.durationMs > durationsMs[index];
+            resultRows[index] = row;
+            durationsMs[index] = result.durationMs;
+            startTimesMs[index] = toMs(result.startTime);
+            endTimesMs[index] = toMs(result.endTime);
+            elapsedNs[index] = result.elapsedNs;
+            resultNotes[index] = result.notes;
+        }
+
+        if (slower && bestResults[row] == index) {
+            // A corrected best may no longer be the best; rescan the registration's results
+            for (qsizetype i = 0; i < resultIds.size(); ++i) {
+                if (resultRows[i] == row && isFaster(static_cast<int>(i), bestResults[row])) {
+                    bestResults[row] = static_cast<int>(i);
+                }
+            }
+        } else if (bestResults[row] < 0 || isFaster(index, bestResults[row])) {
+            bestResults[row] = index;
+        }
+    }
+
+    return unknown;
+}
+
+int Aggregates::TrialSnapshot::finishedCount() const {
+    return static_cast<int>(std::ranges::count_if(bestResults, [](const int best) { return best >= 0; }));
+}
+
+bool Aggregates::TrialSnapshot::isRanked(const int row) const {
+    return categoryNames.contains(categoryIds[row]) && modalityNames.contains(modalityIds[row]);
+}
+
+Results::Result Aggregates::TrialSnapshot::result(const int index) const {
+    const auto fromMs = [](const qint64 ms) { return ms == noTime ? QDateTime() : QDateTime::fromMSecsSinceEpoch(ms); };
+
+    return Results::Result {
+        .id = resultIds[index],
+        .registrationId = registrationIds[resultRows[index]],
+        .startTime = fromMs(startTimesMs[index]),
+        .endTime = fromMs(endTimesMs[index]),
+        .durationMs = durationsMs[index],
+        .notes = resultNotes[index],
+        .elapsedNs = elapsedNs[index]
+    };
+}
+
+Aggregates::RankingEntry Aggregates::TrialSnapshot::rankingEntry(const int index, const int position) const {
+    const int row = resultRows[index];
+    const int categoryId = categoryIds[row];
+    const int modalityId = modalityIds[row];
+
+    return RankingEntry {
+        .position = position,
+        .athlete = { .id = athleteIds[row], .name = athleteNames[row] },
+        .category = { .id = categoryId },
+        .modality = { .id = modalityId },
+        .plateCode = plateCodes[row],
+        .result = result(index),
+        .formattedTime = Utils::TimeFormatter::formatTime(durationsMs[index])
+    };
+}
+
+QVector<int> Aggregates::TrialSnapshot::rankedResults(const int categoryId, const int modalityId) const {
+    // Filter on the int columns first; only the survivors are sorted
+    QVector<int> ranked;
+    ranked.reserve(resultIds.size());
+    for (qsizetype i = 0; i < resultIds.size(); ++i) {
+        const int row = resultRows[i];
+        if ((categoryId == 0 || categoryIds[row] == categoryId) && (modalityId == 0 || modalityIds[row] == modalityId) && isRanked(row)) {
+            ranked.append(static_cast<int>(i));
+        }
+    }
+
+    std::sort(ranked.begin(), ranked.end(), [this](const int a, const int b) { return isFaster(a, b); });
+    return ranked;
+}
+
+QVector<int> Aggregates::TrialSnapshot::rankedDurations(const int categoryId, const int modalityId) const {
+    QVector<int> durations;
+    durations.reserve(resultIds.size());
+    for (qsizetype i = 0; i < resultIds.size(); ++i) {
+        const int row = resultRows[i];
+        if ((categoryId == 0 || categoryIds[row] == categoryId) && (modalityId == 0 || modalityIds[row] == modalityId) && isRanked(row)) {
+            durations.append(durationsMs[i]);
+        }
+    }
+    return durations;
+}
+
+int Aggregates::TrialSnapshot::fastestResult() const {
+    int fastest = -1;
+    for (qsizetype i = 0; i < resultIds.size(); ++i) {
+        if (isRanked(resultRows[i]) && (fastest < 0 || isFaster(static_cast<int>(i), fastest))) {
+            fastest = static_cast<int>(i);
+        }
+    }
+    return fastest;
+}
+
+bool Aggregates::TrialSnapshot::isFaster(const int index, const int other) const {
+    return durationsMs[index] != durationsMs[other] ? durationsMs[index] < durationsMs[other] : resultIds[index] < resultIds[other];
+}
+
+QString Aggregates::TrialSnapshot::categoryName(const int categoryId) const {
+    const auto it = categoryNames.constFind(categoryId);
+    return it != categoryNames.constEnd() ? it.value() : QString("ID: %1").arg(categoryId);
+}
+
+QString Aggregates::TrialSnapshot::modalityName(const int modalityId) const {
+    const auto it = modalityNames.constFind(modalityId);
+    return it != modalityNames.constEnd() ? it.value() : QString("ID: %1").arg(modalityId);
+}
@@ -0,0 +1,90 @@
+#ifndef TRIALSNAPSHOT_H
+#define TRIALSNAPSHOT_H
+
+#include "trialaggregate.h"
+#include "result.h"
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QSqlDatabase>
+#include <limits>
+#include <tl/expected.hpp>
+
+namespace Aggregates {
+
+// Pre-joined, column-oriented copy of a trial's registrations and, optionally, results.
+// Row i of every registration column describes the same registration; rows are ordered by
+// modality name and then plate (numerically when both plates are numbers).
+// Names are resolved once at load time so readers never scan lookup vectors.
+// Result columns refer to their registration row instead of repeating its plate and names,
+// and are kept current with applyResults() instead of reloading.
+struct TrialSnapshot {
+    static constexpr qint64 noTime = std::numeric_limits<qint64>::min();
+
+    int trialId = -1;
+
+    QVector<int> registrationIds;
+    QVector<int> athleteIds;
+    QVector<int> categoryIds;
+    QVector<int> modalityIds;
+    QVector<QString> plateCodes;
+    QVector<QString> athleteNames;
+    QVector<int> bestResults;       // index into the result columns, -1 when not finished
+
+    QHash<int, QString> categoryNames;
+    QHash<int, QString> modalityNames;
+    QHash<int, int> registrationsByCategory;
+
+    // One entry per stored result, in no particular order
+    QVector<int> resultIds;
+    QVector<int> resultRows;        // registration row of the result
+    QVector<int> durationsMs;
+    QVector<qint64> startTimesMs;   // epoch ms, noTime when unknown
+    QVector<qint64> endTimesMs;
+    QVector<qint64> elapsedNs;
+    QVector<QString> resultNotes;
+
+    // One joined query for the registrations plus one indexed scan for the results
+    [[nodiscard]] static tl::expected<TrialSnapshot, QString> load(const QSqlDatabase& db, int trialId, bool withResults = false);
+
+    [[nodiscard]] qsizetype size() const { return registrationIds.size(); }
+    [[nodiscard]] bool isEmpty() const { return registrationIds.isEmpty(); }
+    [[nodiscard]] qsizetype resultCount() const { return resultIds.size(); }
+    [[nodiscard]] int finishedCount() const;
+
+    [[nodiscard]] QString categoryName(int categoryId) const;
+    [[nodiscard]] QString modalityName(int modalityId) const;
+
+    // -1 when the plate / registration / result is not part of the trial
+    [[nodiscard]] int rowOfPlate(const QString& plateCode) const { return m_rowByPlate.value(plateCode, -1); }
+    [[nodiscard]] int rowOfRegistration(int registrationId) const { return m_rowByRegistration.value(registrationId, -1); }
+    [[nodiscard]] int indexOfResult(int resultId) const { return m_indexByResult.value(resultId, -1); }
+
+    // Appends new results and overwrites corrected ones (same id). Returns how many refer to
+    // registrations missing from the snapshot; those are skipped and call for a reload.
+    int applyResults(const QVector<Results::Result>& results);
+
+    // Category and modality both known, which is what the ranking joins require
+    [[nodiscard]] bool isRanked(int row) const;
+    [[nodiscard]] Results::Result result(int index) const;
+    [[nodiscard]] RankingEntry rankingEntry(int index, int position = 0) const;
+
+    // Ranked result indexes ordered by duration, then result id; 0 matches any category / modality
+    [[nodiscard]] QVector<int> rankedResults(int categoryId = 0, int modalityId = 0) const;
+    // Durations of the same results, unordered and contiguous for the statistics kernel
+    [[nodiscard]] QVector<int> rankedDurations(int categoryId = 0, int modalityId = 0) const;
+    // -1 when nobody finished
+    [[nodiscard]] int fastestResult() const;
+
+private:
+    QHash<QString, int> m_rowByPlate;
+    QHash<int, int> m_rowByRegistration;
+    QHash<int, int> m_indexByResult;
+
+    [[nodiscard]] bool isFaster(int index, int other) const;
+    [[nodiscard]] tl::expected<void, QString> loadResults(const QSqlDatabase& db);
+};
+
+};
+
+#endif // TRIALSNAPSHOT_H
@@ -1,4 +1,6 @@
-QT       += core gui sql xml
+QT       += core gui sql xml network
+# Qt's zip reader, used by utils/ziparchive.cpp only
+QT       += gui-private
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -27,44 +29,94 @@ SOURCES += \
     dbmanager.cpp \
     loadparticipantswindow.cpp \
     participantswindow.cpp \
+    participantsmodel.cpp \
+    leaderboardwindow.cpp \
+    leaderboardmodel.cpp \
     utils/excelutils.cpp \
+    utils/xlsxstreamreader.cpp \
+    utils/xlsxstreamwriter.cpp \
+    utils/ziparchive.cpp \
     utils/timeutils.cpp \
+    utils/trialclock.cpp \
+    utils/interning.cpp \
+    utils/durationstats.cpp \
     main.cpp \
     cronometerwindow.cpp \
     neweventwindow.cpp \
     report.cpp \
+    reportworker.cpp \
+    reportsinks.cpp \
+    exportengine.cpp \
+    exportdialog.cpp \
     repository/athletes/athletesrepository.cpp \
     repository/categories/categoriesrepository.cpp \
     repository/modalities/modalitiesrepository.cpp \
     repository/trials/trialsrepository.cpp \
     repository/registrations/registrationsrepository.cpp \
+    repository/registrations/plateindex.cpp \
+    repository/registrations/bulkimporter.cpp \
     repository/results/resultsrepository.cpp \
+    repository/results/resultsjournal.cpp \
+    repository/checkpoints/checkpointsrepository.cpp \
+    repository/waves/wavesrepository.cpp \
+    ingest/stationevent.cpp \
+    ingest/ingestserver.cpp \
     aggregates/trialaggregate.cpp \
-    aggregates/eventaggregate.cpp
+    aggregates/eventaggregate.cpp \
+    aggregates/trialsnapshot.cpp \
+    aggregates/rankingindex.cpp \
+    aggregates/splitaggregate.cpp
 
 HEADERS += \
     cronometerwindow.h \
     dbmanager.h \
     loadparticipantswindow.h \
     participantswindow.h \
+    participantsmodel.h \
+    leaderboardwindow.h \
+    leaderboardmodel.h \
     utils/excelutils.h \
+    utils/xlsxstreamreader.h \
+    utils/xlsxstreamwriter.h \
+    utils/ziparchive.h \
     utils/timeutils.h \
+    utils/trialclock.h \
+    utils/interning.h \
+    utils/durationstats.h \
     neweventwindow.h \
     report.h \
+    reportworker.h \
+    reportsinks.h \
+    exportengine.h \
+    exportdialog.h \
     model/modality.h \
     model/athlete.h \
     model/category.h \
     model/trialinfo.h \
     model/registration.h \
     model/result.h \
+    model/checkpoint.h \
+    model/wave.h \
     repository/athletes/athletesrepository.h \
     repository/modalities/modalitiesrepository.h \
     repository/categories/categoriesrepository.h \
     repository/trials/trialsrepository.h \
     repository/registrations/registrationsrepository.h \
+    repository/registrations/plateindex.h \
+    repository/registrations/bulkimporter.h \
     repository/results/resultsrepository.h \
+    repository/results/resultsjournal.h \
+    repository/checkpoints/checkpointsrepository.h \
+    repository/waves/wavesrepository.h \
+    ingest/stationevent.h \
+    ingest/ingestserver.h \
+    utils/mpscqueue.h \
+    utils/orderstatistictree.h \
     aggregates/trialaggregate.h \
-    aggregates/eventaggregate.h
+    aggregates/eventaggregate.h \
+    aggregates/trialsnapshot.h \
+    aggregates/rankingindex.h \
+    aggregates/splitaggregate.h
 
 FORMS += \
     cronometerwindow.ui \
@@ -15,10 +15,12 @@
 #include <QFile>
 #include <QCoreApplication>
 #include <QMenu>
-#include "report.h"
+#include "reportworker.h"
 #include "repository/trials/trialsrepository.h"
 #include "repository/registrations/registrationsrepository.h"
 #include "repository/results/resultsrepository.h"
+#include "repository/checkpoints/checkpointsrepository.h"
+#include "repository/waves/wavesrepository.h"
 #include "neweventwindow.h"
 #include "participantswindow.h"
 #include "loadparticipantswindow.h"
@@ -39,7 +41,7 @@ CronometerWindow::CronometerWindow(QWidget *parent)
     loadSettings();
     
     // Initialize database with the path from settings
-    chronoDb = DBManager(m_dbPath);
+    chronoDb = DBManager(m_dbPath, m_dbProfile);
     
     ui->setupUi(this);
     
@@ -51,6 +53,27 @@ CronometerWindow::CronometerWindow(QWidget *parent)
         QMessageBox::critical(this, "Database Error", 
             QString("Failed to open database: %1").arg(m_dbPath));
     }
+
+    // Start the write-behind journal used to store finish events
+    m_journal = std::make_unique<Results::Journal>(m_dbPath, m_dbProfile);
+    connect(m_journal.get(), &Results::Journal::writeFailed, this, [this](const QString& error) {
+        qWarning() << "Journal write failed:" << error;
+        statusBar()->showMessage(QString("✗ Erro ao gravar resultados: %1").arg(error), 8000);
+        statusBar()->setStyleSheet("QStatusBar { background-color: #f8d7da; color: #721c24; }");
+    });
+    connect(m_journal.get(), &Results::Journal::resultsCommitted, this, [this](const QVector<Results::Result>& results) {
+        if (m_leaderboard) {
+            syncLeaderboardTrial();
+            m_leaderboard->addResults(results);
+        }
+    });
+    m_journal->start();
+
+    m_journalStatusLabel = new QLabel(this);
+    statusBar()->addPermanentWidget(m_journalStatusLabel);
+
+    // Remote capture stations feed the same journal
+    startIngestServer();
     
     // Initialize state
     m_started = false;
@@ -68,6 +91,14 @@ CronometerWindow::CronometerWindow(QWidget *parent)
     // Configure timer to update the state of the Start button
     connect(&m_startButtonUpdateTimer, &QTimer::timeout, this, &CronometerWindow::updateStartButtonState);
     m_startButtonUpdateTimer.start(60000); // Update every minute
+
+    // Periodically let SQLite refresh its planner statistics
+    if (m_dbProfile.optimizeIntervalMinutes > 0) {
+        connect(&m_optimizeTimer, &QTimer::timeout, this, [this]() {
+            DBManager::optimize(chronoDb.database());
+        });
+        m_optimizeTimer.start(m_dbProfile.optimizeIntervalMinutes * 60000);
+    }
     
     // Connect Exit menu directly to close()
     auto* exitAction = findChild<QAction*>("actionExit");
@@ -89,6 +120,13 @@ CronometerWindow::CronometerWindow(QWidget *parent)
 }
 
 CronometerWindow::~CronometerWindow() {
+    if (m_reportWorker) {
+        m_reportWorker->cancel();
+        m_reportWorker->wait();
+    }
+    delete m_exportDialog;
+    m_ingestServer.reset();
+    m_journal->stop();
     delete ui;
 }
 
@@ -112,12 +150,23 @@ void CronometerWindow::on_btnStart_clicked() {
 
     if (m_started) {
         // Check if there are existing results before starting
+        if (!journalFlushed("Starting the trial", false)) {
+            m_started = false;
+            updateMenusState();
+            return;
+        }
         Results::Repository resultsRepo(chronoDb.database());
+        const Checkpoints::Repository checkpointsRepo(chronoDb.database());
 
-        if (auto existingResultsCheck = resultsRepo.getResultsByTrial(m_currentTrialId); existingResultsCheck.has_value() && !existingResultsCheck.value().isEmpty()) {
+        const auto existingResults = resultsRepo.getResultsByTrial(m_currentTrialId);
+        const auto existingCrossings = checkpointsRepo.countCrossingsByTrial(m_currentTrialId);
+        const int resultCount = existingResults.has_value() ? static_cast<int>(existingResults->size()) : 0;
+        const int crossingCount = existingCrossings.value_or(0);
+
+        if (resultCount > 0 || crossingCount > 0) {
             auto reply = QMessageBox::question(this, "Existing Results", 
-                QString("There are %1 existing results for this trial.\n\nDo you want to remove all previous results and start fresh?")
-                    .arg(existingResultsCheck.value().size()),
+                QString("There are %1 existing results and %2 splits for this trial.\n\nDo you want to remove all previous results and start fresh?")
+                    .arg(resultCount).arg(crossingCount),
                 QMessageBox::Yes | QMessageBox::No);
                 
             if (reply == QMessageBox::No) {
@@ -126,18 +175,21 @@ void CronometerWindow::on_btnStart_clicked() {
                 return;
             }
             
-            // Delete all existing results
-            const auto& existingResults = existingResultsCheck.value();
-            for (const auto& result : existingResults) {
-                if (auto deleteResult = resultsRepo.deleteResultById(result.id); !deleteResult.has_value()) {
-                    QMessageBox::warning(this, "Error",
-                                         QString("Failed to delete result ID %1: %2").arg(QString::number(result.id), deleteResult.error()));
+            // Results and splits go together, so a failed reset leaves the previous run intact
+            if (auto deleted = resultsRepo.deleteResultsByTrial(m_currentTrialId); deleted.has_value()) {
+                qDebug() << "Deleted" << resultCount << "existing results and" << crossingCount << "splits for trial" << m_currentTrialId;
+                // The trial id does not change, so syncLeaderboardTrial would keep the deleted run on screen
+                if (m_leaderboard) {
+                    m_leaderboard->setTrial(m_currentTrialId, m_selectedEventName);
                 }
+            } else {
+                QMessageBox::warning(this, "Error", QString("Failed to delete previous results: %1").arg(deleted.error()));
             }
-            qDebug() << "Deleted" << existingResults.size() << "existing results for trial" << m_currentTrialId;
         }
         
         m_startTime = Utils::DateTimeUtils::now();
+        m_clock.start(m_startTime);
+        rebuildPlateIndex();
         startCounterTimer();
         qDebug() << "Started trial:" << m_selectedEventName << "with ID:" << m_currentTrialId;
 
@@ -151,6 +203,9 @@ void CronometerWindow::on_btnStart_clicked() {
         }
     } else {
         stopCounterTimer();
+        m_clock.stop();
+        m_plateIndex.clear();
+        m_checkpointIds.clear();
         ui->btnRegister->setEnabled(false);
         qDebug() << "Finalizing trial with ID:" << m_currentTrialId;
         
@@ -178,8 +233,13 @@ void CronometerWindow::closeEvent(QCloseEvent *event) {
         if (const auto reply =
                 QMessageBox::question(this, "Trial in Progress", "A trial is currently running. Do you want to stop it and exit?",
                     QMessageBox::Yes | QMessageBox::No); reply == QMessageBox::Yes) {
+            if (!journalFlushed("Exiting", true)) {
+                event->ignore();
+                return;
+            }
             m_started = false;
             stopCounterTimer();
+            m_clock.stop();
             event->accept();
         } else {
             event->ignore();
@@ -196,11 +256,21 @@ void CronometerWindow::stopCounterTimer() {
 }
 
 void CronometerWindow::updateCounterTimer() const {
-    const int secs = static_cast<int>(m_startTime.secsTo(Utils::DateTimeUtils::now()));
+    const int secs = static_cast<int>(m_clock.elapsedMs() / 1000);
     QTime display(0, 0);
     display = display.addSecs(secs);
 
     ui->lblTime->setText(display.toString(timeFormat));
+
+    const auto stats = m_journal->stats();
+    QString status = QString("Queue: %1 | Commit: %2 ms")
+                         .arg(stats.queueDepth)
+                         .arg(static_cast<double>(stats.lastCommitLatencyUs) / 1000.0, 0, 'f', 1);
+    if (m_ingestServer) {
+        const auto ingest = m_ingestServer->stats();
+        status += QString(" | Stations: %1 | Ingested: %2").arg(ingest.activeConnections).arg(ingest.accepted);
+    }
+    m_journalStatusLabel->setText(status);
 }
 
 void CronometerWindow::updateRegisterButton() const {
@@ -217,52 +287,57 @@ void CronometerWindow::on_btnRegister_clicked() {
     QStringList placas = ui->edtPlaque->text().split(",", Qt::SkipEmptyParts);
     std::ranges::transform(placas, placas.begin(), [](const QString &s){ return s.trimmed(); });
     
-    QDateTime curTime = Utils::DateTimeUtils::now();
-    int durationMs = static_cast<int>(m_startTime.msecsTo(curTime));
+    // One monotonic capture per burst; the wall time is derived from the trial anchor
+    const auto capture = m_clock.capture();
+    const QDateTime curTime = capture.wallTime;
 
     int registered = 0;
     int errors = 0;
     QStringList errorMessages;
 
     try {
-        Registrations::Repository registrationsRepo(chronoDb.database());
-        Results::Repository resultsRepo(chronoDb.database());
+        if (auto resolved = resolvePlates(placas); !resolved) {
+            QMessageBox::critical(this, "Error", QString("Erro ao buscar inscrições: %1").arg(resolved.error()));
+            return;
+        }
 
-        for(const auto& placa : placas) {
-            // Search for participant registration by plate number
-            auto registrationResult = registrationsRepo.getRegistrationByPlateCode(m_currentTrialId, placa);
-            
-            if (!registrationResult.has_value()) {
-                errorMessages.append(QString("Placa %1: %2").arg(placa, registrationResult.error()));
+        QVector<Results::Journal::Event> pendingEvents;
+        pendingEvents.reserve(placas.size());
+
+        for (const auto& placa : placas) {
+            const auto* entry = m_plateIndex.find(placa);
+            if (!entry) {
+                errorMessages.append(QString("Placa %1: not registered in this trial").arg(placa));
                 errors++;
                 continue;
             }
-            
-            auto registration = registrationResult.value();
-            
+
+            // Net time: wave and individual starts come from the index, not the database
+            const qint64 netMs = capture.elapsedMs - entry->startOffsetMs;
+            if (netMs <= 0) {
+                errorMessages.append(QString("Placa %1: finished before its start").arg(placa));
+                errors++;
+                continue;
+            }
+
             // Create the result (allows multiple results for the same plate)
             QString note = QString("Athlete %1 finished at %2")
                                 .arg(placa, curTime.toString(Qt::ISODate));
-            
-            auto resultCreated = resultsRepo.createResult(
-                registration.id,
-                m_startTime,
-                curTime,
-                durationMs,
-                note
-            );
-            
-            if (resultCreated.has_value()) {
-                registered++;
-                qDebug() << "Successfully registered result for plate" << placa 
-                         << "Registration ID:" << registration.id
-                         << "Result ID:" << resultCreated.value().id
-                         << "Duration:" << durationMs << "ms";
-            } else {
-                errorMessages.append(QString("Placa %1: %2").arg(placa, resultCreated.error()));
-                errors++;
-            }
+
+            pendingEvents.push_back({
+                .registrationId = entry->registrationId,
+                .plateCode = placa,
+                .startTime = m_startTime.addMSecs(entry->startOffsetMs),
+                .capturedAt = curTime,
+                .elapsedNs = capture.elapsedNs,
+                .durationMs = static_cast<int>(netMs),
+                .notes = note
+            });
         }
+
+        // The journal thread stores the whole burst in one transaction
+        m_journal->enqueue(pendingEvents);
+        registered = static_cast<int>(pendingEvents.size());
     } catch (const std::exception& e) {
         QMessageBox::critical(this, "Error", QString("Erro ao registrar resultados: %1").arg(e.what()));
         return;
@@ -301,10 +376,20 @@ void CronometerWindow::on_btnRegister_clicked() {
     // Results registered successfully (no automatic report generation)
 }
 
-void CronometerWindow::generateReport() const {
+void CronometerWindow::generateReport() {
     if (m_currentTrialId == -1) {
         return;
     }
+
+    // One export at a time; bring the running one back to front
+    if (m_reportWorker) {
+        if (m_reportProgress) {
+            m_reportProgress->show();
+            m_reportProgress->raise();
+            m_reportProgress->activateWindow();
+        }
+        return;
+    }
     
     // Define report file name
     const QString defaultFileName = QString("report_%1_%2.xlsx")
@@ -318,11 +403,50 @@ void CronometerWindow::generateReport() const {
         return;
     }
     
-    // Generate the report
-    if (!Report::exportExcel(m_currentTrialId, fileName, chronoDb.database())) {
+    // Make sure every captured finish is in the database before exporting
+    if (!journalFlushed("Generating the report", true)) {
+        return;
+    }
+
+    // Generate the report on its own thread and connection; timing keeps running meanwhile
+    auto* worker = new ReportWorker(m_dbPath, m_dbProfile, m_currentTrialId, fileName, this);
+    m_reportWorker = worker;
+
+    auto* progress = new QProgressDialog("Gerando relatório Excel...", "Cancelar", 0, 0, this);
+    progress->setWindowTitle(m_selectedEventName);
+    progress->setWindowModality(Qt::NonModal);
+    progress->setAutoClose(false);
+    progress->setAutoReset(false);
+    progress->setMinimumDuration(0);
+    progress->setAttribute(Qt::WA_DeleteOnClose);
+    m_reportProgress = progress;
+
+    connect(progress, &QProgressDialog::canceled, worker, &ReportWorker::cancel);
+    connect(worker, &ReportWorker::progressChanged, progress, [progress](const qint64 rowsWritten, const qint64 totalRows) {
+        if (totalRows > 0) {
+            progress->setMaximum(static_cast<int>(totalRows));
+            progress->setValue(static_cast<int>(std::min(rowsWritten, totalRows)));
+        }
+        progress->setLabelText(QString("Gerando relatório Excel... %1 linha(s)").arg(rowsWritten));
+    });
+    connect(worker, &ReportWorker::reportFinished, this, [this](const QString& reportFile, const qint64 rowsWritten) {
+        statusBar()->setStyleSheet("QStatusBar { background-color: #d4edda; color: #155724; }");
+        statusBar()->showMessage(QString("✓ Excel report saved (%1 rows): %2").arg(rowsWritten).arg(reportFile), 5000);
+    });
+    connect(worker, &ReportWorker::reportCancelled, this, [this]() {
+        statusBar()->setStyleSheet("");
+        statusBar()->showMessage("Excel report cancelled", 3000);
+    });
+    connect(worker, &ReportWorker::reportFailed, this, [this](const QString& error) {
+        qWarning() << error;
         statusBar()->showMessage("✗ Error generating Excel report", 5000);
         statusBar()->setStyleSheet("QStatusBar { background-color: #f8d7da; color: #721c24; }");
-    }
+    });
+    connect(worker, &QThread::finished, progress, &QWidget::close);
+    connect(worker, &QThread::finished, worker, &QObject::deleteLater);
+
+    worker->start();
+    progress->show();
 }
 
 void CronometerWindow::on_actionGenerate_Excel_triggered() {
@@ -444,6 +568,16 @@ void CronometerWindow::loadSettings() {
     m_openTrialWindowDays = settings.value("OpenTrialWindowDays", "2").toInt();
     settings.endGroup();
 
+    // Capture stations (off unless enabled)
+    settings.beginGroup("Ingest");
+    m_ingestEnabled = settings.value("Enabled", false).toBool();
+    m_ingestServerName = settings.value("ServerName", "crono-ingest").toString();
+    m_ingestAllowAllUsers = settings.value("AllowAllUsers", false).toBool();
+    settings.endGroup();
+
+    // SQLite tuning preset and overrides
+    m_dbProfile = DBPerformanceProfile::fromSettings(settings);
+
     
     // Log loaded configuration
     qDebug() << "Project root detected:" << projectRoot;
@@ -822,6 +956,11 @@ void CronometerWindow::on_actionLoad_from_file_triggered()
         loadDialog.setAvailableTrials(trialsResult.value());
         
         if (loadDialog.exec() == QDialog::Accepted) {
+            // Keep the plate index in sync with the imported registrations
+            if (m_plateIndex.trialId() == m_currentTrialId) {
+                rebuildPlateIndex();
+            }
+
             // Refresh current event display if needed
             loadEventsToMenu();
             QMessageBox::information(this, "Success", 
@@ -946,7 +1085,9 @@ void CronometerWindow::checkAndStartRunningTrial() {
         
         // Set the chronometer with the trial's startDateTime
         m_startTime = runningTrial.startDateTime;
+        m_clock.start(m_startTime);
         m_started = true;
+        rebuildPlateIndex();
         
         // Update interface
         setControlsStatus(m_started);
@@ -987,6 +1128,305 @@ void CronometerWindow::checkAndStartRunningTrial() {
     }
 }
 
+void CronometerWindow::rebuildPlateIndex() {
+    if (auto rebuilt = m_plateIndex.rebuild(chronoDb.database(), m_currentTrialId); rebuilt.has_value()) {
+        qDebug() << "Plate index built for trial" << m_currentTrialId << "with" << m_plateIndex.size() << "plates";
+    } else {
+        // Lookups fall back to the database for plates missing from the index
+        qWarning() << "Error building plate index:" << rebuilt.error();
+    }
+
+    m_checkpointIds.clear();
+    const Checkpoints::Repository checkpointsRepo(chronoDb.database());
+    if (auto checkpoints = checkpointsRepo.getCheckpointsByTrial(m_currentTrialId); checkpoints.has_value()) {
+        for (const auto& checkpoint : checkpoints.value()) {
+            m_checkpointIds.insert(checkpoint.code, checkpoint.id);
+        }
+    } else {
+        qWarning() << "Error loading checkpoints:" << checkpoints.error();
+    }
+
+    syncLeaderboardTrial();
+}
+
+tl::expected<void, QString> CronometerWindow::resolvePlates(const QStringList& plates) {
+    // Plates are resolved from the in-memory index; only unknown plates go to the database
+    QStringList missingPlates;
+    for (const auto& plate : plates) {
+        if (!m_plateIndex.find(plate)) {
+            missingPlates.append(plate);
+        }
+    }
+
+    if (missingPlates.isEmpty()) {
+        return {};
+    }
+
+    // Loaded with their wave / individual start offsets so these finishes are stored as net time too
+    if (auto loaded = m_plateIndex.load(chronoDb.database(), missingPlates); !loaded.has_value()) {
+        return tl::unexpected(loaded.error());
+    }
+    return {};
+}
+
+void CronometerWindow::startIngestServer() {
+    if (!m_ingestEnabled) {
+        return;
+    }
+
+    m_ingestServer = std::make_unique<Ingest::Server>([this](const QVector<Ingest::StationEvent>& events) {
+        return ingestStationEvents(events);
+    });
+
+    // Stations are acked once their events are committed, never when they are only queued
+    connect(m_journal.get(), &Results::Journal::eventsStored, m_ingestServer.get(), [this](const QStringList& eventIds) {
+        m_ingestServer->acknowledge(eventIds);
+    });
+    connect(m_journal.get(), &Results::Journal::eventsRejected, m_ingestServer.get(), [this](const QStringList& eventIds, const QString& error) {
+        m_ingestServer->acknowledge(eventIds, error);
+    });
+
+    if (auto listening = m_ingestServer->listen(m_ingestServerName, m_ingestAllowAllUsers); !listening) {
+        qWarning() << listening.error();
+        statusBar()->showMessage(QString("✗ Estações de cronometragem indisponíveis: %1").arg(listening.error()), 8000);
+        m_ingestServer.reset();
+    }
+}
+
+QStringList CronometerWindow::ingestStationEvents(const QVector<Ingest::StationEvent>& events) {
+    QStringList rejections;
+    rejections.reserve(events.size());
+
+    if (!m_started || m_currentTrialId <= 0) {
+        for (qsizetype i = 0; i < events.size(); ++i) {
+            rejections.append("no trial is being timed");
+        }
+        return rejections;
+    }
+
+    QStringList plates;
+    plates.reserve(events.size());
+    for (const auto& event : events) {
+        plates.append(event.plateCode);
+    }
+    if (auto resolved = resolvePlates(plates); !resolved) {
+        qWarning() << "[IN] Error resolving plates:" << resolved.error();
+        for (qsizetype i = 0; i < events.size(); ++i) {
+            rejections.append("registration lookup failed, retry");
+        }
+        return rejections;
+    }
+
+    QVector<Results::Journal::Event> pendingEvents;
+    pendingEvents.reserve(events.size());
+
+    for (const auto& event : events) {
+        int checkpointId = 0;
+        if (event.type == Ingest::StationEvent::Split) {
+            checkpointId = m_checkpointIds.value(event.checkpoint);
+            if (checkpointId <= 0) {
+                rejections.append(QString("unknown checkpoint %1").arg(event.checkpoint));
+                continue;
+            }
+        }
+
+        const auto* entry = m_plateIndex.find(event.plateCode);
+        if (!entry) {
+            rejections.append(QString("plate %1 is not registered in this trial").arg(event.plateCode));
+            continue;
+        }
+
+        // Stations stamp with their own clock, which must be synchronised with this one
+        const qint64 durationMs = m_startTime.msecsTo(event.capturedAt) - entry->startOffsetMs;
+        if (durationMs < 0) {
+            rejections.append("captured before the athlete started");
+            continue;
+        }
+
+        pendingEvents.push_back({
+            .registrationId = entry->registrationId,
+            .plateCode = event.plateCode,
+            .startTime = m_startTime.addMSecs(entry->startOffsetMs),
+            .capturedAt = event.capturedAt,
+            .durationMs = static_cast<int>(durationMs),
+            .notes = checkpointId > 0
+                         ? QString()
+                         : QString("Athlete %1 finished at %2 (station %3)")
+                               .arg(event.plateCode, event.capturedAt.toString(Qt::ISODate), event.stationId),
+            .eventId = event.eventId,
+            .checkpointId = checkpointId
+        });
+        rejections.append(QString());
+    }
+
+    // The journal batches these with the local captures; the stations get their acks on commit
+    m_journal->enqueue(pendingEvents);
+    return rejections;
+}
+
+void CronometerWindow::on_actionExport_Reports_triggered() {
+    if (!m_exportDialog) {
+        m_exportDialog = new ExportDialog(m_dbPath, m_dbProfile, m_currentTrialId, m_reportPath, this);
+        m_exportDialog->setAttribute(Qt::WA_DeleteOnClose);
+        // Make sure every captured finish is in the database before exporting
+        m_exportDialog->setPrepareHook([this]() { return journalFlushed("Exporting", true); });
+    }
+
+    m_exportDialog->show();
+    m_exportDialog->raise();
+    m_exportDialog->activateWindow();
+}
+
+void CronometerWindow::on_actionStart_Wave_triggered() {
+    if (!m_started || m_currentTrialId == -1) {
+        QMessageBox::warning(this, "Warning", "No active trial. Please start a trial first.");
+        return;
+    }
+
+    // The wave left when the operator clicked, not when the dialogs were answered
+    const int startOffsetMs = static_cast<int>(m_clock.elapsedMs());
+
+    const Waves::Repository wavesRepo(chronoDb.database());
+    auto waves = wavesRepo.getWavesByTrial(m_currentTrialId);
+    if (!waves.has_value()) {
+        QMessageBox::critical(this, "Error", QString("Erro ao carregar as ondas: %1").arg(waves.error()));
+        return;
+    }
+
+    QStringList names;
+    for (const auto& wave : waves.value()) {
+        names.append(wave.name);
+    }
+
+    bool ok = false;
+    const QString name = QInputDialog::getItem(this, "Largar onda",
+        QString("Largada em %1.\nOnda (digite um nome para criar uma nova):").arg(Utils::TimeFormatter::formatTime(startOffsetMs)),
+        names, 0, true, &ok).trimmed();
+    if (!ok || name.isEmpty()) {
+        return;
+    }
+
+    const auto existing = std::ranges::find(waves.value(), name, &Waves::Wave::name);
+    Waves::Wave wave;
+    QVector<int> registrationIds;
+    QStringList plates;
+
+    if (existing != waves.value().end()) {
+        wave = *existing;
+        if (wave.started && QMessageBox::question(this, "Largar onda",
+                QString("A onda %1 já largou em %2. Corrigir para %3?")
+                    .arg(wave.name, Utils::TimeFormatter::formatTime(wave.startOffsetMs), Utils::TimeFormatter::formatTime(startOffsetMs)))
+                != QMessageBox::Yes) {
+            return;
+        }
+    } else {
+        plates = QInputDialog::getText(this, "Nova onda", QString("Placas da onda %1 (separadas por vírgula):").arg(name),
+                                       QLineEdit::Normal, QString(), &ok).split(",", Qt::SkipEmptyParts);
+        if (!ok) {
+            return;
+        }
+        std::ranges::transform(plates, plates.begin(), [](const QString &s){ return s.trimmed(); });
+
+        if (auto resolved = resolvePlates(plates); !resolved) {
+            QMessageBox::critical(this, "Error", QString("Erro ao buscar inscrições: %1").arg(resolved.error()));
+            return;
+        }
+        for (const auto& plate : plates) {
+            if (const auto* entry = m_plateIndex.find(plate)) {
+                registrationIds.append(entry->registrationId);
+            }
+        }
+
+        auto created = wavesRepo.createWave(m_currentTrialId, name);
+        if (!created.has_value()) {
+            QMessageBox::critical(this, "Error", QString("Erro ao criar a onda: %1").arg(created.error()));
+            return;
+        }
+        wave = created.value();
+    }
+
+    // Finishes still queued were computed with the previous offsets and are shifted with the rest;
+    // one stored after the shift would keep the old offset
+    if (!journalFlushed("Starting the wave", false)) {
+        return;
+    }
+
+    int shifted = 0;
+    if (!registrationIds.isEmpty()) {
+        auto assigned = wavesRepo.assignRegistrations(wave.id, registrationIds);
+        if (!assigned.has_value()) {
+            QMessageBox::critical(this, "Error", QString("Erro ao atribuir a onda: %1").arg(assigned.error()));
+            return;
+        }
+        shifted += assigned.value();
+        for (const auto& plate : plates) {
+            m_plateIndex.setWave(plate, wave.id, 0);
+        }
+    }
+
+    auto started = wavesRepo.startWave(wave.id, startOffsetMs);
+    if (!started.has_value()) {
+        QMessageBox::critical(this, "Error", QString("Erro ao largar a onda: %1").arg(started.error()));
+        return;
+    }
+    shifted += started.value();
+    m_plateIndex.setWaveStart(wave.id, startOffsetMs);
+
+    qDebug() << "Wave" << wave.name << "started at" << startOffsetMs << "ms -" << registrationIds.size()
+             << "registration(s) assigned," << shifted << "result(s) shifted";
+
+    if (shifted > 0 && m_leaderboard) {
+        m_leaderboard->setTrial(m_currentTrialId, m_selectedEventName);
+    }
+
+    statusBar()->showMessage(QString("✓ Onda %1 largou em %2").arg(wave.name, Utils::TimeFormatter::formatTime(startOffsetMs)), 5000);
+    statusBar()->setStyleSheet("QStatusBar { background-color: #d4edda; color: #155724; }");
+}
+
+void CronometerWindow::on_actionLive_Leaderboard_triggered() {
+    if (!m_leaderboard) {
+        m_leaderboard = new LeaderboardWindow(chronoDb, this);
+        m_leaderboard->setAttribute(Qt::WA_DeleteOnClose);
+    }
+
+    syncLeaderboardTrial();
+    m_leaderboard->show();
+    m_leaderboard->raise();
+    m_leaderboard->activateWindow();
+}
+
+void CronometerWindow::syncLeaderboardTrial() {
+    if (!m_leaderboard || m_leaderboard->trialId() == m_currentTrialId) {
+        return;
+    }
+
+    // Commits still queued in the journal would otherwise be missed by the reload
+    if (!m_journal->flush()) {
+        statusBar()->showMessage(QString("✗ %1 resultado(s) ainda não gravado(s); o leaderboard pode estar incompleto")
+                                     .arg(m_journal->stats().queueDepth), 8000);
+    }
+    m_leaderboard->setTrial(m_currentTrialId, m_selectedEventName);
+}
+
+bool CronometerWindow::journalFlushed(const QString& action, const bool allowOverride) {
+    if (m_journal->flush()) {
+        return true;
+    }
+
+    const QString pending = QString("%1 finish event(s) are still waiting to be saved to the database.")
+                                .arg(m_journal->stats().queueDepth);
+    if (!allowOverride) {
+        QMessageBox::warning(this, "Pending Results", QString("%1
+
+%2 was cancelled; try again in a moment.").arg(pending, action));
+        return false;
+    }
+    return QMessageBox::question(this, "Pending Results", QString("%1
+
+%2 anyway?").arg(pending, action),
+                                 QMessageBox::Yes | QMessageBox::No, QMessageBox::No) == QMessageBox::Yes;
+}
+
 void CronometerWindow::updateMenusState() const {
     // Disable event selection if the chronometer is running
     if (m_eventsSubmenu) {
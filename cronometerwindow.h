@@ -16,10 +16,21 @@
 #include <QInputDialog>
 #include <QDesktopServices>
 #include <QDir>
+#include <QPointer>
+#include <QHash>
+#include <QProgressDialog>
+#include <memory>
 #include "dbmanager.h"
 #include "model/trialinfo.h"
+#include "repository/registrations/plateindex.h"
+#include "repository/results/resultsjournal.h"
+#include "utils/trialclock.h"
 #include "participantswindow.h"
 #include "loadparticipantswindow.h"
+#include "leaderboardwindow.h"
+#include "reportworker.h"
+#include "exportdialog.h"
+#include "ingest/ingestserver.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class CronometerWindow; }
@@ -43,6 +54,9 @@ private slots:
     void on_actionShow_triggered();
     void on_actionLoad_from_file_triggered();
     void on_actionGenerate_Excel_triggered();
+    void on_actionExport_Reports_triggered();
+    void on_actionLive_Leaderboard_triggered();
+    void on_actionStart_Wave_triggered();
 
 protected:
     void closeEvent(QCloseEvent *event) override;
@@ -54,9 +68,28 @@ private:
     // cronometer state
     bool m_started;
     QDateTime m_startTime;
+    Utils::TrialClock m_clock;
     QTimer m_timer;
     QTimer m_startButtonUpdateTimer;
+    QTimer m_optimizeTimer;
     int m_currentTrialId;
+    Registrations::PlateIndex m_plateIndex;
+    QHash<QString, int> m_checkpointIds;    // checkpoint code -> id for the trial being timed
+
+    // Finish events are written by the journal's own thread
+    std::unique_ptr<Results::Journal> m_journal;
+    QLabel* m_journalStatusLabel;
+
+    // Finish and split events from other capture stations, resolved here and handed to the journal
+    std::unique_ptr<Ingest::Server> m_ingestServer;
+
+    // Live ranking fed by the journal's commit notifications; owned by Qt once shown
+    QPointer<LeaderboardWindow> m_leaderboard;
+
+    // Excel export running in the background; both delete themselves when done
+    QPointer<ReportWorker> m_reportWorker;
+    QPointer<QProgressDialog> m_reportProgress;
+    QPointer<ExportDialog> m_exportDialog;
     
     // Dynamic events menu
     QMenu* m_eventsSubmenu;
@@ -67,8 +100,12 @@ private:
     static constexpr auto timeFormat = "hh:mm:ss";
     static constexpr auto eventMenuTimeFormat = "dd/MM/yyyy hh:mm:ss";
     QString m_dbPath;
+    DBPerformanceProfile m_dbProfile;
     QString m_reportPath;
     int m_openTrialWindowDays;
+    bool m_ingestEnabled = false;
+    QString m_ingestServerName;
+    bool m_ingestAllowAllUsers = false;
     
     // Helper methods
     void loadSettings();
@@ -79,9 +116,17 @@ private:
     void stopCounterTimer();
     void loadTodayTrial();
     void checkAndStartRunningTrial();
+    void rebuildPlateIndex();
+    [[nodiscard]] tl::expected<void, QString> resolvePlates(const QStringList& plates);
+    void startIngestServer();
+    QStringList ingestStationEvents(const QVector<Ingest::StationEvent>& events);
+    void syncLeaderboardTrial();
+    // Waits for the journal to store every queued finish. On timeout the operator is told; with
+    // allowOverride they may go on anyway, otherwise the action is cancelled. Returns whether to go on.
+    [[nodiscard]] bool journalFlushed(const QString& action, bool allowOverride);
     void updateMenusState() const;
     void showEventSelectionDialog();
-    void generateReport() const;
+    void generateReport();
     void closeOpenedEvents() const;
     static bool canStartEvent(const QDateTime& scheduledDateTime) ;
     void updateStartButtonState();
@@ -1,8 +1,65 @@
 #include "dbmanager.h"
 #include <QSqlError>
 #include <QSqlQuery>
+#include <QFileInfo>
+#include <QSettings>
+#include <QTimeZone>
+#include <QUuid>
+#include <algorithm>
+#include <array>
+#include "utils/timeutils.h"
 
-DBManager::DBManager(const QString& path) {
+DBPerformanceProfile DBPerformanceProfile::preset(const QString& name) {
+    DBPerformanceProfile profile;
+
+    if (name.compare("bulk-import", Qt::CaseInsensitive) == 0) {
+        // WAL + NORMAL cannot corrupt the database; at worst the last transactions before a power cut are lost
+        profile.name = "bulk-import";
+        profile.synchronous = "NORMAL";
+        profile.cacheSizeKiB = 65536;
+        profile.mmapSizeBytes = 256ll * 1024 * 1024;
+        profile.walAutocheckpointPages = 10000;
+        profile.optimizeIntervalMinutes = 10;
+    } else if (name.compare("race-day", Qt::CaseInsensitive) != 0) {
+        qWarning() << "[DB] Unknown performance profile" << name << "- using race-day";
+    }
+
+    return profile;
+}
+
+DBPerformanceProfile DBPerformanceProfile::fromSettings(QSettings& settings) {
+    settings.beginGroup("Performance");
+
+    const QString profileName = settings.value("Profile", "race-day").toString();
+    settings.setValue("Profile", profileName);
+    DBPerformanceProfile profile = preset(profileName);
+
+    // Optional per-value overrides of the preset
+    const QString synchronous = settings.value("Synchronous", profile.synchronous).toString().toUpper();
+    if (QStringList{ "OFF", "NORMAL", "FULL", "EXTRA" }.contains(synchronous)) {
+        profile.synchronous = synchronous;
+    } else {
+        qWarning() << "[DB] Invalid Performance/Synchronous value" << synchronous;
+    }
+
+    const QString tempStore = settings.value("TempStore", profile.tempStore).toString().toUpper();
+    if (QStringList{ "DEFAULT", "FILE", "MEMORY" }.contains(tempStore)) {
+        profile.tempStore = tempStore;
+    } else {
+        qWarning() << "[DB] Invalid Performance/TempStore value" << tempStore;
+    }
+
+    profile.cacheSizeKiB = std::max(0, settings.value("CacheSizeKiB", profile.cacheSizeKiB).toInt());
+    profile.mmapSizeBytes = std::max<qint64>(0, settings.value("MmapSizeMiB", profile.mmapSizeBytes / (1024 * 1024)).toLongLong()) * 1024 * 1024;
+    profile.busyTimeoutMs = std::max(0, settings.value("BusyTimeoutMs", profile.busyTimeoutMs).toInt());
+    profile.walAutocheckpointPages = std::max(0, settings.value("WalAutocheckpointPages", profile.walAutocheckpointPages).toInt());
+    profile.optimizeIntervalMinutes = std::max(0, settings.value("OptimizeIntervalMinutes", profile.optimizeIntervalMinutes).toInt());
+
+    settings.endGroup();
+    return profile;
+}
+
+DBManager::DBManager(const QString& path, const DBPerformanceProfile& profile) : m_profile(profile) {
     if (path.trimmed().isEmpty())
         return;
 
@@ -26,6 +83,10 @@ bool DBManager::isValid() const {
 }
 
 DBManager::~DBManager() {
+    releaseStatements(m_db.connectionName());
+    if (m_db.isOpen()) {
+        optimize(m_db);
+    }
     if (m_db.open()) {
         m_db.close();
     }
@@ -37,12 +98,9 @@ void DBManager::init() const {
         return;
     }
 
-    QSqlQuery query(m_db);
-
-    query.exec("PRAGMA foreign_keys = ON;");
-    query.exec("PRAGMA journal_mode = WAL;");
-    if (query.lastError().isValid()) {
-        qCritical() << "DB init error:" << query.lastError().text();
+    // Connection pragmas (WAL, foreign keys, performance profile) are applied by open()
+    if (auto migrated = migrate(m_db); !migrated) {
+        qFatal("[DB] Schema migration failed: %s", migrated.error().toLocal8Bit().constData());
     }
 
     qDebug() << "Database initialized successfully";
@@ -53,10 +111,623 @@ bool DBManager::isOpen() const{
 }
 
 bool DBManager::open() {
-    return m_db.open();
+    // Statements prepared on a previous session of this connection are no longer usable
+    releaseStatements(m_db.connectionName());
+    if (!m_db.open()) {
+        return false;
+    }
+
+    qInfo().noquote() << "[DB]" << applyConnectionPragmas(m_db, m_profile);
+    return true;
+}
+
+QString DBManager::applyConnectionPragmas(const QSqlDatabase& db, const DBPerformanceProfile& profile) {
+    QSqlQuery query(db);
+
+    // cache_size is negative to express KiB instead of pages
+    const QStringList pragmas {
+        "PRAGMA journal_mode = WAL;",
+        "PRAGMA foreign_keys = ON;",
+        QString("PRAGMA synchronous = %1;").arg(profile.synchronous),
+        QString("PRAGMA cache_size = -%1;").arg(profile.cacheSizeKiB),
+        QString("PRAGMA mmap_size = %1;").arg(profile.mmapSizeBytes),
+        QString("PRAGMA temp_store = %1;").arg(profile.tempStore),
+        QString("PRAGMA busy_timeout = %1;").arg(profile.busyTimeoutMs),
+        QString("PRAGMA wal_autocheckpoint = %1;").arg(profile.walAutocheckpointPages)
+    };
+
+    for (const auto& pragma : pragmas) {
+        if (!query.exec(pragma)) {
+            qWarning() << "[DB]" << pragma << "failed:" << query.lastError().text();
+        }
+    }
+
+    // Read the values back: SQLite may clamp some of them (mmap_size is capped at compile time)
+    const auto effective = [&query](const char* pragma) {
+        return query.exec(QString("PRAGMA %1;").arg(pragma)) && query.next() ? query.value(0).toString() : QString("?");
+    };
+
+    static constexpr const char* synchronousNames[] = { "OFF", "NORMAL", "FULL", "EXTRA" };
+    static constexpr const char* tempStoreNames[] = { "DEFAULT", "FILE", "MEMORY" };
+    const int synchronous = effective("synchronous").toInt();
+    const int tempStore = effective("temp_store").toInt();
+
+    return QString("Profile '%1' on %2: synchronous=%3 cache_size=%4 mmap_size=%5 temp_store=%6 busy_timeout=%7 "
+                   "wal_autocheckpoint=%8 journal_mode=%9 optimize_every=%10min")
+        .arg(profile.name, db.connectionName().isEmpty() ? QString("default") : db.connectionName())
+        .arg(synchronous >= 0 && synchronous < 4 ? synchronousNames[synchronous] : "?")
+        .arg(effective("cache_size"), effective("mmap_size"))
+        .arg(tempStore >= 0 && tempStore < 3 ? tempStoreNames[tempStore] : "?")
+        .arg(effective("busy_timeout"), effective("wal_autocheckpoint"), effective("journal_mode"))
+        .arg(profile.optimizeIntervalMinutes);
+}
+
+tl::expected<QSqlDatabase, QString> DBManager::openReader(const QString& connectionName, const QString& path,
+                                                          const DBPerformanceProfile& profile) {
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(path);
+    db.setConnectOptions("QSQLITE_OPEN_READONLY");
+
+    if (!db.open()) {
+        return tl::unexpected("[DB] Error opening read-only connection: " + db.lastError().text());
+    }
+
+    QSqlQuery query(db);
+    const QStringList pragmas {
+        "PRAGMA query_only = ON;",
+        QString("PRAGMA cache_size = -%1;").arg(profile.cacheSizeKiB),
+        QString("PRAGMA mmap_size = %1;").arg(profile.mmapSizeBytes),
+        QString("PRAGMA temp_store = %1;").arg(profile.tempStore),
+        QString("PRAGMA busy_timeout = %1;").arg(profile.busyTimeoutMs)
+    };
+
+    for (const auto& pragma : pragmas) {
+        if (!query.exec(pragma)) {
+            qWarning() << "[DB]" << pragma << "failed on" << connectionName << ":" << query.lastError().text();
+        }
+    }
+    return db;
+}
+
+void DBManager::optimize(const QSqlDatabase& db) {
+    QSqlQuery query(db);
+    if (!query.exec("PRAGMA optimize;")) {
+        qWarning() << "[DB] PRAGMA optimize failed:" << query.lastError().text();
+    }
+}
+
+bool DBManager::isTransientError(const QSqlError& error) {
+    bool ok = false;
+    const int code = error.nativeErrorCode().toInt(&ok);
+    if (!ok) {
+        return false;
+    }
+
+    // Extended result codes keep the primary code in the low byte
+    switch (code & 0xff) {
+    case 5:     // SQLITE_BUSY
+    case 6:     // SQLITE_LOCKED
+    case 10:    // SQLITE_IOERR
+        return true;
+    default:
+        return false;
+    }
+}
+
+DBManager::Statement::~Statement() {
+    if (!m_slot) {
+        return;
+    }
+    m_slot->query.finish();
+    m_slot->inUse = false;
+}
+
+QHash<QString, DBManager::StatementCache>& DBManager::statementCaches() {
+    // Qt connections may only be used from the thread that created them, so neither may their statements
+    thread_local QHash<QString, StatementCache> caches;
+    return caches;
+}
+
+DBManager::Statement DBManager::statement(const QSqlDatabase& db, const QString& sql) {
+    StatementCache& cache = statementCaches()[db.connectionName()];
+
+    if (const auto it = cache.constFind(sql); it != cache.cend() && !it.value()->inUse) {
+        it.value()->inUse = true;
+        return Statement(it.value());
+    }
+
+    auto slot = std::make_shared<Statement::Slot>(Statement::Slot { .query = QSqlQuery(db) });
+    slot->query.setForwardOnly(true);
+
+    // A statement that fails to prepare is handed out uncached so the caller sees the error on exec()
+    if (slot->query.prepare(sql) && !cache.contains(sql) && cache.size() < maxCachedStatements) {
+        slot->inUse = true;
+        cache.insert(sql, slot);
+    }
+
+    return Statement(slot);
+}
+
+void DBManager::releaseStatements(const QString& connectionName) {
+    statementCaches().remove(connectionName);
+}
+
+namespace {
+
+QString columnType(const QSqlDatabase& db, const QString& table, const QString& column) {
+    QSqlQuery query(db);
+    if (!query.exec(QString("PRAGMA table_info(%1)").arg(table))) {
+        return {};
+    }
+
+    while (query.next()) {
+        if (query.value(1).toString() == column) {
+            return query.value(2).toString().toUpper();
+        }
+    }
+    return {};
+}
+
+// Legacy rows hold Qt::ISODate text in local time; values that are already numeric are kept
+QVariant isoToEpochMs(const QVariant& value) {
+    if (value.isNull()) {
+        return {};
+    }
+
+    bool numeric = false;
+    const qint64 ms = value.toString().toLongLong(&numeric);
+    if (numeric) {
+        return ms;
+    }
+
+    return Utils::DateTimeUtils::toEpochMsOrNull(Utils::DateTimeUtils::fromStringOrDefault(value.toString()));
+}
+
+// createdAt was filled by SQLite's datetime('now'), which is UTC
+QVariant sqliteUtcToEpochMs(const QVariant& value) {
+    if (value.isNull()) {
+        return 0;
+    }
+
+    bool numeric = false;
+    const qint64 ms = value.toString().toLongLong(&numeric);
+    if (numeric) {
+        return ms;
+    }
+
+    QDateTime parsed = QDateTime::fromString(value.toString(), "yyyy-MM-dd HH:mm:ss");
+    if (!parsed.isValid()) {
+        return 0;
+    }
+    parsed.setTimeZone(QTimeZone::utc());
+    return parsed.toMSecsSinceEpoch();
+}
+
+tl::expected<void, QString> rebuildTrials(const QSqlDatabase& db) {
+    QSqlQuery query(db);
+
+    QString sql = R"(
+        CREATE TABLE trials_epoch (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            name TEXT NOT NULL UNIQUE,
+            scheduledDateTime INTEGER,
+            startDateTime INTEGER,
+            endDateTime INTEGER,
+            createdAt INTEGER NOT NULL DEFAULT (CAST(strftime('%s', 'now') AS INTEGER) * 1000)
+        );
+    )";
+
+    if (!query.exec(sql)) {
+        return tl::unexpected("[DB] Error creating trials_epoch: " + query.lastError().text());
+    }
+
+    QSqlQuery querySelect(db);
+    querySelect.setForwardOnly(true);
+    if (!querySelect.exec("SELECT id, name, scheduledDateTime, startDateTime, endDateTime, createdAt FROM trials")) {
+        return tl::unexpected("[DB] Error reading legacy trials: " + querySelect.lastError().text());
+    }
+
+    QSqlQuery queryInsert(db);
+    queryInsert.prepare(R"(
+        INSERT INTO trials_epoch(id, name, scheduledDateTime, startDateTime, endDateTime, createdAt)
+        VALUES(?, ?, ?, ?, ?, ?)
+    )");
+
+    while (querySelect.next()) {
+        queryInsert.addBindValue(querySelect.value(0));
+        queryInsert.addBindValue(querySelect.value(1));
+        queryInsert.addBindValue(isoToEpochMs(querySelect.value(2)));
+        queryInsert.addBindValue(isoToEpochMs(querySelect.value(3)));
+        queryInsert.addBindValue(isoToEpochMs(querySelect.value(4)));
+        queryInsert.addBindValue(sqliteUtcToEpochMs(querySelect.value(5)));
+
+        if (!queryInsert.exec()) {
+            return tl::unexpected("[DB] Error converting trial " + querySelect.value(0).toString() + ": " + queryInsert.lastError().text());
+        }
+    }
+
+    // The pending SELECT would keep the old table locked
+    querySelect.finish();
+
+    for (const auto& statement : {
+             QStringLiteral("DROP TABLE trials"),
+             QStringLiteral("ALTER TABLE trials_epoch RENAME TO trials") }) {
+        if (!query.exec(statement)) {
+            return tl::unexpected("[DB] Error replacing trials table: " + query.lastError().text());
+        }
+    }
+
+    return {};
+}
+
+tl::expected<void, QString> rebuildResults(const QSqlDatabase& db) {
+    QSqlQuery query(db);
+
+    QString sql = R"(
+        CREATE TABLE results_epoch (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            registrationId INTEGER NOT NULL,
+            startTime INTEGER NOT NULL,
+            endTime INTEGER,
+            durationMs INTEGER,
+            notes TEXT,
+            elapsedNs INTEGER,
+
+            FOREIGN KEY (registrationId)
+                REFERENCES registrations(id)
+                ON DELETE CASCADE
+        );
+    )";
+
+    if (!query.exec(sql)) {
+        return tl::unexpected("[DB] Error creating results_epoch: " + query.lastError().text());
+    }
+
+    QSqlQuery querySelect(db);
+    querySelect.setForwardOnly(true);
+    if (!querySelect.exec("SELECT id, registrationId, startTime, endTime, durationMs, notes, elapsedNs FROM results")) {
+        return tl::unexpected("[DB] Error reading legacy results: " + querySelect.lastError().text());
+    }
+
+    QSqlQuery queryInsert(db);
+    queryInsert.prepare(R"(
+        INSERT INTO results_epoch(id, registrationId, startTime, endTime, durationMs, notes, elapsedNs)
+        VALUES(?, ?, ?, ?, ?, ?, ?)
+    )");
+
+    while (querySelect.next()) {
+        const QVariant startTime = isoToEpochMs(querySelect.value(2));
+
+        queryInsert.addBindValue(querySelect.value(0));
+        queryInsert.addBindValue(querySelect.value(1));
+        queryInsert.addBindValue(startTime.isNull() ? QVariant(0) : startTime);
+        queryInsert.addBindValue(isoToEpochMs(querySelect.value(3)));
+        queryInsert.addBindValue(querySelect.value(4));
+        queryInsert.addBindValue(querySelect.value(5));
+        queryInsert.addBindValue(querySelect.value(6));
+
+        if (!queryInsert.exec()) {
+            return tl::unexpected("[DB] Error converting result " + querySelect.value(0).toString() + ": " + queryInsert.lastError().text());
+        }
+    }
+
+    // The pending SELECT would keep the old table locked
+    querySelect.finish();
+
+    for (const auto& statement : {
+             QStringLiteral("DROP TABLE results"),
+             QStringLiteral("ALTER TABLE results_epoch RENAME TO results"),
+             QStringLiteral("CREATE INDEX IF NOT EXISTS idx_results_registration ON results(registrationId)") }) {
+        if (!query.exec(statement)) {
+            return tl::unexpected("[DB] Error replacing results table: " + query.lastError().text());
+        }
+    }
+
+    return {};
+}
+
+tl::expected<void, QString> execAll(const QSqlDatabase& db, const QStringList& statements) {
+    QSqlQuery query(db);
+    for (const auto& statement : statements) {
+        if (!query.exec(statement)) {
+            return tl::unexpected(query.lastError().text());
+        }
+    }
+    return {};
+}
+
+// v1: tables as they existed before the schema was versioned (ISO-8601 TEXT timestamps)
+tl::expected<void, QString> createBaselineSchema(const QSqlDatabase& db) {
+    return execAll(db, {
+        R"(
+            CREATE TABLE IF NOT EXISTS athletes (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                name TEXT NOT NULL
+            );
+        )",
+        R"(
+            CREATE TABLE IF NOT EXISTS categories (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                name TEXT NOT NULL UNIQUE
+            );
+        )",
+        R"(
+            CREATE TABLE IF NOT EXISTS modalities (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                name TEXT NOT NULL UNIQUE
+            );
+        )",
+        R"(
+            CREATE TABLE IF NOT EXISTS trials (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                name TEXT NOT NULL UNIQUE,
+                scheduledDateTime TEXT,
+                startDateTime TEXT,
+                endDateTime TEXT,
+                createdAt TEXT NOT NULL DEFAULT (datetime('now'))
+            );
+        )",
+        R"(
+            CREATE TABLE IF NOT EXISTS registrations (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                trialId INTEGER NOT NULL,
+                athleteId INTEGER NOT NULL,
+                plateCode TEXT NOT NULL,
+                modalityId INTEGER,
+                categoryId INTEGER,
+
+                FOREIGN KEY (trialId) REFERENCES trials(id) ON DELETE CASCADE,
+                FOREIGN KEY (athleteId) REFERENCES athletes(id),
+                FOREIGN KEY (modalityId) REFERENCES modalities(id),
+                FOREIGN KEY (categoryId) REFERENCES categories(id),
+
+                UNIQUE (trialId, plateCode)
+            );
+        )",
+        "CREATE INDEX IF NOT EXISTS idx_registrations_trial ON registrations(trialId)",
+        R"(
+            CREATE TABLE IF NOT EXISTS results (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                registrationId INTEGER NOT NULL,
+                startTime TEXT NOT NULL,
+                endTime TEXT,
+                durationMs INTEGER,
+                notes TEXT,
+
+                FOREIGN KEY (registrationId)
+                    REFERENCES registrations(id)
+                    ON DELETE CASCADE
+            );
+        )",
+        "CREATE INDEX IF NOT EXISTS idx_results_registration ON results(registrationId)"
+    });
+}
+
+// v2: monotonic capture time of each result
+tl::expected<void, QString> addResultsElapsedNs(const QSqlDatabase& db) {
+    if (!columnType(db, "results", "elapsedNs").isEmpty()) {
+        return {};
+    }
+    return execAll(db, { "ALTER TABLE results ADD COLUMN elapsedNs INTEGER" });
+}
+
+// v3: ISO-8601 TEXT timestamps become INTEGER epoch milliseconds
+tl::expected<void, QString> convertTimestampsToEpochMs(const QSqlDatabase& db) {
+    if (columnType(db, "trials", "scheduledDateTime") == "TEXT") {
+        if (auto rebuilt = rebuildTrials(db); !rebuilt) {
+            return rebuilt;
+        }
+    }
+    if (columnType(db, "results", "startTime") == "TEXT") {
+        if (auto rebuilt = rebuildResults(db); !rebuilt) {
+            return rebuilt;
+        }
+    }
+    return {};
+}
+
+// v4: indexes for the day lookup of trials and the latest result per registration
+tl::expected<void, QString> createTimestampIndexes(const QSqlDatabase& db) {
+    return execAll(db, {
+        "CREATE INDEX IF NOT EXISTS idx_trials_scheduled ON trials(scheduledDateTime)",
+        "CREATE INDEX IF NOT EXISTS idx_results_registration_end ON results(registrationId, endTime)"
+    });
+}
+
+// v5: name lookup used when matching imported athletes against existing ones
+tl::expected<void, QString> createAthleteNameIndex(const QSqlDatabase& db) {
+    return execAll(db, {
+        "CREATE INDEX IF NOT EXISTS idx_athletes_name ON athletes(name)"
+    });
+}
+
+// v6: capture stations tag their events; replays of the same event must not create a second result
+tl::expected<void, QString> addResultsEventId(const QSqlDatabase& db) {
+    if (columnType(db, "results", "eventId").isEmpty()) {
+        if (auto added = execAll(db, { "ALTER TABLE results ADD COLUMN eventId TEXT" }); !added) {
+            return added;
+        }
+    }
+    return execAll(db, {
+        "CREATE UNIQUE INDEX IF NOT EXISTS idx_results_event ON results(eventId) WHERE eventId IS NOT NULL"
+    });
+}
+
+// v7: intermediate timing. Crossings are append-heavy and read per checkpoint in time order,
+// so they are clustered on (checkpointId, elapsedMs) without a rowid; the registration index
+// serves the per-athlete splits.
+tl::expected<void, QString> createCheckpointTables(const QSqlDatabase& db) {
+    return execAll(db, {
+        R"(
+            CREATE TABLE IF NOT EXISTS checkpoints (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                trialId INTEGER NOT NULL,
+                code TEXT NOT NULL,
+                name TEXT,
+                sequence INTEGER NOT NULL,
+                distanceM INTEGER,
+
+                FOREIGN KEY (trialId) REFERENCES trials(id) ON DELETE CASCADE,
+                UNIQUE (trialId, code)
+            )
+        )",
+        "CREATE INDEX IF NOT EXISTS idx_checkpoints_trial ON checkpoints(trialId, sequence)",
+        R"(
+            CREATE TABLE IF NOT EXISTS crossings (
+                checkpointId INTEGER NOT NULL,
+                elapsedMs INTEGER NOT NULL,
+                registrationId INTEGER NOT NULL,
+                capturedAt INTEGER,
+                eventId TEXT,
+
+                PRIMARY KEY (checkpointId, elapsedMs, registrationId),
+                FOREIGN KEY (checkpointId) REFERENCES checkpoints(id) ON DELETE CASCADE,
+                FOREIGN KEY (registrationId) REFERENCES registrations(id) ON DELETE CASCADE
+            ) WITHOUT ROWID
+        )",
+        "CREATE INDEX IF NOT EXISTS idx_crossings_registration ON crossings(registrationId, checkpointId, elapsedMs)",
+        "CREATE UNIQUE INDEX IF NOT EXISTS idx_crossings_event ON crossings(eventId) WHERE eventId IS NOT NULL"
+    });
+}
+
+// v8: wave and individual starts. A registration's start offset is its own startOffsetMs,
+// else its wave's, else 0 (the trial start).
+tl::expected<void, QString> createWaveTables(const QSqlDatabase& db) {
+    if (auto created = execAll(db, {
+            R"(
+                CREATE TABLE IF NOT EXISTS waves (
+                    id INTEGER PRIMARY KEY AUTOINCREMENT,
+                    trialId INTEGER NOT NULL,
+                    name TEXT NOT NULL,
+                    startOffsetMs INTEGER,
+
+                    FOREIGN KEY (trialId) REFERENCES trials(id) ON DELETE CASCADE,
+                    UNIQUE (trialId, name)
+                )
+            )"
+        }); !created) {
+        return created;
+    }
+    if (columnType(db, "registrations", "waveId").isEmpty()) {
+        if (auto added = execAll(db, { "ALTER TABLE registrations ADD COLUMN waveId INTEGER REFERENCES waves(id) ON DELETE SET NULL" }); !added) {
+            return added;
+        }
+    }
+    if (columnType(db, "registrations", "startOffsetMs").isEmpty()) {
+        if (auto added = execAll(db, { "ALTER TABLE registrations ADD COLUMN startOffsetMs INTEGER" }); !added) {
+            return added;
+        }
+    }
+    return execAll(db, {
+        "CREATE INDEX IF NOT EXISTS idx_registrations_wave ON registrations(waveId)"
+    });
+}
+
+struct MigrationStep {
+    int version;
+    const char* description;
+    tl::expected<void, QString> (*apply)(const QSqlDatabase& db);
+};
+
+// Append new steps at the end; a step must never be edited once released.
+// Every step is idempotent, so databases created before versioning (user_version 0) replay them safely.
+const std::array<MigrationStep, 8> migrationSteps {{
+    { 1, "baseline tables", createBaselineSchema },
+    { 2, "results.elapsedNs", addResultsElapsedNs },
+    { 3, "epoch-ms timestamps", convertTimestampsToEpochMs },
+    { 4, "timestamp indexes", createTimestampIndexes },
+    { 5, "athletes name index", createAthleteNameIndex },
+    { 6, "results.eventId", addResultsEventId },
+    { 7, "checkpoints and crossings", createCheckpointTables },
+    { 8, "waves and start offsets", createWaveTables },
+}};
+
+};
+
+int DBManager::latestSchemaVersion() {
+    return migrationSteps.back().version;
 }
 
+tl::expected<int, QString> DBManager::migrate(QSqlDatabase db) {
+    QSqlQuery query(db);
+    if (!query.exec("PRAGMA user_version;") || !query.next()) {
+        return tl::unexpected("[DB] Error reading schema version: " + query.lastError().text());
+    }
 
+    const int currentVersion = query.value(0).toInt();
+    query.finish();
 
+    if (currentVersion > latestSchemaVersion()) {
+        return tl::unexpected(QString("[DB] Database schema version %1 is newer than this build supports (%2)")
+                                  .arg(currentVersion).arg(latestSchemaVersion()));
+    }
+    if (currentVersion == latestSchemaVersion()) {
+        return currentVersion;
+    }
 
+    // Table rebuilds drop parent tables; with enforcement on that would cascade into child rows.
+    // The pragma is a no-op inside a transaction, so it is switched around the whole run.
+    query.exec("PRAGMA foreign_keys = OFF;");
 
+    int version = currentVersion;
+    for (const auto& step : migrationSteps) {
+        if (step.version <= version) {
+            continue;
+        }
+
+        if (!db.transaction()) {
+            query.exec("PRAGMA foreign_keys = ON;");
+            return tl::unexpected("[DB] Error starting migration " + QString::number(step.version) + ": " + db.lastError().text());
+        }
+
+        auto applied = step.apply(db);
+        if (applied && !query.exec(QString("PRAGMA user_version = %1;").arg(step.version))) {
+            applied = tl::unexpected(query.lastError().text());
+        }
+        if (applied && !db.commit()) {
+            applied = tl::unexpected(db.lastError().text());
+        }
+
+        if (!applied) {
+            db.rollback();
+            query.exec("PRAGMA foreign_keys = ON;");
+            return tl::unexpected(QString("[DB] Migration %1 (%2) failed: %3")
+                                      .arg(step.version).arg(QString::fromLatin1(step.description), applied.error()));
+        }
+
+        qDebug() << "[DB] Applied migration" << step.version << "-" << step.description;
+        version = step.version;
+    }
+
+    if (query.exec("PRAGMA foreign_key_check;") && query.next()) {
+        qWarning() << "[DB] Foreign key violations found after migration, first in table" << query.value(0).toString();
+    }
+    query.finish();
+    query.exec("PRAGMA foreign_keys = ON;");
+
+    qDebug() << "[DB] Schema version" << currentVersion << "->" << version;
+    return version;
+}
+
+tl::expected<int, QString> DBManager::migrateDatabaseFile(const QString& path) {
+    if (!QFileInfo::exists(path)) {
+        return tl::unexpected("[DB] Database file not found: " + path);
+    }
+
+    const QString connectionName = "migration-" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+    tl::expected<int, QString> outcome;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        db.setDatabaseName(path);
+
+        if (db.open()) {
+            outcome = migrate(db);
+            db.close();
+        } else {
+            outcome = tl::unexpected("[DB] Could not open " + path + ": " + db.lastError().text());
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    return outcome;
+}
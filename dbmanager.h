@@ -2,11 +2,63 @@
 #define DBMANAGER_H
 
 #include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QHash>
+#include <memory>
+#include <tl/expected.hpp>
+
+class QSettings;
+class QSqlError;
+
+// Per-connection SQLite tuning. Presets cover the common cases and every value
+// can be overridden from the [Performance] group of settings.ini.
+struct DBPerformanceProfile {
+    QString name = "race-day";
+    QString synchronous = "FULL";       // OFF | NORMAL | FULL | EXTRA
+    int cacheSizeKiB = 16384;
+    qint64 mmapSizeBytes = 64ll * 1024 * 1024;
+    QString tempStore = "MEMORY";       // DEFAULT | FILE | MEMORY
+    int busyTimeoutMs = 5000;
+    int walAutocheckpointPages = 1000;
+    int optimizeIntervalMinutes = 30;   // 0 disables the periodic PRAGMA optimize
+
+    // "race-day" (durable, default) or "bulk-import" (fast); unknown names fall back to race-day
+    static DBPerformanceProfile preset(const QString& name);
+    static DBPerformanceProfile fromSettings(QSettings& settings);
+};
 
 class DBManager
 {
 public:
-    explicit DBManager(const QString& path);
+    // Prepared statement borrowed from the per-connection cache.
+    // The query is finish()ed and handed back to the cache when the handle goes out of scope.
+    class Statement
+    {
+    public:
+        Statement(Statement&&) noexcept = default;
+        Statement& operator=(Statement&&) = delete;
+        Statement(const Statement&) = delete;
+        Statement& operator=(const Statement&) = delete;
+        ~Statement();
+
+        QSqlQuery* operator->() const { return &m_slot->query; }
+        QSqlQuery& operator*() const { return m_slot->query; }
+
+    private:
+        friend class DBManager;
+
+        struct Slot {
+            QSqlQuery query;
+            bool inUse = false;
+        };
+
+        explicit Statement(std::shared_ptr<Slot> slot) : m_slot(std::move(slot)) {}
+
+        std::shared_ptr<Slot> m_slot;
+    };
+
+    explicit DBManager(const QString& path, const DBPerformanceProfile& profile = DBPerformanceProfile());
     ~DBManager();
 
     [[nodiscard]] bool isOpen() const;
@@ -17,8 +69,49 @@ public:
         return QSqlDatabase::database();
     }
 
+    [[nodiscard]] const DBPerformanceProfile& profile() const { return m_profile; }
+
+    // Applies the connection-level pragmas (foreign keys + profile); they are lost whenever a connection is reopened.
+    // Returns the effective values as reported back by SQLite.
+    static QString applyConnectionPragmas(const QSqlDatabase& db, const DBPerformanceProfile& profile);
+
+    // Opens a read-only connection tuned for long scans (the writers own journal_mode and synchronous).
+    // The caller closes it and calls QSqlDatabase::removeDatabase once every handle is gone.
+    static tl::expected<QSqlDatabase, QString> openReader(const QString& connectionName, const QString& path,
+                                                          const DBPerformanceProfile& profile);
+
+    // Lets SQLite refresh planner statistics for tables whose usage changed
+    static void optimize(const QSqlDatabase& db);
+
+    // True for SQLite errors that may succeed when retried (busy, locked, I/O); constraint
+    // violations and the like fail the same way every time
+    [[nodiscard]] static bool isTransientError(const QSqlError& error);
+
+    // Applies the pending schema migrations (tracked in PRAGMA user_version) in order,
+    // each one in its own transaction. Returns the schema version the database ended on.
+    static tl::expected<int, QString> migrate(QSqlDatabase db);
+
+    // Runs migrate() on a database file through a private connection
+    static tl::expected<int, QString> migrateDatabaseFile(const QString& path);
+
+    [[nodiscard]] static int latestSchemaVersion();
+
+    // Returns the cached prepared statement for this SQL text on the connection, preparing it on first use.
+    // If the cached statement is already borrowed a fresh uncached one is handed out instead.
+    // Like the connection itself, the cache belongs to the thread that uses the connection.
+    [[nodiscard]] static Statement statement(const QSqlDatabase& db, const QString& sql);
+
+    // Drops the cached statements of a connection; call before closing or removing it
+    static void releaseStatements(const QString& connectionName);
+
 private:
+    static constexpr int maxCachedStatements = 128;
+
     QSqlDatabase m_db;
+    DBPerformanceProfile m_profile;
+
+    using StatementCache = QHash<QString, std::shared_ptr<Statement::Slot>>;
+    static QHash<QString, StatementCache>& statementCaches();
 
     void init() const;
     [[nodiscard]] bool isValid() const;
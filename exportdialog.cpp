@@ -0,0 +1,237 @@
+#include "exportdialog.h"
+#include "repository/trials/trialsrepository.h"
+#include <QCloseEvent>
+#include <QDir>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QMessageBox>
+#include <QDebug>
+
+ExportDialog::ExportDialog(const QString& databasePath, const DBPerformanceProfile& profile, const int currentTrialId,
+                           const QString& defaultOutputDir, QWidget *parent)
+    : QDialog(parent)
+    , m_engine(new ExportEngine(databasePath, profile, this))
+    , m_mainLayout(nullptr)
+    , m_trialList(nullptr)
+    , m_xlsxCheck(nullptr)
+    , m_csvCheck(nullptr)
+    , m_jsonCheck(nullptr)
+    , m_outputDirEdit(nullptr)
+    , m_progressBar(nullptr)
+    , m_statusLabel(nullptr)
+    , m_log(nullptr)
+    , m_exportButton(nullptr)
+    , m_cancelButton(nullptr)
+    , m_closeButton(nullptr)
+{
+    setupUI(defaultOutputDir);
+    loadTrials(currentTrialId);
+
+    connect(m_engine, &ExportEngine::fileWritten, this, &ExportDialog::onFileWritten);
+    connect(m_engine, &ExportEngine::fileFailed, this, &ExportDialog::onFileFailed);
+    connect(m_engine, &ExportEngine::progressChanged, this, &ExportDialog::onProgressChanged);
+    connect(m_engine, &ExportEngine::exportFinished, this, &ExportDialog::onExportFinished);
+}
+
+ExportDialog::~ExportDialog()
+= default;
+
+void ExportDialog::setupUI(const QString& defaultOutputDir)
+{
+    setWindowTitle("Exportar relatórios");
+    setModal(false);
+    resize(600, 560);
+
+    m_mainLayout = new QVBoxLayout(this);
+
+    // Trials
+    auto* trialsGroup = new QGroupBox("Provas");
+    auto* trialsLayout = new QVBoxLayout(trialsGroup);
+    m_trialList = new QListWidget();
+    trialsLayout->addWidget(m_trialList);
+    auto* selectAllButton = new QPushButton("Selecionar todas");
+    connect(selectAllButton, &QPushButton::clicked, this, &ExportDialog::onSelectAllClicked);
+    trialsLayout->addWidget(selectAllButton, 0, Qt::AlignLeft);
+    m_mainLayout->addWidget(trialsGroup, 1);
+
+    // Formats
+    auto* formatsGroup = new QGroupBox("Formatos");
+    auto* formatsLayout = new QHBoxLayout(formatsGroup);
+    m_xlsxCheck = new QCheckBox(Reports::formatName(Reports::Format::Xlsx));
+    m_xlsxCheck->setChecked(true);
+    m_csvCheck = new QCheckBox(Reports::formatName(Reports::Format::Csv));
+    m_jsonCheck = new QCheckBox(Reports::formatName(Reports::Format::Json));
+    formatsLayout->addWidget(m_xlsxCheck);
+    formatsLayout->addWidget(m_csvCheck);
+    formatsLayout->addWidget(m_jsonCheck);
+    formatsLayout->addStretch();
+    m_mainLayout->addWidget(formatsGroup);
+
+    // Output directory
+    auto* outputLayout = new QHBoxLayout();
+    outputLayout->addWidget(new QLabel("Pasta de destino:"));
+    m_outputDirEdit = new QLineEdit(defaultOutputDir);
+    outputLayout->addWidget(m_outputDirEdit, 1);
+    auto* browseButton = new QPushButton("...");
+    connect(browseButton, &QPushButton::clicked, this, &ExportDialog::onBrowseClicked);
+    outputLayout->addWidget(browseButton);
+    m_mainLayout->addLayout(outputLayout);
+
+    // Progress
+    m_progressBar = new QProgressBar();
+    m_progressBar->setRange(0, 1);
+    m_progressBar->setValue(0);
+    m_mainLayout->addWidget(m_progressBar);
+
+    m_statusLabel = new QLabel();
+    m_statusLabel->setStyleSheet("color: #666;");
+    m_mainLayout->addWidget(m_statusLabel);
+
+    m_log = new QPlainTextEdit();
+    m_log->setReadOnly(true);
+    m_log->setMaximumBlockCount(1000);
+    m_mainLayout->addWidget(m_log, 1);
+
+    // Buttons
+    auto* buttonLayout = new QHBoxLayout();
+    buttonLayout->addStretch();
+    m_exportButton = new QPushButton("Exportar");
+    m_cancelButton = new QPushButton("Cancelar");
+    m_closeButton = new QPushButton("Fechar");
+    connect(m_exportButton, &QPushButton::clicked, this, &ExportDialog::onExportClicked);
+    connect(m_cancelButton, &QPushButton::clicked, m_engine, &ExportEngine::cancel);
+    connect(m_closeButton, &QPushButton::clicked, this, &QDialog::close);
+    buttonLayout->addWidget(m_exportButton);
+    buttonLayout->addWidget(m_cancelButton);
+    buttonLayout->addWidget(m_closeButton);
+    m_mainLayout->addLayout(buttonLayout);
+
+    setLayout(m_mainLayout);
+    setRunning(false);
+}
+
+void ExportDialog::loadTrials(const int currentTrialId)
+{
+    const Trials::Repository trialsRepo(DBManager::database());
+    auto trials = trialsRepo.getAllTrials();
+    if (!trials.has_value()) {
+        qWarning() << "Error loading trials for export:" << trials.error();
+        m_statusLabel->setText("Erro ao carregar as provas: " + trials.error());
+        return;
+    }
+
+    for (const auto& trial : trials.value()) {
+        auto* item = new QListWidgetItem(QString("%1 (%2)").arg(trial.name, trial.scheduledDateTime.toString("dd/MM/yyyy hh:mm")));
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(trial.id == currentTrialId ? Qt::Checked : Qt::Unchecked);
+        item->setData(Qt::UserRole, trial.id);
+        item->setData(Qt::UserRole + 1, trial.name);
+        m_trialList->addItem(item);
+    }
+}
+
+void ExportDialog::setRunning(const bool running)
+{
+    m_exportButton->setEnabled(!running);
+    m_cancelButton->setEnabled(running);
+    m_trialList->setEnabled(!running);
+    m_xlsxCheck->setEnabled(!running);
+    m_csvCheck->setEnabled(!running);
+    m_jsonCheck->setEnabled(!running);
+    m_outputDirEdit->setEnabled(!running);
+}
+
+void ExportDialog::onBrowseClicked()
+{
+    const QString dir = QFileDialog::getExistingDirectory(this, "Pasta de destino", m_outputDirEdit->text());
+    if (!dir.isEmpty()) {
+        m_outputDirEdit->setText(dir);
+    }
+}
+
+void ExportDialog::onSelectAllClicked()
+{
+    // Toggles: checks everything unless everything is already checked
+    bool allChecked = true;
+    for (int i = 0; i < m_trialList->count() && allChecked; ++i) {
+        allChecked = m_trialList->item(i)->checkState() == Qt::Checked;
+    }
+    for (int i = 0; i < m_trialList->count(); ++i) {
+        m_trialList->item(i)->setCheckState(allChecked ? Qt::Unchecked : Qt::Checked);
+    }
+}
+
+void ExportDialog::onExportClicked()
+{
+    QVector<ExportEngine::Trial> trials;
+    for (int i = 0; i < m_trialList->count(); ++i) {
+        const QListWidgetItem* item = m_trialList->item(i);
+        if (item->checkState() == Qt::Checked) {
+            trials.append({ .id = item->data(Qt::UserRole).toInt(), .name = item->data(Qt::UserRole + 1).toString() });
+        }
+    }
+
+    QVector<Reports::Format> formats;
+    if (m_xlsxCheck->isChecked()) formats.append(Reports::Format::Xlsx);
+    if (m_csvCheck->isChecked()) formats.append(Reports::Format::Csv);
+    if (m_jsonCheck->isChecked()) formats.append(Reports::Format::Json);
+
+    if (trials.isEmpty() || formats.isEmpty()) {
+        QMessageBox::warning(this, "Exportar relatórios", "Selecione ao menos uma prova e um formato.");
+        return;
+    }
+
+    if (m_prepareHook && !m_prepareHook()) {
+        return;
+    }
+
+    m_log->clear();
+    if (auto started = m_engine->start(trials, formats, m_outputDirEdit->text()); !started) {
+        QMessageBox::warning(this, "Exportar relatórios", started.error());
+        return;
+    }
+    setRunning(true);
+}
+
+void ExportDialog::onFileWritten(const QString& fileName, const qint64 rowsWritten)
+{
+    m_log->appendPlainText(QString("✓ %1 (%2 linha(s))").arg(QFileInfo(fileName).fileName()).arg(rowsWritten));
+}
+
+void ExportDialog::onFileFailed(const QString& fileName, const QString& error)
+{
+    qWarning() << "Export of" << fileName << "failed:" << error;
+    m_log->appendPlainText(QString("✗ %1: %2").arg(QFileInfo(fileName).fileName(), error));
+}
+
+void ExportDialog::onProgressChanged(const int filesDone, const int filesTotal)
+{
+    m_progressBar->setRange(0, filesTotal);
+    m_progressBar->setValue(filesDone);
+    m_statusLabel->setText(QString("%1 de %2 arquivo(s)").arg(filesDone).arg(filesTotal));
+}
+
+void ExportDialog::onExportFinished(const int filesWritten, const int filesFailed, const bool cancelled)
+{
+    setRunning(false);
+
+    QString status = QString("%1 arquivo(s) gerado(s)").arg(filesWritten);
+    if (filesFailed > 0) {
+        status += QString(", %1 com erro").arg(filesFailed);
+    }
+    if (cancelled) {
+        status += " - exportação cancelada";
+    }
+    m_statusLabel->setText(status);
+}
+
+void ExportDialog::closeEvent(QCloseEvent* event)
+{
+    // The engine waits for its tasks when destroyed; cancelling makes that quick
+    if (m_engine->isRunning()) {
+        m_engine->cancel();
+    }
+    QDialog::closeEvent(event);
+}
@@ -0,0 +1,67 @@
+#ifndef EXPORTDIALOG_H
+#define EXPORTDIALOG_H
+
+#include <QDialog>
+#include <QCheckBox>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QPlainTextEdit>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include "dbmanager.h"
+#include "exportengine.h"
+#include <functional>
+
+// Batch export of several trials to several formats at once (XLSX, CSV, JSON).
+// The work runs on the ExportEngine pool; the dialog only shows progress and can cancel it.
+class ExportDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    ExportDialog(const QString& databasePath, const DBPerformanceProfile& profile, int currentTrialId,
+                 const QString& defaultOutputDir, QWidget *parent = nullptr);
+    ~ExportDialog() override;
+
+    // Called right before the export starts, so pending writes can be flushed; returning false cancels it
+    using PrepareHook = std::function<bool()>;
+    void setPrepareHook(PrepareHook hook) { m_prepareHook = std::move(hook); }
+
+protected:
+    void closeEvent(QCloseEvent* event) override;
+
+private slots:
+    void onBrowseClicked();
+    void onSelectAllClicked();
+    void onExportClicked();
+    void onFileWritten(const QString& fileName, qint64 rowsWritten);
+    void onFileFailed(const QString& fileName, const QString& error);
+    void onProgressChanged(int filesDone, int filesTotal);
+    void onExportFinished(int filesWritten, int filesFailed, bool cancelled);
+
+private:
+    ExportEngine* m_engine;
+    PrepareHook m_prepareHook;
+
+    // UI Components
+    QVBoxLayout* m_mainLayout;
+    QListWidget* m_trialList;
+    QCheckBox* m_xlsxCheck;
+    QCheckBox* m_csvCheck;
+    QCheckBox* m_jsonCheck;
+    QLineEdit* m_outputDirEdit;
+    QProgressBar* m_progressBar;
+    QLabel* m_statusLabel;
+    QPlainTextEdit* m_log;
+    QPushButton* m_exportButton;
+    QPushButton* m_cancelButton;
+    QPushButton* m_closeButton;
+
+    void setupUI(const QString& defaultOutputDir);
+    void loadTrials(int currentTrialId);
+    void setRunning(bool running);
+};
+
+#endif // EXPORTDIALOG_H
@@ -0,0 +1,187 @@
+#include "exportengine.h"
+#include <QDate>
+#include <QThread>
+#include <QDir>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSqlError>
+#include <QUuid>
+#include <QDebug>
+#include <algorithm>
+
+ExportEngine::ExportEngine(const QString& databasePath, const DBPerformanceProfile& profile, QObject* parent)
+    : QObject(parent)
+    , m_databasePath(databasePath)
+    , m_profile(profile) {
+    m_pool.setMaxThreadCount(std::max(2, QThread::idealThreadCount()));
+}
+
+ExportEngine::~ExportEngine() {
+    cancel();
+    m_pool.waitForDone();
+}
+
+tl::expected<void, QString> ExportEngine::start(const QVector<Trial>& trials, const QVector<Reports::Format>& formats,
+                                                const QString& outputDir) {
+    if (isRunning()) {
+        return tl::unexpected(QString("[EE] An export is already running"));
+    }
+    if (trials.isEmpty() || formats.isEmpty()) {
+        return tl::unexpected(QString("[EE] Nothing to export"));
+    }
+    if (!QDir().mkpath(outputDir)) {
+        return tl::unexpected("[EE] Could not create " + outputDir);
+    }
+
+    m_outputDir = outputDir;
+    m_formats = formats;
+    m_filesTotal = static_cast<int>(trials.size() * formats.size());
+    m_filesDone.store(0, std::memory_order_release);
+    m_filesWritten.store(0, std::memory_order_relaxed);
+    m_filesFailed.store(0, std::memory_order_relaxed);
+    m_cancelled.store(false, std::memory_order_relaxed);
+
+    qInfo() << "[EE] Exporting" << trials.size() << "trial(s) to" << formats.size() << "format(s) with"
+            << m_pool.maxThreadCount() << "thread(s)";
+
+    emit progressChanged(0, m_filesTotal);
+    for (const auto& trial : trials) {
+        m_pool.start([this, trial]() { readTrial(trial); });
+    }
+    return {};
+}
+
+void ExportEngine::cancel() {
+    m_cancelled.store(true, std::memory_order_relaxed);
+}
+
+QString ExportEngine::outputFileName(const Trial& trial, const Reports::Format format, const QString& outputDir) {
+    static const QRegularExpression invalid(R"([<>:"/\\|?*\x00-\x1F])");
+
+    QString name = trial.name;
+    name.replace(invalid, "_");
+    return QDir(outputDir).filePath(QString("report_%1_%2_%3.%4")
+        .arg(trial.id)
+        .arg(name.trimmed(), QDate::currentDate().toString("yyyy-MM-dd"), Reports::fileExtension(format)));
+}
+
+void ExportEngine::readTrial(const Trial& trial) {
+    if (m_cancelled.load(std::memory_order_relaxed)) {
+        for (int i = 0; i < m_formats.size(); ++i) {
+            fileDone(false);
+        }
+        return;
+    }
+
+    auto rows = std::make_shared<QVector<Report::Row>>();
+    QString error;
+
+    const QString connectionName = "export-" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+    {
+        auto opened = DBManager::openReader(connectionName, m_databasePath, m_profile);
+        if (opened.has_value()) {
+            QSqlDatabase& db = opened.value();
+            if (db.transaction()) {
+                auto scanned = Report::scanRows(trial.id, db, [this, &rows](const Report::Row& row) {
+                    rows->append(row);
+                    return rows->size() % Report::progressInterval != 0 || !m_cancelled.load(std::memory_order_relaxed);
+                });
+                if (!scanned) {
+                    error = scanned.error();
+                }
+                db.rollback();
+            } else {
+                error = "Error starting read transaction: " + db.lastError().text();
+            }
+            db.close();
+        } else {
+            error = opened.error();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    if (!error.isEmpty() || m_cancelled.load(std::memory_order_relaxed)) {
+        for (const auto format : std::as_const(m_formats)) {
+            if (!m_cancelled.load(std::memory_order_relaxed)) {
+                emit fileFailed(outputFileName(trial, format, m_outputDir), "[EE] " + error);
+            }
+            fileDone(false);
+        }
+        return;
+    }
+
+    // The formats of a trial are written in parallel from the same rows; this task takes the last one
+    const Rows shared = std::move(rows);
+    for (int i = 0; i + 1 < m_formats.size(); ++i) {
+        const Reports::Format format = m_formats[i];
+        m_pool.start([this, trial, format, shared]() { writeFile(trial, format, shared); });
+    }
+    writeFile(trial, m_formats.last(), shared);
+}
+
+void ExportEngine::writeFile(const Trial& trial, const Reports::Format format, const Rows& rows) {
+    const QString fileName = outputFileName(trial, format, m_outputDir);
+    if (m_cancelled.load(std::memory_order_relaxed)) {
+        fileDone(false);
+        return;
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        emit fileFailed(fileName, "[EE] " + file.errorString());
+        fileDone(false);
+        return;
+    }
+
+    const auto sink = Reports::RowSink::create(format, &file);
+    QString error;
+    for (const auto& row : *rows) {
+        if (auto written = sink->write(row); !written) {
+            error = written.error();
+            break;
+        }
+        if (sink->rowsWritten() % Report::progressInterval == 0 && m_cancelled.load(std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    if (error.isEmpty() && !m_cancelled.load(std::memory_order_relaxed)) {
+        if (auto finished = sink->finish(); !finished) {
+            error = finished.error();
+        }
+    }
+
+    if (m_cancelled.load(std::memory_order_relaxed)) {
+        file.cancelWriting();
+        fileDone(false);
+        return;
+    }
+
+    if (error.isEmpty() && !file.commit()) {
+        error = file.errorString();
+    }
+    if (!error.isEmpty()) {
+        file.cancelWriting();
+        emit fileFailed(fileName, "[EE] " + error);
+        fileDone(false);
+        return;
+    }
+
+    emit fileWritten(fileName, sink->rowsWritten());
+    fileDone(true);
+}
+
+void ExportEngine::fileDone(const bool written) {
+    if (written) {
+        m_filesWritten.fetch_add(1, std::memory_order_relaxed);
+    } else if (!m_cancelled.load(std::memory_order_relaxed)) {
+        m_filesFailed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const int done = m_filesDone.fetch_add(1, std::memory_order_acq_rel) + 1;
+    emit progressChanged(done, m_filesTotal);
+
+    if (done == m_filesTotal) {
+        emit exportFinished(m_filesWritten.load(std::memory_order_relaxed), m_filesFailed.load(std::memory_order_relaxed),
+                            m_cancelled.load(std::memory_order_relaxed));
+    }
+}
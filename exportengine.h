@@ -0,0 +1,68 @@
+#ifndef EXPORTENGINE_H
+#define EXPORTENGINE_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QVector>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include "dbmanager.h"
+#include "report.h"
+#include "reportsinks.h"
+
+// Exports several trials to several formats in parallel.
+// Every trial is read once, by a pool task with its own read-only connection, inside one
+// read transaction (one WAL snapshot). The rows are then shared, read-only, by one writer
+// task per output format, so all the files of a trial describe the same data.
+class ExportEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Trial {
+        int id = 0;
+        QString name;
+    };
+
+    ExportEngine(const QString& databasePath, const DBPerformanceProfile& profile, QObject* parent = nullptr);
+    // Cancels and waits for the running tasks
+    ~ExportEngine() override;
+
+    // Files are named report_<trialId>_<trialName>_<date>.<extension> inside outputDir
+    [[nodiscard]] tl::expected<void, QString> start(const QVector<Trial>& trials, const QVector<Reports::Format>& formats,
+                                                    const QString& outputDir);
+    void cancel();
+
+    [[nodiscard]] bool isRunning() const { return m_filesDone.load(std::memory_order_acquire) < m_filesTotal; }
+    [[nodiscard]] int filesTotal() const { return m_filesTotal; }
+
+    [[nodiscard]] static QString outputFileName(const Trial& trial, Reports::Format format, const QString& outputDir);
+
+signals:
+    void fileWritten(const QString& fileName, qint64 rowsWritten);
+    void fileFailed(const QString& fileName, const QString& error);
+    void progressChanged(int filesDone, int filesTotal);
+    void exportFinished(int filesWritten, int filesFailed, bool cancelled);
+
+private:
+    using Rows = std::shared_ptr<const QVector<Report::Row>>;
+
+    QString m_databasePath;
+    DBPerformanceProfile m_profile;
+    QThreadPool m_pool;
+
+    QString m_outputDir;
+    QVector<Reports::Format> m_formats;
+    int m_filesTotal = 0;
+    std::atomic<int> m_filesDone { 0 };
+    std::atomic<int> m_filesWritten { 0 };
+    std::atomic<int> m_filesFailed { 0 };
+    std::atomic<bool> m_cancelled { false };
+
+    void readTrial(const Trial& trial);
+    void writeFile(const Trial& trial, Reports::Format format, const Rows& rows);
+    void fileDone(bool written);
+};
+
+#endif // EXPORTENGINE_H
@@ -0,0 +1,186 @@
+#include "ingestserver.h"
+#include <QDebug>
+#include <QSet>
+
+Ingest::Server::Server(Handler handler, QObject* parent)
+    : QObject(parent)
+    , m_handler(std::move(handler)) {
+    connect(&m_server, &QLocalServer::newConnection, this, &Server::onNewConnection);
+}
+
+Ingest::Server::~Server() {
+    close();
+}
+
+tl::expected<void, QString> Ingest::Server::listen(const QString& name, const bool allowAllUsers) {
+    close();
+
+    // Stations can inject finishes, so only the user running the app may connect unless opened up in settings
+    m_server.setSocketOptions(allowAllUsers ? QLocalServer::WorldAccessOption : QLocalServer::UserAccessOption);
+    if (!m_server.listen(name)) {
+        // A crashed previous instance can leave a stale socket file behind
+        if (m_server.serverError() != QAbstractSocket::AddressInUseError || !QLocalServer::removeServer(name) || !m_server.listen(name)) {
+            return tl::unexpected("[IN] Could not listen on " + name + ": " + m_server.errorString());
+        }
+    }
+
+    qInfo() << "[IN] Listening for stations on" << m_server.fullServerName();
+    return {};
+}
+
+void Ingest::Server::close() {
+    if (!m_server.isListening()) {
+        return;
+    }
+
+    m_server.close();
+    for (auto* socket : m_server.findChildren<QLocalSocket*>()) {
+        socket->disconnectFromServer();
+    }
+}
+
+void Ingest::Server::onNewConnection() {
+    while (QLocalSocket* socket = m_server.nextPendingConnection()) {
+        ++m_stats.connections;
+        ++m_stats.activeConnections;
+
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { readEvents(socket); });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            --m_stats.activeConnections;
+            forget(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void Ingest::Server::readEvents(QLocalSocket* socket) {
+    QVector<StationEvent> events;
+    // One slot per line: the index of its event in `events`, or -1 and the parse error
+    QVector<int> lineEvents;
+    QStringList lineErrors;
+    QStringList lineIds;
+
+    while (socket->canReadLine()) {
+        const QByteArray line = socket->readLine().trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+        ++m_stats.received;
+
+        auto parsed = parseEvent(line);
+        if (parsed.has_value()) {
+            lineEvents.append(static_cast<int>(events.size()));
+            lineErrors.append(QString());
+            lineIds.append(parsed->eventId);
+            events.append(std::move(parsed.value()));
+        } else {
+            ++m_stats.malformed;
+            lineEvents.append(-1);
+            lineErrors.append(parsed.error());
+            lineIds.append(QString());
+        }
+    }
+
+    if (!socket->canReadLine() && socket->bytesAvailable() > maxLineBytes) {
+        qWarning() << "[IN] Dropping station connection: line longer than" << maxLineBytes << "bytes";
+        socket->abort();
+        return;
+    }
+
+    if (lineEvents.isEmpty()) {
+        return;
+    }
+
+    QStringList rejections = events.isEmpty() ? QStringList() : m_handler(events);
+    rejections.resize(events.size());
+
+    // Malformed lines and rejected events are settled now; accepted ones wait for storage
+    QVector<PendingAck>& pending = m_pendingAcks[socket];
+    int rejected = 0;
+    for (qsizetype i = 0; i < lineEvents.size(); ++i) {
+        const int eventIndex = lineEvents[i];
+        const QString error = eventIndex < 0 ? lineErrors[i] : rejections[eventIndex];
+        if (eventIndex >= 0 && error.isEmpty()) {
+            pending.append({ .ack = { .eventId = lineIds[i], .ok = true }, .settled = false });
+            m_awaitingStorage.insert(lineIds[i], socket);
+            continue;
+        }
+        if (eventIndex >= 0) {
+            ++rejected;
+        }
+        pending.append({ .ack = { .eventId = lineIds[i], .ok = false, .error = error }, .settled = true });
+    }
+    writeSettledAcks(socket);
+
+    if (rejected > 0) {
+        m_stats.rejected += rejected;
+        emit eventsProcessed(0, rejected);
+    }
+}
+
+void Ingest::Server::acknowledge(const QStringList& eventIds, const QString& error) {
+    QSet<QLocalSocket*> touched;
+    int accepted = 0;
+    int rejected = 0;
+
+    for (const auto& eventId : eventIds) {
+        // A station may resend an event before the first copy is stored; every copy is settled together
+        const QList<QLocalSocket*> waiting = m_awaitingStorage.values(eventId);
+        const QSet<QLocalSocket*> sockets(waiting.begin(), waiting.end());
+        m_awaitingStorage.remove(eventId);
+
+        for (QLocalSocket* socket : sockets) {
+            for (auto& pending : m_pendingAcks[socket]) {
+                if (pending.settled || pending.ack.eventId != eventId) {
+                    continue;
+                }
+                pending.settled = true;
+                pending.ack.ok = error.isEmpty();
+                pending.ack.error = error;
+                if (error.isEmpty()) {
+                    ++accepted;
+                } else {
+                    ++rejected;
+                }
+            }
+            touched.insert(socket);
+        }
+    }
+
+    for (QLocalSocket* socket : touched) {
+        writeSettledAcks(socket);
+    }
+
+    m_stats.accepted += accepted;
+    m_stats.rejected += rejected;
+    if (accepted > 0 || rejected > 0) {
+        emit eventsProcessed(accepted, rejected);
+    }
+}
+
+void Ingest::Server::writeSettledAcks(QLocalSocket* socket) {
+    auto it = m_pendingAcks.find(socket);
+    if (it == m_pendingAcks.end()) {
+        return;
+    }
+
+    QVector<PendingAck>& pending = it.value();
+    qsizetype settled = 0;
+    QByteArray acks;
+    while (settled < pending.size() && pending[settled].settled) {
+        acks += encodeAck(pending[settled].ack);
+        ++settled;
+    }
+    pending.remove(0, settled);
+
+    if (!acks.isEmpty()) {
+        socket->write(acks);
+    }
+}
+
+void Ingest::Server::forget(QLocalSocket* socket) {
+    m_pendingAcks.remove(socket);
+    for (auto it = m_awaitingStorage.begin(); it != m_awaitingStorage.end();) {
+        it = it.value() == socket ? m_awaitingStorage.erase(it) : std::next(it);
+    }
+}
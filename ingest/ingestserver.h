@@ -0,0 +1,84 @@
+#pragma once
+
+#include "stationevent.h"
+#include <QHash>
+#include <QMultiHash>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+#include <tl/expected.hpp>
+
+namespace Ingest {
+
+// Local endpoint (named pipe on Windows, Unix domain socket elsewhere) through which
+// capture stations send their events as NDJSON (see StationEvent).
+// Each read drains every complete line of a connection, so a burst reaches the handler
+// as one batch; every event line gets an ack line back, in order.
+// An accepted event is only acked once its owner reports it stored (acknowledge()), so a
+// station never forgets an event that could still be lost; events still waiting when the
+// connection closes are never acked and the station resends them.
+// The server lives on the thread that created it and never blocks it.
+class Server : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Returns one entry per event: empty when accepted for storage, otherwise the reason it was rejected
+    using Handler = std::function<QStringList(const QVector<StationEvent>& events)>;
+
+    struct Stats {
+        qint64 connections = 0;
+        qint64 activeConnections = 0;
+        qint64 received = 0;
+        qint64 accepted = 0;
+        qint64 rejected = 0;
+        qint64 malformed = 0;
+    };
+
+    explicit Server(Handler handler, QObject* parent = nullptr);
+    ~Server() override;
+
+    [[nodiscard]] tl::expected<void, QString> listen(const QString& name, bool allowAllUsers = false);
+    void close();
+
+    [[nodiscard]] bool isListening() const { return m_server.isListening(); }
+    [[nodiscard]] QString fullServerName() const { return m_server.fullServerName(); }
+    [[nodiscard]] Stats stats() const { return m_stats; }
+
+    // Settles accepted events: stored when error is empty, otherwise acked with ok:false so the station retries.
+    // Ids nobody is waiting for are ignored.
+    void acknowledge(const QStringList& eventIds, const QString& error = QString());
+
+signals:
+    void eventsProcessed(int accepted, int rejected);
+
+private slots:
+    void onNewConnection();
+
+private:
+    // A line longer than this cannot be an event; the connection is dropped
+    static constexpr qint64 maxLineBytes = 16 * 1024;
+
+    struct PendingAck {
+        Ack ack;
+        bool settled = false;
+    };
+
+    QLocalServer m_server;
+    Handler m_handler;
+    Stats m_stats;
+
+    // Per connection, in line order; acks leave only once every earlier line is settled
+    QHash<QLocalSocket*, QVector<PendingAck>> m_pendingAcks;
+    // Accepted event id -> connections waiting for it to be stored
+    QMultiHash<QString, QLocalSocket*> m_awaitingStorage;
+
+    void readEvents(QLocalSocket* socket);
+    void writeSettledAcks(QLocalSocket* socket);
+    void forget(QLocalSocket* socket);
+};
+
+};
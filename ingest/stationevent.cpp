@@ -0,0 +1,102 @@
+#include "stationevent.h"
+#include "utils/timeutils.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+
+namespace {
+
+QByteArray toLine(const QJsonObject& object) {
+    return QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+}
+
+tl::expected<QJsonObject, QString> toObject(const QByteArray& line) {
+    QJsonParseError error {};
+    const QJsonDocument document = QJsonDocument::fromJson(line, &error);
+    if (error.error != QJsonParseError::NoError) {
+        return tl::unexpected("[IN] Invalid JSON: " + error.errorString());
+    }
+    if (!document.isObject()) {
+        return tl::unexpected(QString("[IN] Expected a JSON object"));
+    }
+    return document.object();
+}
+
+};
+
+tl::expected<Ingest::StationEvent, QString> Ingest::parseEvent(const QByteArray& line) {
+    auto object = toObject(line);
+    if (!object) {
+        return tl::unexpected(object.error());
+    }
+
+    StationEvent event;
+    event.eventId = object->value("eventId").toString().trimmed();
+    event.stationId = object->value("station").toString().trimmed();
+    event.plateCode = object->value("plate").toString().trimmed();
+    event.checkpoint = object->value("checkpoint").toString().trimmed();
+
+    if (event.eventId.isEmpty()) {
+        return tl::unexpected(QString("[IN] Missing eventId"));
+    }
+    if (event.plateCode.isEmpty()) {
+        return tl::unexpected(QString("[IN] Missing plate"));
+    }
+
+    const QString type = object->value("type").toString("finish");
+    if (type == "finish") {
+        event.type = StationEvent::Finish;
+    } else if (type == "split") {
+        event.type = StationEvent::Split;
+        if (event.checkpoint.isEmpty()) {
+            return tl::unexpected(QString("[IN] Split without checkpoint"));
+        }
+    } else {
+        return tl::unexpected("[IN] Unknown event type: " + type);
+    }
+
+    const QJsonValue capturedAt = object->value("capturedAt");
+    if (!capturedAt.isDouble()) {
+        return tl::unexpected(QString("[IN] capturedAt must be epoch milliseconds"));
+    }
+    event.capturedAt = Utils::DateTimeUtils::fromEpochMs(static_cast<qint64>(capturedAt.toDouble()));
+
+    return event;
+}
+
+QByteArray Ingest::encodeEvent(const StationEvent& event) {
+    QJsonObject object {
+        { "eventId", event.eventId },
+        { "station", event.stationId },
+        { "type", event.type == StationEvent::Split ? "split" : "finish" },
+        { "plate", event.plateCode },
+        { "capturedAt", event.capturedAt.toMSecsSinceEpoch() }
+    };
+    if (event.type == StationEvent::Split) {
+        object.insert("checkpoint", event.checkpoint);
+    }
+    return toLine(object);
+}
+
+tl::expected<Ingest::Ack, QString> Ingest::parseAck(const QByteArray& line) {
+    auto object = toObject(line);
+    if (!object) {
+        return tl::unexpected(object.error());
+    }
+    return Ack {
+        .eventId = object->value("eventId").toString(),
+        .ok = object->value("ok").toBool(),
+        .error = object->value("error").toString()
+    };
+}
+
+QByteArray Ingest::encodeAck(const Ack& ack) {
+    QJsonObject object {
+        { "eventId", ack.eventId },
+        { "ok", ack.ok }
+    };
+    if (!ack.ok) {
+        object.insert("error", ack.error);
+    }
+    return toLine(object);
+}
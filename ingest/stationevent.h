@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+#include <tl/expected.hpp>
+
+namespace Ingest {
+
+// Timestamped capture sent by a timing station.
+// Wire format: one JSON object per line (NDJSON), e.g.
+//   {"eventId":"st01-000042","station":"st01","type":"finish","plate":"123","capturedAt":1739800000123}
+// capturedAt is the station's wall clock in epoch milliseconds; splits also carry "checkpoint".
+// eventId must be unique per event and stable across retries: resending an event is harmless.
+struct StationEvent {
+    enum Type {
+        Finish,
+        Split
+    };
+
+    QString eventId;
+    QString stationId;
+    Type type = Finish;
+    QString plateCode;
+    QString checkpoint;
+    QDateTime capturedAt;
+};
+
+// Every event line is answered, in order, with {"eventId":..., "ok":true} or {"eventId":..., "ok":false, "error":...}
+struct Ack {
+    QString eventId;
+    bool ok = false;
+    QString error;
+};
+
+[[nodiscard]] tl::expected<StationEvent, QString> parseEvent(const QByteArray& line);
+[[nodiscard]] QByteArray encodeEvent(const StationEvent& event);
+
+[[nodiscard]] tl::expected<Ack, QString> parseAck(const QByteArray& line);
+[[nodiscard]] QByteArray encodeAck(const Ack& ack);
+
+};
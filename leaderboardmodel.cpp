@@ -0,0 +1,143 @@
+#include "leaderboardmodel.h"
+#include <QFont>
+#include <algorithm>
+
+LeaderboardModel::LeaderboardModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void LeaderboardModel::load(const Aggregates::TrialSnapshot& snapshot)
+{
+    beginResetModel();
+    m_rows.clear();
+
+    m_index.rebuild(snapshot);
+    m_rows.reserve(m_index.size());
+    for (const auto& entry : m_index.top()) {
+        m_rows.append(entry.result.id);
+    }
+
+    endResetModel();
+}
+
+void LeaderboardModel::clear()
+{
+    beginResetModel();
+    m_index.clear();
+    m_rows.clear();
+    endResetModel();
+}
+
+void LeaderboardModel::apply(const QVector<Aggregates::RankingEntry>& entries)
+{
+    if (entries.isEmpty()) {
+        return;
+    }
+
+    int firstChangedRow = static_cast<int>(m_rows.size());
+
+    for (const auto& entry : entries) {
+        const int oldRow = rowOfResult(entry.result.id);
+        m_index.insert(entry);
+        const int newRow = m_index.position(entry.result.id) - 1;
+
+        if (oldRow < 0) {
+            beginInsertRows(QModelIndex(), newRow, newRow);
+            m_rows.insert(newRow, entry.result.id);
+            endInsertRows();
+            firstChangedRow = std::min(firstChangedRow, newRow);
+            continue;
+        }
+
+        // A corrected time moves the existing row instead of removing and re-adding it
+        if (newRow != oldRow) {
+            // beginMoveRows expects the destination as "insert before" in pre-move coordinates
+            const int destination = newRow > oldRow ? newRow + 1 : newRow;
+            beginMoveRows(QModelIndex(), oldRow, oldRow, QModelIndex(), destination);
+            m_rows.move(oldRow, newRow);
+            endMoveRows();
+        }
+        firstChangedRow = std::min({ firstChangedRow, oldRow, newRow });
+    }
+
+    // Positions shift for every row below the first change; one notification covers them all
+    if (firstChangedRow < m_rows.size()) {
+        emit dataChanged(index(firstChangedRow, 0), index(static_cast<int>(m_rows.size()) - 1, ColumnCount - 1));
+    }
+}
+
+int LeaderboardModel::rowOfResult(const int resultId) const
+{
+    return m_index.find(resultId) ? m_index.position(resultId) - 1 : -1;
+}
+
+int LeaderboardModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_rows.size());
+}
+
+int LeaderboardModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant LeaderboardModel::data(const QModelIndex& index, const int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size()) {
+        return {};
+    }
+
+    const Aggregates::RankingEntry* entry = m_index.find(m_rows[index.row()]);
+    if (!entry) {
+        return {};
+    }
+
+    if (role == Qt::TextAlignmentRole) {
+        switch (index.column()) {
+        case PositionColumn:
+        case TimeColumn:
+        case CategoryPositionColumn:
+            return QVariant(Qt::AlignRight | Qt::AlignVCenter);
+        default:
+            return {};
+        }
+    }
+
+    if (role == Qt::FontRole && index.row() < 3) {
+        QFont font;
+        font.setBold(true);
+        return font;
+    }
+
+    if (role != Qt::DisplayRole) {
+        return {};
+    }
+
+    switch (index.column()) {
+    case PositionColumn:
+        return index.row() + 1;
+    case PlateCodeColumn:
+        return entry->plateCode;
+    case AthleteNameColumn:
+        return entry->athlete.name;
+    case CategoryColumn:
+        return entry->category.name();
+    case ModalityColumn:
+        return entry->modality.name();
+    case TimeColumn:
+        return entry->formattedTime;
+    case CategoryPositionColumn:
+        return m_index.categoryPosition(entry->result.id);
+    default:
+        return {};
+    }
+}
+
+QVariant LeaderboardModel::headerData(const int section, const Qt::Orientation orientation, const int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return {};
+    }
+    return m_headers.value(section);
+}
@@ -0,0 +1,62 @@
+#ifndef LEADERBOARDMODEL_H
+#define LEADERBOARDMODEL_H
+
+#include <QAbstractTableModel>
+#include <QStringList>
+#include <QVector>
+#include "aggregates/rankingindex.h"
+#include "aggregates/trialsnapshot.h"
+
+// Live overall ranking of one trial. The rows mirror a RankingIndex and are
+// updated with row-level insert/move notifications, never with a model reset,
+// so views keep their scroll position and only repaint what is visible.
+class LeaderboardModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        PositionColumn = 0,
+        PlateCodeColumn,
+        AthleteNameColumn,
+        CategoryColumn,
+        ModalityColumn,
+        TimeColumn,
+        CategoryPositionColumn,
+        ColumnCount
+    };
+
+    explicit LeaderboardModel(QObject* parent = nullptr);
+
+    // Full reload from a snapshot loaded with results; the only operation that resets the model
+    void load(const Aggregates::TrialSnapshot& snapshot);
+    void clear();
+
+    // Ranks new (or corrected) results and notifies the views row by row
+    void apply(const QVector<Aggregates::RankingEntry>& entries);
+
+    [[nodiscard]] int trialId() const { return m_index.trialId(); }
+    [[nodiscard]] int rowOfResult(int resultId) const;
+
+    [[nodiscard]] int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    [[nodiscard]] int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    [[nodiscard]] QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    const QStringList m_headers = {
+        "Pos.",
+        "Placa",
+        "Atleta",
+        "Categoria",
+        "Modalidade",
+        "Tempo",
+        "Pos. Cat."
+    };
+
+    Aggregates::RankingIndex m_index;
+    // Result ids in ranking order; row i holds position i + 1
+    QVector<int> m_rows;
+};
+
+#endif // LEADERBOARDMODEL_H
@@ -0,0 +1,154 @@
+#include "leaderboardwindow.h"
+#include "utils/timeutils.h"
+#include <QHeaderView>
+#include <QElapsedTimer>
+#include <QDebug>
+
+LeaderboardWindow::LeaderboardWindow(DBManager& dbManager, QWidget *parent)
+    : QDialog(parent)
+    , m_dbManager(dbManager)
+    , m_mainLayout(nullptr)
+    , m_titleLabel(nullptr)
+    , m_statusLabel(nullptr)
+    , m_table(nullptr)
+    , m_model(nullptr)
+{
+    setupUI();
+
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(frameBudgetMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &LeaderboardWindow::flushPendingResults);
+}
+
+LeaderboardWindow::~LeaderboardWindow()
+= default;
+
+void LeaderboardWindow::setupUI()
+{
+    setWindowTitle("Classificação ao vivo");
+    setModal(false);
+    setWindowFlag(Qt::WindowMaximizeButtonHint, true);
+    resize(900, 600);
+
+    m_mainLayout = new QVBoxLayout(this);
+
+    m_titleLabel = new QLabel("Nenhuma prova selecionada");
+    m_titleLabel->setStyleSheet("font-weight: bold; font-size: 16px;");
+    m_mainLayout->addWidget(m_titleLabel);
+
+    m_model = new LeaderboardModel(this);
+
+    m_table = new QTableView();
+    m_table->setModel(m_model);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setAlternatingRowColors(true);
+    m_table->setWordWrap(false);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_table->horizontalHeader()->setStretchLastSection(false);
+    m_table->horizontalHeader()->setSectionResizeMode(LeaderboardModel::AthleteNameColumn, QHeaderView::Stretch);
+    m_table->horizontalHeader()->resizeSection(LeaderboardModel::PositionColumn, 50);
+    m_table->horizontalHeader()->resizeSection(LeaderboardModel::PlateCodeColumn, 80);
+    m_table->horizontalHeader()->resizeSection(LeaderboardModel::CategoryColumn, 140);
+    m_table->horizontalHeader()->resizeSection(LeaderboardModel::ModalityColumn, 140);
+    m_table->horizontalHeader()->resizeSection(LeaderboardModel::TimeColumn, 110);
+    m_table->horizontalHeader()->resizeSection(LeaderboardModel::CategoryPositionColumn, 70);
+    m_mainLayout->addWidget(m_table);
+
+    m_statusLabel = new QLabel();
+    m_statusLabel->setStyleSheet("color: #666;");
+    m_mainLayout->addWidget(m_statusLabel);
+
+    setLayout(m_mainLayout);
+}
+
+void LeaderboardWindow::setTrial(const int trialId, const QString& trialName)
+{
+    m_refreshTimer.stop();
+    m_pendingResults.clear();
+    m_snapshot.reset();
+
+    m_titleLabel->setText(trialName.isEmpty() ? QString("Prova %1").arg(trialId) : trialName);
+
+    if (trialId <= 0) {
+        m_model->clear();
+        updateStatus();
+        return;
+    }
+
+    // Registrations and ranking come from the same snapshot
+    if (auto loaded = reloadSnapshot(trialId); !loaded.has_value()) {
+        qWarning() << "[Leaderboard] Error loading ranking:" << loaded.error();
+        m_model->clear();
+        m_statusLabel->setText("Erro ao carregar a classificação: " + loaded.error());
+        return;
+    }
+
+    m_model->load(*m_snapshot);
+    updateStatus();
+}
+
+void LeaderboardWindow::addResults(const QVector<Results::Result>& results)
+{
+    m_pendingResults += results;
+    if (!m_refreshTimer.isActive()) {
+        m_refreshTimer.start();
+    }
+}
+
+void LeaderboardWindow::flushPendingResults()
+{
+    if (m_pendingResults.isEmpty() || m_model->trialId() <= 0) {
+        m_pendingResults.clear();
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Registrations created during the race are not in the snapshot yet; the reload already has their results
+    if (m_snapshot->applyResults(m_pendingResults) > 0) {
+        if (auto reloaded = reloadSnapshot(m_model->trialId()); !reloaded.has_value()) {
+            qWarning() << "[Leaderboard] Error loading registrations:" << reloaded.error();
+        }
+    }
+
+    QVector<Aggregates::RankingEntry> entries;
+    entries.reserve(m_pendingResults.size());
+
+    for (const auto& result : std::as_const(m_pendingResults)) {
+        const int index = m_snapshot->indexOfResult(result.id);
+        if (index < 0) {
+            continue; // belongs to another trial
+        }
+        if (!m_snapshot->isRanked(m_snapshot->resultRows[index])) {
+            continue; // not ranked, same as the SQL rankings
+        }
+        entries.append(m_snapshot->rankingEntry(index));
+    }
+    m_pendingResults.clear();
+
+    m_model->apply(entries);
+
+    updateStatus(timer.nsecsElapsed() / 1000);
+}
+
+tl::expected<void, QString> LeaderboardWindow::reloadSnapshot(const int trialId)
+{
+    auto loaded = Aggregates::TrialSnapshot::load(DBManager::database(), trialId, true);
+    if (!loaded.has_value()) {
+        return tl::unexpected(loaded.error());
+    }
+    m_snapshot = std::make_shared<Aggregates::TrialSnapshot>(std::move(loaded.value()));
+    return {};
+}
+
+void LeaderboardWindow::updateStatus(const qint64 flushUs)
+{
+    QString status = QString("%1 chegada(s)").arg(m_model->rowCount());
+    if (flushUs >= 0) {
+        status += QString(" | Última atualização: %1 ms").arg(static_cast<double>(flushUs) / 1000.0, 0, 'f', 1);
+    }
+    m_statusLabel->setText(status);
+}
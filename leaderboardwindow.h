@@ -0,0 +1,60 @@
+#ifndef LEADERBOARDWINDOW_H
+#define LEADERBOARDWINDOW_H
+
+#include <QDialog>
+#include <QLabel>
+#include <QTableView>
+#include <QTimer>
+#include <QVBoxLayout>
+#include <memory>
+#include "dbmanager.h"
+#include "leaderboardmodel.h"
+#include "aggregates/trialsnapshot.h"
+#include "model/result.h"
+
+// Non-modal live ranking of the trial being timed.
+// Finish notifications are only buffered when they arrive; the buffer is ranked
+// and pushed to the model at most once per frame so bursts of finishes cost a
+// single repaint and never stall the timing window.
+class LeaderboardWindow : public QDialog
+{
+    Q_OBJECT
+
+public:
+    LeaderboardWindow(DBManager& dbManager, QWidget *parent = nullptr);
+    ~LeaderboardWindow() override;
+
+    void setTrial(int trialId, const QString& trialName);
+    [[nodiscard]] int trialId() const { return m_model->trialId(); }
+
+public slots:
+    void addResults(const QVector<Results::Result>& results);
+
+private slots:
+    void flushPendingResults();
+
+private:
+    static constexpr int frameBudgetMs = 250;
+
+    DBManager& m_dbManager;
+
+    // UI Components
+    QVBoxLayout* m_mainLayout;
+    QLabel* m_titleLabel;
+    QLabel* m_statusLabel;
+    QTableView* m_table;
+
+    LeaderboardModel* m_model;
+    QTimer m_refreshTimer;
+    QVector<Results::Result> m_pendingResults;
+
+    // Registrations and results of the trial; new results are applied to it and it is
+    // reloaded only when a result refers to a registration it does not know
+    std::shared_ptr<Aggregates::TrialSnapshot> m_snapshot;
+
+    void setupUI();
+    [[nodiscard]] tl::expected<void, QString> reloadSnapshot(int trialId);
+    void updateStatus(qint64 flushUs = -1);
+};
+
+#endif // LEADERBOARDWINDOW_H
@@ -1,10 +1,13 @@
 #include "loadparticipantswindow.h"
 #include "repository/registrations/registrationsrepository.h"
+#include "repository/registrations/bulkimporter.h"
+#include "aggregates/trialsnapshot.h"
 #include "repository/athletes/athletesrepository.h"
 #include "repository/categories/categoriesrepository.h"
 #include "repository/modalities/modalitiesrepository.h"
 #include "utils/excelutils.h"
 #include <QDebug>
+#include <QHash>
 #include <QDateTime>
 #include <QApplication>
 #include <QFileInfo>
@@ -325,34 +328,40 @@ bool LoadParticipantsWindow::loadExcelFile(const QString& filePath)
     try {
         m_participantsData.clear();
         
-        // Use ExcelUtils to read the file
-        auto excelData = Utils::ExcelUtils::readExcelFile(filePath);
-        
-        if (!excelData.has_value()) {
-            QMessageBox::warning(this, "Error", "Error reading Excel file: " + excelData.error());
-            return false;
-        }
-        
-        const auto& rows = excelData.value();
-        
-        // Skip header row (assume first row is header)
-        for (int i = 1; i < rows.size(); ++i) {
-            const auto& row = rows[i];
+        // Rows are streamed from the sheet; the workbook is never loaded as a whole
+        bool headerSkipped = false;
+        auto excelData = Utils::ExcelUtils::forEachRow(filePath, [this, &headerSkipped](int, const QStringList& row) {
+            // Skip header row (assume first row is header)
+            if (!headerSkipped) {
+                headerSkipped = true;
+                return true;
+            }
             
             if (row.size() < 4) {
-                continue; // Skip incomplete rows
+                return true; // Skip incomplete rows
             }
             
             ParticipantData participant{
-                .name      = row[1].toString().trimmed(), // Coluna B - Nome
-                .plateCode = row[0].toString().trimmed(), // Coluna A - Código da Placa
-                .category  = row[3].toString().trimmed(), // Coluna D - Categoria
-                .modality  = row[2].toString().trimmed(), // Coluna C - Modalidade
+                .name      = row[1].trimmed(), // Coluna B - Nome
+                .plateCode = row[0].trimmed(), // Coluna A - Código da Placa
+                .category  = row[3].trimmed(), // Coluna D - Categoria
+                .modality  = row[2].trimmed(), // Coluna C - Modalidade
             };
             
             if (!participant.name.isEmpty() && !participant.plateCode.isEmpty()) {
                 m_participantsData.append(participant);
             }
+            return true;
+        });
+        
+        if (!excelData.has_value()) {
+            QMessageBox::warning(this, "Error", "Error reading Excel file: " + excelData.error());
+            return false;
+        }
+        
+        if (excelData.value() == 0) {
+            QMessageBox::warning(this, "Error", "Error reading Excel file: No data found in the worksheet");
+            return false;
         }
         
         return true;
@@ -518,145 +527,97 @@ void LoadParticipantsWindow::importParticipants()
         return;
     }
     
+    // Rows whose conflict was resolved in favour of the database are left untouched
+    QHash<QString, const ConflictData*> conflictsByName;
+    for (const auto& conflict : m_conflictsData) {
+        if (conflict.resolved) {
+            conflictsByName.insert(conflict.dbName.trimmed().toLower(), &conflict);
+        }
+    }
+
+    QVector<Registrations::BulkImporter::Row> rows;
+    rows.reserve(validCount);
+    int keptFromDatabase = 0;
+
+    for (const auto& participant : m_participantsData) {
+        if (!participant.isValid()) {
+            continue;
+        }
+
+        const ConflictData* conflictInfo = conflictsByName.value(participant.name.trimmed().toLower(), nullptr);
+        if (conflictInfo && !conflictInfo->useExcelVersion) {
+            keptFromDatabase++;
+            continue;
+        }
+
+        rows.push_back({
+            .athleteName = participant.name,
+            .plateCode = participant.plateCode,
+            .categoryName = participant.category,
+            .modalityName = participant.modality,
+            .updateExisting = conflictInfo != nullptr
+        });
+    }
+
     setControlsEnabled(false);
     m_progressBar->setVisible(true);
-    m_progressBar->setRange(0, validCount);
-    m_progressBar->setValue(0);
-    
-    int imported = 0;
+    m_progressBar->setRange(0, 0);
+    m_statusLabel->setText(QString("Importing %1 participants...").arg(rows.size()));
+    QApplication::processEvents();
+
+    int imported = keptFromDatabase;
     int errors = 0;
-    
-    try {
-        Athletes::Repository athletesRepo(DBManager::database());
-        Categories::Repository categoriesRepo(DBManager::database());
-        Modalities::Repository modalitiesRepo(DBManager::database());
-        Registrations::Repository registrationsRepo(DBManager::database());
-        
-        for (const auto & participant : m_participantsData) {
-            if (!participant.isValid()) {
-                continue;
-            }
-            
-            m_statusLabel->setText(QString("Importing: %1").arg(participant.name));
-            QApplication::processEvents();
-            
-            try {
-                // Check if this participant has a conflict resolution
-                ConflictData* conflictInfo = nullptr;
-                QString participantName = participant.name.trimmed().toLower();
-                
-                for (auto& conflict : m_conflictsData) {
-                    if (conflict.dbName.trimmed().toLower() == participantName) {
-                        conflictInfo = &conflict;
-                        break;
-                    }
-                }
-                
-                // If conflict exists and user chose to keep database version, skip import
-                if (conflictInfo && conflictInfo->resolved && !conflictInfo->useExcelVersion) {
-                    qDebug() << QString("[LoadParticipants] Skipping %1 - keeping database version").arg(participant.name);
-                    imported++; // Count as "imported" (no change needed)
-                    continue;
-                }
-                
-                // Get or create athlete
-                int athleteId = -1;
-                if (!createAthleteIfNotExists(participant.name, athleteId)) {
-                    qDebug() << "Error creating athlete " << participant.name;
-                    errors++;
-                    continue;
-                }
-                
-                // Get or create category
-                int categoryId = findOrCreateCategory(participant.category);
-                if (categoryId <= 0) {
-                    qDebug() << "Error creating category " << participant.category;
-                    errors++;
-                    continue;
-                }
-                
-                // Get or create modality
-                int modalityId = findOrCreateModality(participant.modality);
-                if (modalityId <= 0) {
-                    qDebug() << "Error creating modality " << participant.modality;
-                    errors++;
-                    continue;
-                }
-                
-                // Check if this is a conflict that needs updating
-                if (conflictInfo && conflictInfo->resolved && conflictInfo->useExcelVersion) {
-                    // Update existing registration
-                    qDebug() << QString("[LoadParticipants] Updating registration for %1 with Excel version").arg(participant.name);
-                    
-                    // Find existing registration by athlete and trial
-                    auto existingResult = registrationsRepo.getRegistrationsByTrial(trialId);
-                    if (existingResult.has_value()) {
-                        for (const auto& existing : existingResult.value()) {
-                            if (existing.athleteId == athleteId) {
-                                // Create updated registration object
-                                Registrations::Registration updatedReg = existing;
-                                updatedReg.plateCode = participant.plateCode;
-                                updatedReg.modalityId = modalityId;
-                                updatedReg.categoryId = categoryId;
-                                
-                                // Update the registration
-                                auto updateResult = registrationsRepo.updateRegistrationById(existing.id, updatedReg);
-                                
-                                if (updateResult.has_value()) {
-                                    imported++;
-                                    qDebug() << QString("[LoadParticipants] Successfully updated registration ID %1").arg(existing.id);
-                                } else {
-                                    qDebug() << "[LoadParticipants] Error updating registration:" << updateResult.error();
-                                    errors++;
-                                }
-                                break;
-                            }
-                        }
-                    }
-                } else {
-                    // Create new registration (no conflict or new participant)
-                    qDebug() << QString("[LoadParticipants] Creating new registration: trialId=%1, athleteId=%2, plateCode=%3, modalityId=%4, categoryId=%5")
-                               .arg(trialId).arg(athleteId).arg(participant.plateCode).arg(modalityId).arg(categoryId);
-                               
-                    auto registrationResult = registrationsRepo.createRegistration(
-                        trialId,
-                        athleteId,
-                        participant.plateCode,
-                        modalityId,
-                        categoryId
-                    );
-                    
-                    if (registrationResult.has_value()) {
-                        imported++;
-                        qDebug() << QString("[LoadParticipants] Successfully created registration ID %1").arg(registrationResult.value().id);
-                    } else {
-                        qDebug() << "[LoadParticipants] Error creating registration:" << registrationResult.error();
-                        errors++;
-                    }
-                }
-                
-            } catch (const std::exception& e) {
-                qDebug() << "Error processing participant:" << participant.name << e.what();
-                errors++;
+    QStringList skippedLines;
+
+    const Registrations::BulkImporter importer(DBManager::database());
+    const auto summary = importer.import(trialId, rows);
+
+    if (summary.has_value()) {
+        imported += summary->registrationsCreated + summary->registrationsUpdated;
+        errors = summary->skipped.size();
+        for (const auto& skipped : summary->skipped) {
+            QString reason;
+            switch (skipped.reason) {
+            case Registrations::BulkImporter::SkipReason::PlateTaken:
+                reason = "plate already in use in this event";
+                break;
+            case Registrations::BulkImporter::SkipReason::NotRegistered:
+                reason = "athlete not registered in this event";
+                break;
+            case Registrations::BulkImporter::SkipReason::SeveralRegistrations:
+                reason = "athlete registered more than once in this event";
+                break;
             }
-            
-            m_progressBar->setValue(m_progressBar->value() + 1);
+            skippedLines << QString("Plate %1 - %2: %3").arg(skipped.plateCode, skipped.athleteName, reason);
         }
-        
-    } catch (const std::exception& e) {
-        qDebug() << "General import error:" << e.what();
-        QMessageBox::critical(this, "Error", "Error during import: " + QString(e.what()));
+    } else {
+        qDebug() << "[LoadParticipants] Import failed:" << summary.error();
+        errors = rows.size();
+        QMessageBox::critical(this, "Error", "Error during import, nothing was imported:\n" + summary.error());
     }
-    
+
     m_progressBar->setVisible(false);
     setControlsEnabled(true);
     
     // Show results
-    QString resultMessage = QString("Import completed!\nImported: %1\nErrors: %2")
+    QString resultMessage = QString("Import completed!\nImported: %1\nSkipped: %2")
                           .arg(imported)
                           .arg(errors);
     
-    if (errors > 0) {
+    if (!skippedLines.isEmpty()) {
+        // Every skipped row is named; the full list goes in the details when it is long
+        constexpr int maxListedRows = 10;
+        resultMessage += "\n\n" + skippedLines.mid(0, maxListedRows).join("\n");
+        if (skippedLines.size() > maxListedRows) {
+            resultMessage += QString("\n... and %1 more").arg(skippedLines.size() - maxListedRows);
+        }
+
+        QMessageBox box(QMessageBox::Warning, "Import Completed", resultMessage, QMessageBox::Ok, this);
+        if (skippedLines.size() > maxListedRows) {
+            box.setDetailedText(skippedLines.join("\n"));
+        }
+        box.exec();
+    } else if (errors > 0) {
         QMessageBox::warning(this, "Import Completed", resultMessage);
     } else {
         QMessageBox::information(this, "Import Completed", resultMessage);
@@ -667,92 +628,6 @@ void LoadParticipantsWindow::importParticipants()
     }
 }
 
-bool LoadParticipantsWindow::createAthleteIfNotExists(const QString& name, int& athleteId)
-{
-    try {
-        Athletes::Repository athletesRepo(DBManager::database());
-        
-        // Check if athlete already exists
-        auto existingResult = athletesRepo.getAthleteByName(name);
-        if (existingResult.has_value() && !existingResult.value().name.isEmpty()) {
-            athleteId = existingResult.value().id;
-            return true;
-        }
-        
-        // Create new athlete
-        auto createResult = athletesRepo.createAthlete(name);
-        if (createResult.has_value()) {
-            athleteId = createResult.value().id;
-            return true;
-        }
-        
-        qDebug() << "Error creating athlete:" << createResult.error();
-        return false;
-        
-    } catch (const std::exception& e) {
-        qDebug() << "Error in createAthleteIfNotExists:" << e.what();
-        return false;
-    }
-}
-
-int LoadParticipantsWindow::findOrCreateCategory(const QString& categoryName)
-{
-    try {
-        Categories::Repository categoriesRepo(DBManager::database());
-        
-        // Check existing categories
-        for (const auto& category : m_categories) {
-            if (category.name.compare(categoryName, Qt::CaseInsensitive) == 0) {
-                return category.id;
-            }
-        }
-        
-        // Create new category
-        auto createResult = categoriesRepo.createCategory(categoryName);
-        if (createResult.has_value()) {
-            // Update local cache
-            m_categories.append(createResult.value());
-            return createResult.value().id;
-        }
-        
-        qDebug() << "Error creating category:" << createResult.error();
-        return -1;
-        
-    } catch (const std::exception& e) {
-        qDebug() << "Error in findOrCreateCategory:" << e.what();
-        return -1;
-    }
-}
-
-int LoadParticipantsWindow::findOrCreateModality(const QString& modalityName)
-{
-    try {
-        Modalities::Repository modalitiesRepo(DBManager::database());
-        
-        // Check existing modalities
-        for (const auto& modality : m_modalities) {
-            if (modality.name.compare(modalityName, Qt::CaseInsensitive) == 0) {
-                return modality.id;
-            }
-        }
-        
-        // Create new modality
-        auto createResult = modalitiesRepo.createModality(modalityName);
-        if (createResult.has_value()) {
-            // Update local cache
-            m_modalities.append(createResult.value());
-            return createResult.value().id;
-        }
-        
-        qDebug() << "Error creating modality:" << createResult.error();
-        return -1;
-        
-    } catch (const std::exception& e) {
-        qDebug() << "Error in findOrCreateModality:" << e.what();
-        return -1;
-    }
-}
-
 void LoadParticipantsWindow::onTrialSelected()
 {
     int currentIndex = m_trialCombo->currentIndex();
@@ -829,90 +704,87 @@ void LoadParticipantsWindow::detectConflicts()
         return;
     }
     
-    try {
-        // Get existing registrations for this trial
-        Registrations::Repository registrationsRepo(DBManager::database());
-        auto existingResult = registrationsRepo.getRegistrationsByTrial(m_selectedTrialId);
-        
-        if (!existingResult.has_value()) {
-            return; // No existing registrations, no conflicts
+    // One joined query for every registration already in the trial
+    const auto snapshot = Aggregates::TrialSnapshot::load(DBManager::database(), m_selectedTrialId);
+    if (!snapshot.has_value()) {
+        qDebug() << "Error detecting conflicts:" << snapshot.error();
+        return;
+    }
+
+    if (snapshot->isEmpty()) {
+        return; // No existing registrations, no conflicts
+    }
+
+    const auto normalized = [](const QString& value) { return value.trimmed().toLower(); };
+
+    // Existing participants by name (case insensitive). Snapshot rows are ordered by modality and
+    // plate, so the newest registration (highest id) is picked explicitly, as before
+    QHash<QString, int> existingRows;
+    existingRows.reserve(snapshot->size());
+    for (int row = 0; row < snapshot->size(); ++row) {
+        const QString name = normalized(snapshot->athleteNames[row]);
+        const auto existing = existingRows.find(name);
+        if (existing == existingRows.end()) {
+            existingRows.insert(name, row);
+        } else if (snapshot->registrationIds[row] > snapshot->registrationIds[existing.value()]) {
+            existing.value() = row;
         }
-        
-        auto existingRegistrations = existingResult.value();
-        
-        // Create map of existing participants by name (case insensitive)
-        QMap<QString, Registrations::Registration> existingMap;
-        for (const auto& reg : existingRegistrations) {
-            // Get athlete name
-            Athletes::Repository athletesRepo(DBManager::database());
-            auto athleteResult = athletesRepo.getAthleteById(reg.athleteId);
-            if (athleteResult.has_value()) {
-                QString athleteName = athleteResult.value().name.trimmed().toLower();
-                existingMap[athleteName] = reg;
-            }
+    }
+
+    // Single pass over the spreadsheet, diffing field by field
+    for (const auto& participant : m_participantsData) {
+        if (!participant.isValid()) continue;
+
+        const auto existing = existingRows.constFind(normalized(participant.name));
+        if (existing == existingRows.constEnd()) {
+            continue;
         }
-        
-        // Check each participant from Excel for conflicts
-        for (const auto& participant : m_participantsData) {
-            if (!participant.isValid()) continue;
-            
-            QString participantName = participant.name.trimmed().toLower();
-            
-            if (existingMap.contains(participantName)) {
-                // Found conflict - get existing data
-                auto existingReg = existingMap[participantName];
-                
-                // Get existing category and modality names
-                QString existingCategory, existingModality;
-                
-                Categories::Repository categoriesRepo(DBManager::database());
-                auto catResult = categoriesRepo.getCategoryById(existingReg.categoryId);
-                if (catResult.has_value()) {
-                    existingCategory = catResult.value().name;
-                }
-                
-                Modalities::Repository modalitiesRepo(DBManager::database());
-                auto modResult = modalitiesRepo.getModalityById(existingReg.modalityId);
-                if (modResult.has_value()) {
-                    existingModality = modResult.value().name;
-                }
-                
-                // Check if there are actual differences
-                bool hasDifferences = (
-                    existingReg.plateCode.trimmed().toLower() != participant.plateCode.trimmed().toLower() ||
-                    existingCategory.trimmed().toLower() != participant.category.trimmed().toLower() ||
-                    existingModality.trimmed().toLower() != participant.modality.trimmed().toLower()
-                );
-                
-                if (hasDifferences) {
-                    ConflictData conflict;
-                    conflict.plateCode = participant.plateCode;
-                    
-                    // Database version
-                    conflict.dbName = participant.name; // Same name
-                    conflict.dbCategory = existingCategory;
-                    conflict.dbModality = existingModality;
-                    
-                    // Excel version
-                    conflict.excelName = participant.name;
-                    conflict.excelCategory = participant.category;
-                    conflict.excelModality = participant.modality;
-                    
-                    conflict.useExcelVersion = true; // Default to Excel version
-                    conflict.resolved = false;
-                    
-                    m_conflictsData.append(conflict);
-                }
-            }
+
+        const int row = existing.value();
+        const QString existingPlate = snapshot->plateCodes[row];
+        const QString existingCategory = snapshot->categoryNames.value(snapshot->categoryIds[row]);
+        const QString existingModality = snapshot->modalityNames.value(snapshot->modalityIds[row]);
+
+        ConflictData conflict;
+        if (normalized(existingPlate) != normalized(participant.plateCode)) {
+            conflict.changedFields |= ConflictData::PlateField;
         }
-        
-        // If conflicts found, show conflicts dialog
-        if (!m_conflictsData.isEmpty()) {
-            showConflictsDialog();
+        if (normalized(existingCategory) != normalized(participant.category)) {
+            conflict.changedFields |= ConflictData::CategoryField;
         }
-        
-    } catch (const std::exception& e) {
-        qDebug() << "Error detecting conflicts:" << e.what();
+        if (normalized(existingModality) != normalized(participant.modality)) {
+            conflict.changedFields |= ConflictData::ModalityField;
+        }
+
+        if (conflict.changedFields == 0) {
+            continue;
+        }
+
+        conflict.plateCode = participant.plateCode;
+
+        // Database version
+        conflict.dbName = participant.name; // Same name
+        conflict.dbPlateCode = existingPlate;
+        conflict.dbCategory = existingCategory;
+        conflict.dbModality = existingModality;
+
+        // Excel version
+        conflict.excelName = participant.name;
+        conflict.excelCategory = participant.category;
+        conflict.excelModality = participant.modality;
+
+        conflict.useExcelVersion = true; // Default to Excel version
+        conflict.resolved = false;
+
+        m_conflictsData.append(conflict);
+    }
+
+    qDebug() << "[LoadParticipants] Diffed" << m_participantsData.size() << "rows against"
+             << snapshot->size() << "registrations:" << m_conflictsData.size() << "conflict(s)";
+
+    // If conflicts found, show conflicts dialog
+    if (!m_conflictsData.isEmpty()) {
+        showConflictsDialog();
     }
 }
 
@@ -937,7 +809,7 @@ void LoadParticipantsWindow::showConflictsDialog()
     // Create table for conflicts
     QTableWidget* conflictTable = new QTableWidget();
     conflictTable->setColumnCount(6);
-    QStringList headers = {"Name", "Database Version", "Excel Version", "Choose", "", ""};
+    QStringList headers = {"Name", "Database Version", "Excel Version", "Choose", "Changes", ""};
     conflictTable->setHorizontalHeaderLabels(headers);
     conflictTable->setRowCount(m_conflictsData.size());
     
@@ -949,7 +821,7 @@ void LoadParticipantsWindow::showConflictsDialog()
         
         // Database version
         QString dbVersion = QString("Plate: %1\nCategory: %2\nModality: %3")
-            .arg(conflict.plateCode, conflict.dbCategory, conflict.dbModality);
+            .arg(conflict.dbPlateCode, conflict.dbCategory, conflict.dbModality);
         QTableWidgetItem* dbItem = new QTableWidgetItem(dbVersion);
         dbItem->setBackground(QColor(255, 235, 235)); // Light red
         conflictTable->setItem(row, 1, dbItem);
@@ -974,6 +846,13 @@ void LoadParticipantsWindow::showConflictsDialog()
         choiceWidget->setLayout(choiceLayout);
         
         conflictTable->setCellWidget(row, 3, choiceWidget);
+
+        // Fields that differ between both versions
+        QStringList changes;
+        if (conflict.hasChanged(ConflictData::PlateField)) changes << "Plate";
+        if (conflict.hasChanged(ConflictData::CategoryField)) changes << "Category";
+        if (conflict.hasChanged(ConflictData::ModalityField)) changes << "Modality";
+        conflictTable->setItem(row, 4, new QTableWidgetItem(changes.join(", ")));
         
         // Store radio buttons for later access
         conflictTable->setProperty(QString("dbRadio_%1").arg(row).toLatin1(), QVariant::fromValue(keepDbRadio));
@@ -1031,37 +910,39 @@ void LoadParticipantsWindow::updatePreviewTableWithConflicts()
         return;
     }
     
+    QHash<QString, const ConflictData*> conflictsByName;
+    conflictsByName.reserve(m_conflictsData.size());
+    for (const auto& conflict : m_conflictsData) {
+        conflictsByName.insert(conflict.dbName.trimmed().toLower(), &conflict);
+    }
+
     // Highlight conflicts in the preview table
     for (int row = 0; row < m_previewTable->rowCount(); ++row) {
         QTableWidgetItem* nameItem = m_previewTable->item(row, 0);
         if (!nameItem) continue;
         
-        QString participantName = nameItem->text().trimmed().toLower();
-        
         // Check if this participant has a conflict
-        for (const auto& conflict : m_conflictsData) {
-            if (conflict.dbName.trimmed().toLower() == participantName) {
-                // Highlight the row in yellow to indicate conflict resolution
-                for (int col = 0; col < m_previewTable->columnCount(); ++col) {
-                    QTableWidgetItem* item = m_previewTable->item(row, col);
-                    if (item) {
-                        item->setBackground(QColor(255, 255, 0, 100)); // Light yellow
-                    }
-                }
-                
-                // Update status
-                QTableWidgetItem* statusItem = m_previewTable->item(row, 4);
-                if (statusItem) {
-                    if (conflict.resolved) {
-                        statusItem->setText(conflict.useExcelVersion ? "Excel Version" : "Database Version");
-                        statusItem->setBackground(conflict.useExcelVersion ? 
-                            QColor(235, 255, 235) : QColor(255, 235, 235));
-                    } else {
-                        statusItem->setText("Conflict - Needs Resolution");
-                        statusItem->setBackground(QColor(255, 255, 0));
-                    }
-                }
-                break;
+        const ConflictData* conflict = conflictsByName.value(nameItem->text().trimmed().toLower(), nullptr);
+        if (!conflict) continue;
+
+        // Highlight the row in yellow to indicate conflict resolution
+        for (int col = 0; col < m_previewTable->columnCount(); ++col) {
+            QTableWidgetItem* item = m_previewTable->item(row, col);
+            if (item) {
+                item->setBackground(QColor(255, 255, 0, 100)); // Light yellow
+            }
+        }
+        
+        // Update status
+        QTableWidgetItem* statusItem = m_previewTable->item(row, 4);
+        if (statusItem) {
+            if (conflict->resolved) {
+                statusItem->setText(conflict->useExcelVersion ? "Excel Version" : "Database Version");
+                statusItem->setBackground(conflict->useExcelVersion ? 
+                    QColor(235, 255, 235) : QColor(255, 235, 235));
+            } else {
+                statusItem->setText("Conflict - Needs Resolution");
+                statusItem->setBackground(QColor(255, 255, 0));
             }
         }
     }
@@ -38,9 +38,16 @@ struct ParticipantData {
 };
 
 struct ConflictData {
+    enum Field : quint8 {
+        PlateField = 0x1,
+        CategoryField = 0x2,
+        ModalityField = 0x4
+    };
+
     QString plateCode;
     // Database version
     QString dbName;
+    QString dbPlateCode;
     QString dbCategory;
     QString dbModality;
     // Excel version  
@@ -50,6 +57,9 @@ struct ConflictData {
     // Resolution (true = keep Excel, false = keep DB)
     bool useExcelVersion = true;
     bool resolved = false;
+    // Fields that differ between both versions (Field bits)
+    quint8 changedFields = 0;
+    bool hasChanged(Field field) const { return (changedFields & field) != 0; }
 };
 
 class LoadParticipantsWindow : public QDialog
@@ -107,9 +117,6 @@ private:
     bool loadExcelFile(const QString& filePath);
     void updatePreviewTable();
     void validateParticipantsData();
-    bool createAthleteIfNotExists(const QString& name, int& athleteId);
-    int findOrCreateCategory(const QString& categoryName);
-    int findOrCreateModality(const QString& modalityName);
     void resetForm();
     void setControlsEnabled(bool enabled);
     void detectConflicts();
@@ -1,10 +1,31 @@
 #include "cronometerwindow.h"
+#include "dbmanager.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    const QCommandLineOption migrateOption("migrate-db",
+        "Upgrade an existing database file to the current schema and exit.",
+        "file");
+    parser.addOption(migrateOption);
+    parser.process(a);
+
+    if (parser.isSet(migrateOption)) {
+        const auto migrated = DBManager::migrateDatabaseFile(parser.value(migrateOption));
+        if (!migrated) {
+            qCritical().noquote() << migrated.error();
+            return 1;
+        }
+        qInfo().noquote() << QString("[DB] %1 is at schema version %2").arg(parser.value(migrateOption)).arg(migrated.value());
+        return 0;
+    }
+
     CronometerWindow w;
     w.show();
     return a.exec();
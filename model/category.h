@@ -2,12 +2,32 @@
 #define CATEGORY_H
 
 #include <QString>
+#include <utility>
+#include "utils/interning.h"
 
 namespace Categories {
 struct Category {
     int id = 0;
     QString name = "";
 };
+
+// Compact reference carried by ranking and detail rows; the name is kept once in the category pool
+struct CategoryRef {
+    int id = 0;
+
+    [[nodiscard]] QString name() const { return Utils::NamePool::categories().name(id); }
+
+    [[nodiscard]] static CategoryRef of(const Category& category) {
+        Utils::NamePool::categories().insert(category.id, category.name);
+        return { .id = category.id };
+    }
+    // loadName is only called when the id is not pooled yet
+    template <typename Loader>
+    [[nodiscard]] static CategoryRef of(const int id, Loader&& loadName) {
+        Utils::NamePool::categories().resolve(id, std::forward<Loader>(loadName));
+        return { .id = id };
+    }
+};
 };
 
 
@@ -0,0 +1,29 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <QString>
+#include <QDateTime>
+
+namespace Checkpoints {
+
+// Intermediate timing point (mat) of a trial; sequence orders them from start to finish
+struct Checkpoint {
+    int id = 0;
+    int trialId = 0;
+    QString code = "";
+    QString name = "";
+    int sequence = 0;
+    int distanceM = 0;      // from the start, 0 when unknown
+};
+
+// One pass of a registration over a checkpoint; an athlete may be read more than once
+struct Crossing {
+    int registrationId = 0;
+    int checkpointId = 0;
+    int elapsedMs = 0;      // net: since the athlete's own (wave or individual) start
+    QDateTime capturedAt;
+    QString eventId;        // set by capture stations
+};
+};
+
+#endif // CHECKPOINT_H
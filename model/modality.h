@@ -2,12 +2,32 @@
 #define MODALITY_H
 
 #include <QString>
+#include <utility>
+#include "utils/interning.h"
 
 namespace Modalities {
 struct Modality {
     int id = 0;
     QString name = "";
 };
+
+// Compact reference carried by ranking and detail rows; the name is kept once in the modality pool
+struct ModalityRef {
+    int id = 0;
+
+    [[nodiscard]] QString name() const { return Utils::NamePool::modalities().name(id); }
+
+    [[nodiscard]] static ModalityRef of(const Modality& modality) {
+        Utils::NamePool::modalities().insert(modality.id, modality.name);
+        return { .id = modality.id };
+    }
+    // loadName is only called when the id is not pooled yet
+    template <typename Loader>
+    [[nodiscard]] static ModalityRef of(const int id, Loader&& loadName) {
+        Utils::NamePool::modalities().resolve(id, std::forward<Loader>(loadName));
+        return { .id = id };
+    }
+};
 };
 
 
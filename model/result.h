@@ -10,8 +10,9 @@ struct Result {
     int registrationId;
     QDateTime startTime;
     QDateTime endTime;
-    int durationMs;
+    int durationMs;     // net: from the athlete's own (wave or individual) start
     QString notes;
+    qint64 elapsedNs;   // monotonic time since trial start at capture, 0 when unknown
 };
 };
 
@@ -0,0 +1,19 @@
+#ifndef WAVE_H
+#define WAVE_H
+
+#include <QString>
+
+namespace Waves {
+
+// Group of registrations that leave together. Offsets are relative to the trial start
+// so a net time is simply the captured elapsed time minus the offset.
+struct Wave {
+    int id = 0;
+    int trialId = 0;
+    QString name = "";
+    int startOffsetMs = 0;
+    bool started = false;   // false until the wave's start is recorded
+};
+};
+
+#endif // WAVE_H
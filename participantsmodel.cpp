@@ -0,0 +1,110 @@
+#include "participantsmodel.h"
+
+ParticipantsModel::ParticipantsModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void ParticipantsModel::setSnapshot(std::shared_ptr<const Aggregates::TrialSnapshot> snapshot)
+{
+    beginResetModel();
+    m_snapshot = std::move(snapshot);
+    endResetModel();
+}
+
+int ParticipantsModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid() || !m_snapshot) {
+        return 0;
+    }
+    return static_cast<int>(m_snapshot->size());
+}
+
+int ParticipantsModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ParticipantsModel::data(const QModelIndex& index, const int role) const
+{
+    if (!m_snapshot || !index.isValid() || index.row() >= m_snapshot->size()) {
+        return {};
+    }
+
+    const int row = index.row();
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case ModalityColumn:
+            return m_snapshot->modalityName(m_snapshot->modalityIds[row]);
+        case PlateCodeColumn:
+            return m_snapshot->plateCodes[row];
+        case AthleteNameColumn:
+            return m_snapshot->athleteNames[row];
+        default:
+            return {};
+        }
+    case RegistrationIdRole:
+        return m_snapshot->registrationIds[row];
+    case CategoryIdRole:
+        return m_snapshot->categoryIds[row];
+    case ModalityIdRole:
+        return m_snapshot->modalityIds[row];
+    default:
+        return {};
+    }
+}
+
+QVariant ParticipantsModel::headerData(const int section, const Qt::Orientation orientation, const int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return {};
+    }
+    if (orientation == Qt::Horizontal) {
+        return m_headers.value(section);
+    }
+    return section + 1;
+}
+
+ParticipantsFilterModel::ParticipantsFilterModel(QObject* parent)
+    : QSortFilterProxyModel(parent)
+{
+}
+
+void ParticipantsFilterModel::setCategoryId(const int categoryId)
+{
+    if (m_categoryId == categoryId) {
+        return;
+    }
+    m_categoryId = categoryId;
+    invalidateFilter();
+}
+
+void ParticipantsFilterModel::setModalityId(const int modalityId)
+{
+    if (m_modalityId == modalityId) {
+        return;
+    }
+    m_modalityId = modalityId;
+    invalidateFilter();
+}
+
+bool ParticipantsFilterModel::filterAcceptsRow(const int sourceRow, const QModelIndex& sourceParent) const
+{
+    Q_UNUSED(sourceParent);
+
+    const auto* model = qobject_cast<const ParticipantsModel*>(sourceModel());
+    const Aggregates::TrialSnapshot* snapshot = model ? model->snapshot() : nullptr;
+    if (!snapshot) {
+        return false;
+    }
+
+    if (m_categoryId != anyCategory && snapshot->categoryIds[sourceRow] != m_categoryId) {
+        return false;
+    }
+    if (m_modalityId != 0 && snapshot->modalityIds[sourceRow] != m_modalityId) {
+        return false;
+    }
+    return true;
+}
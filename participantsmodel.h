@@ -0,0 +1,73 @@
+#ifndef PARTICIPANTSMODEL_H
+#define PARTICIPANTSMODEL_H
+
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include <QStringList>
+#include <memory>
+#include "aggregates/trialsnapshot.h"
+
+// Read-only table over a TrialSnapshot. Cells are produced on demand from the
+// snapshot columns, so views only touch the rows they actually paint.
+class ParticipantsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        ModalityColumn = 0,
+        PlateCodeColumn,
+        AthleteNameColumn,
+        ColumnCount
+    };
+
+    enum Role {
+        RegistrationIdRole = Qt::UserRole + 1,
+        CategoryIdRole,
+        ModalityIdRole
+    };
+
+    explicit ParticipantsModel(QObject* parent = nullptr);
+
+    void setSnapshot(std::shared_ptr<const Aggregates::TrialSnapshot> snapshot);
+    [[nodiscard]] const Aggregates::TrialSnapshot* snapshot() const { return m_snapshot.get(); }
+
+    [[nodiscard]] int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    [[nodiscard]] int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    [[nodiscard]] QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    const QStringList m_headers = {
+        "Modalidade",
+        "Código da Placa",
+        "Nome do Atleta"
+    };
+
+    std::shared_ptr<const Aggregates::TrialSnapshot> m_snapshot;
+};
+
+// Keeps the rows of one category and, optionally, one modality (0 = any).
+// Category 0 is what a registration without a category reads back as, so "any category" is anyCategory.
+// Filtering reads the snapshot columns directly instead of going through data().
+class ParticipantsFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int anyCategory = -1;
+
+    explicit ParticipantsFilterModel(QObject* parent = nullptr);
+
+    void setCategoryId(int categoryId);
+    void setModalityId(int modalityId);
+
+protected:
+    [[nodiscard]] bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+
+private:
+    int m_categoryId = anyCategory;
+    int m_modalityId = 0;
+};
+
+#endif // PARTICIPANTSMODEL_H
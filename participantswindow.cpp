@@ -1,8 +1,5 @@
 #include "participantswindow.h"
-#include "repository/registrations/registrationsrepository.h"
-#include "repository/athletes/athletesrepository.h"
-#include "repository/categories/categoriesrepository.h"
-#include "repository/modalities/modalitiesrepository.h"
+#include <QSignalBlocker>
 #include <QDebug>
 
 ParticipantsWindow::ParticipantsWindow(DBManager& dbManager, QWidget *parent)
@@ -12,9 +9,10 @@ ParticipantsWindow::ParticipantsWindow(DBManager& dbManager, QWidget *parent)
     , mainLayout(nullptr)
     , headerLayout(nullptr)
     , eventLabel(nullptr)
+    , modalityFilter(nullptr)
+    , participantsModel(nullptr)
 {
     setupUI();
-    loadBasicData();
 }
 
 ParticipantsWindow::~ParticipantsWindow()
@@ -34,52 +32,25 @@ void ParticipantsWindow::setupUI()
     eventLabel->setStyleSheet("font-weight: bold; font-size: 14px;");
     
     headerLayout->addWidget(eventLabel);
+    headerLayout->addStretch();
+
+    modalityFilter = new QComboBox();
+    modalityFilter->addItem("Todas as modalidades", 0);
+    connect(modalityFilter, &QComboBox::currentIndexChanged, this, &ParticipantsWindow::onModalityFilterChanged);
+    headerLayout->addWidget(new QLabel("Modalidade:"));
+    headerLayout->addWidget(modalityFilter);
     
     mainLayout->addLayout(headerLayout);
     
     // Tab widget
     tabWidget = new QTabWidget();
     mainLayout->addWidget(tabWidget);
+
+    participantsModel = new ParticipantsModel(this);
     
     setLayout(mainLayout);
 }
 
-void ParticipantsWindow::loadBasicData()
-{
-    try {
-        // Load categories
-        Categories::Repository categoriesRepo(DBManager::database());
-        if (auto categoriesResult = categoriesRepo.getAllCategories(); categoriesResult.has_value()) {
-            categories = categoriesResult.value();
-            qDebug() << "[ParticipantsWindow] Loaded" << categories.size() << "categories";
-        } else {
-            qDebug() << "[ParticipantsWindow] Error loading categories:" << categoriesResult.error();
-        }
-        
-        // Load modalities
-        Modalities::Repository modalitiesRepo(DBManager::database());
-        if (auto modalitiesResult = modalitiesRepo.getAllModalities(); modalitiesResult.has_value()) {
-            modalities = modalitiesResult.value();
-            qDebug() << "[ParticipantsWindow] Loaded" << modalities.size() << "modalities";
-        } else {
-            qDebug() << "[ParticipantsWindow] Error loading modalities:" << modalitiesResult.error();
-        }
-        
-        // Load athletes
-        Athletes::Repository athletesRepo(DBManager::database());
-        if (auto athletesResult = athletesRepo.getAllAthletes(); athletesResult.has_value()) {
-            athletes = athletesResult.value();
-            qDebug() << "[ParticipantsWindow] Loaded" << athletes.size() << "athletes";
-        } else {
-            qDebug() << "[ParticipantsWindow] Error loading athletes:" << athletesResult.error();
-        }
-        
-    } catch (const std::exception& e) {
-        qDebug() << "Error loading basic data:" << e.what();
-        QMessageBox::warning(this, "Error", "Error loading basic system data");
-    }
-}
-
 void ParticipantsWindow::setCurrentTrial(const Trials::TrialInfo& trial)
 {
     currentTrial = trial;
@@ -96,247 +67,110 @@ void ParticipantsWindow::loadParticipants()
         return;
     }
     
-    try {
-        const Registrations::Repository registrationsRepo(DBManager::database());
+    auto loaded = Aggregates::TrialSnapshot::load(DBManager::database(), currentTrial.id);
+    if (!loaded.has_value()) {
+        qDebug() << "Error loading registrations:" << loaded.error();
+        QMessageBox::warning(this, "Error", "Error loading registrations: " + loaded.error());
+        return;
+    }
 
-        if (auto registrationsResult = registrationsRepo.getRegistrationsByTrial(currentTrial.id); registrationsResult.has_value()) {
-            registrations = registrationsResult.value();
-            qDebug() << QString("Loaded %1 registrations for trial %2").arg(registrations.size()).arg(currentTrial.id);
-            createCategoryTabs();
-        } else {
-            qDebug() << "Error loading registrations:" << registrationsResult.error();
-            QMessageBox::warning(this, "Error", "Error loading registrations: " + registrationsResult.error());
-        }
-        
-    } catch (const std::exception& e) {
-        qDebug() << "Error loading participants:" << e.what();
-        QMessageBox::warning(this, "Error", "Error loading participants");
+    snapshot = std::make_shared<const Aggregates::TrialSnapshot>(std::move(loaded.value()));
+    qDebug() << QString("Loaded %1 registrations for trial %2").arg(snapshot->size()).arg(currentTrial.id);
+
+    participantsModel->setSnapshot(snapshot);
+    fillModalityFilter();
+    createCategoryTabs();
+}
+
+void ParticipantsWindow::fillModalityFilter()
+{
+    const QSignalBlocker blocker(modalityFilter);
+    modalityFilter->clear();
+    modalityFilter->addItem("Todas as modalidades", 0);
+
+    QVector<QPair<QString, int>> sortedModalities;
+    for (auto it = snapshot->modalityNames.constBegin(); it != snapshot->modalityNames.constEnd(); ++it) {
+        sortedModalities.append({ it.value(), it.key() });
+    }
+    std::ranges::sort(sortedModalities);
+
+    for (const auto& [name, id] : sortedModalities) {
+        modalityFilter->addItem(name, id);
     }
 }
 
 void ParticipantsWindow::createCategoryTabs()
 {
     qDebug() << "[ParticipantsWindow] Creating category tabs...";
-    // Clear existing tabs
-    tabWidget->clear();
-    
-    if (categories.isEmpty()) {
-        qDebug() << "[ParticipantsWindow] No categories found, showing 'no data' tab";
-        auto* noDataLabel = new QLabel("No categories found");
-        noDataLabel->setAlignment(Qt::AlignCenter);
-        tabWidget->addTab(noDataLabel, "No data");
-        return;
+    // Clear existing tabs; the proxies are owned by their views
+    while (tabWidget->count() > 0) {
+        QWidget* page = tabWidget->widget(0);
+        tabWidget->removeTab(0);
+        page->deleteLater();
     }
-    
-    qDebug() << "[ParticipantsWindow] Processing" << categories.size() << "categories";
-    
-    // Sort categories alphabetically
-    auto sortedCategories = categories;
-    std::sort(sortedCategories.begin(), sortedCategories.end(), [](const Categories::Category& a, const Categories::Category& b) {
-        return a.name < b.name;
-    });
-    
-    // Create tabs for each category that has registrations
-    int tabsCreated = 0;
-    for (const auto& category : sortedCategories) {
-        auto categoryRegistrations = getRegistrationsByCategory(category.id);
-        
-        if (!categoryRegistrations.isEmpty()) {
-            qDebug() << QString("[ParticipantsWindow] Creating tab for category: '%1': %2 registrations")
-                       .arg(category.name, QString::number(categoryRegistrations.size()));
-            
-            auto* table = new QTableWidget();
-            // QStringList headers = {"Modalidade", "Código da Placa", "Nome do Atleta"};
-            table->setColumnCount(static_cast<int>(headers.size()));
-            table->setHorizontalHeaderLabels(headers);
-            
-            // Configure table
-            table->setSelectionBehavior(QAbstractItemView::SelectRows);
-            table->setAlternatingRowColors(true);
-            table->horizontalHeader()->setStretchLastSection(true);
-            table->horizontalHeader()->resizeSection(0, 80);
-            table->horizontalHeader()->resizeSection(1, 250);
-            table->horizontalHeader()->resizeSection(2, 150);
-            table->horizontalHeader()->resizeSection(3, 120);
-            
-            populateTable(table, categoryRegistrations);
-            
-            tabWidget->addTab(table, QString("%1 (%2)")
-                             .arg(category.name)
-                             .arg(categoryRegistrations.size()));
-            
-            tabsCreated++;
+    categoryFilters.clear();
+    
+    // Tabs for each category that has registrations, sorted alphabetically. Registrations without
+    // a (still existing) category get no tab, as before the snapshot.
+    QVector<QPair<QString, int>> sortedCategories;
+    for (auto it = snapshot->registrationsByCategory.constBegin(); it != snapshot->registrationsByCategory.constEnd(); ++it) {
+        if (!snapshot->categoryNames.contains(it.key())) {
+            continue;
         }
+        sortedCategories.append({ snapshot->categoryNames.value(it.key()), it.key() });
     }
-    
-    qDebug() << "[ParticipantsWindow] Created" << tabsCreated << "tabs with data";
-    if (tabWidget->count() == 0) {
+
+    if (sortedCategories.isEmpty()) {
         qDebug() << "[ParticipantsWindow] No tabs with data, showing 'no participants' message";
         auto* noDataLabel = new QLabel("No participants registered on this event");
         noDataLabel->setAlignment(Qt::AlignCenter);
         noDataLabel->setStyleSheet("color: #666; font-size: 14px;");
         tabWidget->addTab(noDataLabel, "Sem dados");
+        return;
     }
-}
-
-void ParticipantsWindow::populateTable(QTableWidget* table, const QVector<Registrations::Registration>& categoryRegistrations)
-{
-    qDebug() << "[ParticipantsWindow] Populating table with" << categoryRegistrations.size() << "registrations";
-    table->setRowCount(static_cast<int>(categoryRegistrations.size()));
-    
-    for (int row = 0; row < categoryRegistrations.size(); ++row) {
-        const auto& registration = categoryRegistrations[row];
-        qDebug() << QString("[ParticipantsWindow] Row %1: Registration ID %2, Athlete ID %3, Plate: %4")
-                   .arg(row).arg(registration.id).arg(registration.athleteId).arg(registration.plateCode);
-        
-        // Number (row + 1)
-        // table->setItem(row, 0, new QTableWidgetItem(QString::number(row + 1)));
-        
-        // Modality name
-        QString modalityName = getModalityName(registration.modalityId);
-        table->setItem(row, getHeaderIndex("Modalidade"), new QTableWidgetItem(modalityName));
-
-        // Plate code
-        table->setItem(row, getHeaderIndex("Código da Placa"), new QTableWidgetItem(registration.plateCode));
-
-        // Athlete name
-        QString athleteName = getAthleteName(registration.athleteId);
-        table->setItem(row, getHeaderIndex("Nome do Atleta"), new QTableWidgetItem(athleteName));
-        
-        
-        
-        // Make items read-only
-        for (int col = 0; col < headers.size(); ++col) {
-            if (table->item(row, col)) {
-                table->item(row, col)->setFlags(table->item(row, col)->flags() & ~Qt::ItemIsEditable);
-            }
-        }
-    }
-}
-
-QVector<Registrations::Registration> ParticipantsWindow::getRegistrationsByCategory(int categoryId)
-{
-    QVector<Registrations::Registration> result;
     
-    for (const auto& registration : registrations) {
-        if (registration.categoryId == categoryId) {
-            result.append(registration);
-        }
-    }
+    std::ranges::sort(sortedCategories);
     
-    // Order by modality and then by plate number
-    std::ranges::sort(result, [this](const Registrations::Registration& a, const Registrations::Registration& b) {
-        // First by modality
-        const QString modalityA = getModalityName(a.modalityId);
-
-        if (const QString modalityB = getModalityName(b.modalityId); modalityA != modalityB) {
-            return modalityA < modalityB;
-        }
-        
-        // If modality is the same, order by plate number
-        // Convert plate to number if possible, otherwise order alphabetically
-        bool okA, okB;
-        const int plateNumA = a.plateCode.toInt(&okA);
-        const int plateNumB = b.plateCode.toInt(&okB);
-        
-        if (okA && okB) {
-            return plateNumA < plateNumB;
-        } else {
-            return a.plateCode < b.plateCode;
-        }
-    });
-    
-    qDebug() << QString("[ParticipantsWindow] Found %1 registrations for category ID %2 (sorted by modality and plate)")
-               .arg(result.size()).arg(categoryId);
-    return result;
-}
-
-QVector<Registrations::Registration> ParticipantsWindow::getRegistrationsByCategoryAndModality(const int categoryId, const int modalityId)
-{
-    QVector<Registrations::Registration> result;
-    
-    for (const auto& registration : registrations) {
-        if (registration.categoryId == categoryId && registration.modalityId == modalityId) {
-            result.append(registration);
-        }
+    for (const auto& [name, categoryId] : sortedCategories) {
+        tabWidget->addTab(createParticipantsView(categoryId), QString("%1 (%2)")
+                         .arg(name)
+                         .arg(snapshot->registrationsByCategory.value(categoryId)));
     }
     
-    // Order by plate number
-    std::ranges::sort(result, [](const Registrations::Registration& a, const Registrations::Registration& b) {
-        // Convert plate to number if possible, otherwise order alphabetically
-        bool okA, okB;
-        const int plateNumA = a.plateCode.toInt(&okA);
-        const int plateNumB = b.plateCode.toInt(&okB);
-        
-        if (okA && okB) {
-            return plateNumA < plateNumB;
-        } else {
-            return a.plateCode < b.plateCode;
-        }
-    });
-    
-    qDebug() << QString("[ParticipantsWindow] Found %1 registrations for category ID %2, modality ID %3")
-               .arg(result.size()).arg(categoryId).arg(modalityId);
-    return result;
-}
-
-void ParticipantsWindow::populateCombinationTable(QTableWidget* table, const QVector<Registrations::Registration>& combinationRegistrations)
-{
-    qDebug() << "[ParticipantsWindow] Populating combination table with" << combinationRegistrations.size() << "registrations";
-    table->setRowCount(static_cast<int>(combinationRegistrations.size()));
-    
-    for (int row = 0; row < combinationRegistrations.size(); ++row) {
-        const auto& registration = combinationRegistrations[row];
-        qDebug() << QString("[ParticipantsWindow] Row %1: Registration ID %2, Athlete ID %3, Plate: %4")
-                   .arg(row).arg(registration.id).arg(registration.athleteId).arg(registration.plateCode);
-        
-        // Number (row + 1)
-        table->setItem(row, 0, new QTableWidgetItem(QString::number(row + 1)));
-        
-        // Athlete name
-        QString athleteName = getAthleteName(registration.athleteId);
-        table->setItem(row, 1, new QTableWidgetItem(athleteName));
-        
-        // Plate code
-        table->setItem(row, 2, new QTableWidgetItem(registration.plateCode));
-        
-        // Make items read-only
-        for (int col = 0; col < 3; ++col) {
-            if (table->item(row, col)) {
-                table->item(row, col)->setFlags(table->item(row, col)->flags() & ~Qt::ItemIsEditable);
-            }
-        }
-    }
-}
-
-QString ParticipantsWindow::getAthleteName(int athleteId)
-{
-    for (const auto&[id, name] : athletes) {
-        if (id == athleteId) {
-            return name;
-        }
-    }
-    return QString("ID: %1").arg(athleteId);
+    qDebug() << "[ParticipantsWindow] Created" << tabWidget->count() << "tabs with data";
 }
 
-QString ParticipantsWindow::getModalityName(int modalityId)
+QTableView* ParticipantsWindow::createParticipantsView(const int categoryId)
 {
-    for (const auto&[id, name] : modalities) {
-        if (id == modalityId) {
-            return name;
-        }
-    }
-    return QString("ID: %1").arg(modalityId);
+    auto* table = new QTableView();
+
+    auto* filter = new ParticipantsFilterModel(table);
+    filter->setCategoryId(categoryId);
+    filter->setModalityId(modalityFilter->currentData().toInt());
+    filter->setSourceModel(participantsModel);
+    categoryFilters.append(filter);
+
+    table->setModel(filter);
+
+    // Configure table; fixed row heights let the view lay out only the visible rows
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setAlternatingRowColors(true);
+    table->setWordWrap(false);
+    table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    table->horizontalHeader()->setStretchLastSection(true);
+    table->horizontalHeader()->resizeSection(ParticipantsModel::ModalityColumn, 150);
+    table->horizontalHeader()->resizeSection(ParticipantsModel::PlateCodeColumn, 120);
+
+    return table;
 }
 
-QString ParticipantsWindow::getCategoryName(int categoryId)
+void ParticipantsWindow::onModalityFilterChanged(const int index)
 {
-    for (const auto&[id, name] : categories) {
-        if (id == categoryId) {
-            return name;
-        }
+    const int modalityId = modalityFilter->itemData(index).toInt();
+    for (auto* filter : categoryFilters) {
+        filter->setModalityId(modalityId);
     }
-    return QString("ID: %1").arg(categoryId);
 }
 
 void ParticipantsWindow::onCategoryTabChanged(const int index)
@@ -344,4 +178,3 @@ void ParticipantsWindow::onCategoryTabChanged(const int index)
     // Handle tab change if needed
     Q_UNUSED(index);
 }
-
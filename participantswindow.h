@@ -5,7 +5,7 @@
 #include <QTabWidget>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QTableWidget>
+#include <QTableView>
 #include <QLabel>
 #include <QComboBox>
 #include <QPushButton>
@@ -14,11 +14,9 @@
 #include <algorithm>
 #include "dbmanager.h"
 #include "model/trialinfo.h"
-#include "model/registration.h"
-#include "model/athlete.h"
-#include "model/category.h"
-#include "model/modality.h"
+#include "participantsmodel.h"
 #include <QStringList>
+#include <memory>
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class ParticipantsWindow; }
@@ -37,6 +35,7 @@ public:
 private slots:
     void loadParticipants();
     static void onCategoryTabChanged(int index);
+    void onModalityFilterChanged(int index);
 
 private:
     Ui::ParticipantsWindow *ui;
@@ -50,40 +49,24 @@ private:
         QString athleteName;
     } headerFields;
 
-    const QStringList headers = {
-        "Modalidade", 
-        "Código da Placa", 
-        "Nome do Atleta"
-    };
-
-    [[nodiscard]] int getHeaderIndex(const QString& headerName) const {
-        return static_cast<int>(headers.indexOf(headerName));
-    }
-    
     // UI Components
     QTabWidget* tabWidget;
     QVBoxLayout* mainLayout;
     QHBoxLayout* headerLayout;
     QLabel* eventLabel;
+    QComboBox* modalityFilter;
     
-    // Data
+    // Data: one shared model, one filter proxy per category tab
     Trials::TrialInfo currentTrial;
-    QVector<Registrations::Registration> registrations;
-    QVector<Athletes::Athlete> athletes;
-    QVector<Categories::Category> categories;
-    QVector<Modalities::Modality> modalities;
+    std::shared_ptr<const Aggregates::TrialSnapshot> snapshot;
+    ParticipantsModel* participantsModel;
+    QVector<ParticipantsFilterModel*> categoryFilters;
     
     // Methods
     void setupUI();
-    void loadBasicData();
     void createCategoryTabs();
-    void populateTable(QTableWidget* table, const QVector<Registrations::Registration>& categoryRegistrations);
-    void populateCombinationTable(QTableWidget* table, const QVector<Registrations::Registration>& combinationRegistrations);
-    QVector<Registrations::Registration> getRegistrationsByCategory(int categoryId);
-    QVector<Registrations::Registration> getRegistrationsByCategoryAndModality(int categoryId, int modalityId);
-    QString getAthleteName(int athleteId);
-    QString getModalityName(int modalityId);
-    QString getCategoryName(int categoryId);
+    void fillModalityFilter();
+    QTableView* createParticipantsView(int categoryId);
 };
 
 #endif // PARTICIPANTSWINDOW_H
\ No newline at end of file
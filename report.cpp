@@ -1,142 +1,139 @@
 #include "report.h"
-#include "xlsxdocument.h"
+#include <QSaveFile>
 #include <QSqlQuery>
 #include <QString>
 #include <QSqlError>
-#include <QColor>
-#include <algorithm>
 #include "utils/timeutils.h"
+#include "reportsinks.h"
 
 bool Report::exportExcel(const int trialId, const QString& outputFileName, const QSqlDatabase& db) {
+    QSaveFile file(outputFileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Error opening" << outputFileName << file.errorString();
+        return false;
+    }
 
-    //const QString timeFormat = "hh:MM:ss";
-
-    QXlsx::Document xlsx;
-
-    // format
-    QXlsx::Format headerFormat;
-    headerFormat.setFontBold(true);
-    headerFormat.setPatternBackgroundColor(Qt::lightGray);
-    headerFormat.setHorizontalAlignment(QXlsx::Format::AlignHCenter);
-
-    QXlsx::Format zebraWhite;
-    zebraWhite.setPatternBackgroundColor(Qt::white);
-
-    QXlsx::Format zebraGray;
-    zebraGray.setPatternBackgroundColor(QColor(235,235,235));
-
-    QVector<int> colWidth(5, 0);
-
-
-    QSqlQuery groupQuery(db);
-
-    QString sql = R"(
-        SELECT DISTINCT (m.name || ' - ' || c.name) as groupName, c.name as categoryName, m.name as modalityName
-        FROM results r
-        INNER JOIN registrations reg ON r.registrationId = reg.id
-        INNER JOIN categories c ON reg.categoryId = c.id
-        INNER JOIN modalities m ON reg.modalityId = m.id
-        WHERE reg.trialId = :trialId
-        ORDER BY m.name, c.name
-    )";
-
-    groupQuery.prepare(sql);
-    groupQuery.bindValue(":trialId", trialId);
-
-    if (!groupQuery.exec()) {
-        qWarning() << "Error finding groups" << groupQuery.lastError().text();
+    if (auto written = writeExcel(trialId, &file, db); !written) {
+        qWarning() << written.error();
+        file.cancelWriting();
         return false;
     }
 
-    bool firstSheet = true;
-    while(groupQuery.next()) {
-        QString groupName = groupQuery.value(0).toString();
-        if (firstSheet) {
-            xlsx.renameSheet(xlsx.currentSheet()->sheetName(), groupName);
-            firstSheet = false;
-        } else {
-            xlsx.addSheet(groupName);
-        }
+    if (!file.commit()) {
+        qWarning() << "Error saving " << outputFileName << file.errorString();
+        return false;
+    }
+    return true;
+}
 
-        xlsx.selectSheet(groupName);
+tl::expected<qint64, QString> Report::countRows(const int trialId, const QSqlDatabase& db) {
+    // Same rows as the export query: one per plate inside each modality/category group
+    QSqlQuery query(db);
+    query.prepare(R"(
+        SELECT COUNT(*) FROM (
+            SELECT DISTINCT reg.modalityId, reg.categoryId, reg.plateCode
+            FROM results r
+            INNER JOIN registrations reg ON r.registrationId = reg.id
+            INNER JOIN athletes a ON reg.athleteId = a.id
+            INNER JOIN categories c ON reg.categoryId = c.id
+            INNER JOIN modalities m ON reg.modalityId = m.id
+            WHERE reg.trialId = :trialId
+        )
+    )");
+    query.bindValue(":trialId", trialId);
+
+    if (!query.exec() || !query.next()) {
+        return tl::unexpected("Error counting report rows: " + query.lastError().text());
+    }
+    return query.value(0).toLongLong();
+}
 
-        // headers
-        QStringList headers = {"Placa", "Inicio", "Fim", "Duracao", "Notas"};
+tl::expected<qint64, QString> Report::scanRows(const int trialId, const QSqlDatabase& db, const RowVisitor& visitor) {
+    // One ordered scan over the whole trial: rows arrive grouped by modality/category, each
+    // group already sorted by time. Only the latest result of each plate inside a group is kept.
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    query.prepare(R"(
+        SELECT r1.modalityId, r1.categoryId, (m.name || ' - ' || c.name) as groupName,
+               r1.plateCode, r1.startTime, r1.endTime, r1.durationMs, r1.notes
+        FROM (
+            SELECT reg.modalityId, reg.categoryId, reg.plateCode,
+                   r.startTime, r.endTime, r.durationMs, r.notes,
+                   ROW_NUMBER() OVER (
+                       PARTITION BY reg.modalityId, reg.categoryId, reg.plateCode
+                       ORDER BY r.endTime DESC, r.id DESC
+                   ) as rn
+            FROM results r
+            INNER JOIN registrations reg ON r.registrationId = reg.id
+            INNER JOIN athletes a ON reg.athleteId = a.id
+            WHERE reg.trialId = :trialId
+        ) r1
+        INNER JOIN categories c ON r1.categoryId = c.id
+        INNER JOIN modalities m ON r1.modalityId = m.id
+        WHERE r1.rn = 1
+        ORDER BY m.name, c.name, r1.modalityId, r1.categoryId, r1.durationMs
+    )");
+    query.bindValue(":trialId", trialId);
+
+    if (!query.exec()) {
+        return tl::unexpected("Error getting events: " + query.lastError().text());
+    }
 
-        for (int c = 0; c < headers.size(); ++c) {
-            xlsx.write(1, c + 1, headers[c], headerFormat);
-            colWidth[c] = std::max(colWidth[c], static_cast<int>(headers[c].length()));
+    qint64 visited = 0;
+    Row row;
+    while (query.next()) {
+        row.modalityId = query.value(0).toInt();
+        row.categoryId = query.value(1).toInt();
+        row.groupName = query.value(2).toString();
+        row.plateCode = query.value(3).toString();
+        row.startTime = Utils::DateTimeUtils::fromEpochMs(query.value(4));
+        row.endTime = Utils::DateTimeUtils::fromEpochMs(query.value(5));
+        row.durationMs = query.value(6).toInt();
+        row.notes = query.value(7).toString();
+
+        ++visited;
+        if (!visitor(row)) {
+            return tl::unexpected(QString("Report cancelled"));
         }
+    }
+    return visited;
+}
 
-        //freeze first line
-        // xlsx.currentWorksheet()->freezePanes(2,1); // Método não disponível nesta versão da QXlsx
-
-        QString categoryName = groupQuery.value(1).toString();
-        QString modalityName = groupQuery.value(2).toString();
-        
-        QSqlQuery evQuery(db);
-        sql = R"(
-            SELECT r1.plateCode, r1.startTime, r1.endTime, r1.durationMs as duration, r1.notes
-            FROM (
-                SELECT reg.plateCode, r.startTime, r.endTime, r.durationMs, r.notes,
-                       ROW_NUMBER() OVER (PARTITION BY reg.plateCode ORDER BY r.endTime DESC) as rn
-                FROM results r
-                INNER JOIN registrations reg ON r.registrationId = reg.id
-                INNER JOIN athletes a ON reg.athleteId = a.id
-                INNER JOIN categories c ON reg.categoryId = c.id
-                INNER JOIN modalities m ON reg.modalityId = m.id
-                WHERE reg.trialId = :trialId
-                    AND c.name = :categoryName
-                    AND m.name = :modalityName
-            ) r1
-            WHERE r1.rn = 1
-            ORDER BY r1.durationMs
-        )";
-
-        evQuery.prepare(sql);
-        evQuery.bindValue(":trialId", trialId);
-        evQuery.bindValue(":categoryName", categoryName);
-        evQuery.bindValue(":modalityName", modalityName);
+tl::expected<qint64, QString> Report::writeExcel(const int trialId, QIODevice* device, const QSqlDatabase& db,
+                                                 const ProgressCallback& progress) {
 
-        if (!evQuery.exec()) {
-            qWarning() << "Error getting events:" << evQuery.lastError().text();
-            continue;
+    qint64 totalRows = -1;
+    if (progress) {
+        auto counted = countRows(trialId, db);
+        if (!counted) {
+            return tl::unexpected(counted.error());
         }
+        totalRows = counted.value();
+    }
 
-        int row = 2;
-        bool zebra = false;
-        while(evQuery.next()) {
-            //QString duration = QTime::fromString(evQuery.value(3).toString(), Qt::DateFormat);
-            QXlsx::Format& fmt = zebra ? zebraGray : zebraWhite;
-            zebra = !zebra;
-
-            QStringList values{
-                evQuery.value(0).toString(),
-                evQuery.value(1).toString(),
-                evQuery.value(2).toString(),
-                Utils::TimeFormatter::formatTimeShort(evQuery.value(3).toInt()),
-                evQuery.value(4).toString()
-            };
-
-            for (int i = 0; i < values.length(); i++) {
-                const QString& text = values[i];
-                xlsx.write(row, i+1, text, fmt);
-                colWidth[i] = std::max(colWidth[i], static_cast<int>(text.length()));
-            }
+    Reports::XlsxSink sink(device);
+    QString sinkError;
 
-            row++;
+    auto scanned = scanRows(trialId, db, [&](const Row& row) {
+        if (auto written = sink.write(row); !written) {
+            sinkError = written.error();
+            return false;
         }
+        return !progress || sink.rowsWritten() % progressInterval != 0 || progress(sink.rowsWritten(), totalRows);
+    });
+    if (!sinkError.isEmpty()) {
+        return tl::unexpected(sinkError);
+    }
+    if (!scanned) {
+        return tl::unexpected(scanned.error());
+    }
 
-        for (int i = 0; i < colWidth.size(); i++){
-            const int w = static_cast<int>(colWidth[i] * 1.2);
-            xlsx.setColumnWidth(i + 1, w);
-        }
+    if (auto finished = sink.finish(); !finished) {
+        return tl::unexpected(finished.error());
     }
 
-    if (!xlsx.saveAs(outputFileName)) {
-        qWarning() << "Error saving " << outputFileName;
-        return false;
+    if (progress) {
+        progress(sink.rowsWritten(), totalRows);
     }
-    return true;
+    return sink.rowsWritten();
 }
-
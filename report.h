@@ -1,15 +1,48 @@
 #ifndef REPORT_H
 #define REPORT_H
 
+#include <QDateTime>
+#include <QIODevice>
 #include <QString>
 #include <QSqlDatabase>
+#include <functional>
+#include <tl/expected.hpp>
 
 class Report
 {
 public:
     Report() = delete;
 
+    // One report line: the latest result of a plate inside its modality/category group
+    struct Row {
+        int modalityId = 0;
+        int categoryId = 0;
+        QString groupName;      // "modality - category"
+        QString plateCode;
+        QDateTime startTime;
+        QDateTime endTime;
+        int durationMs = 0;
+        QString notes;
+    };
+
+    // Returning false stops the scan
+    using RowVisitor = std::function<bool(const Row& row)>;
+
+    // Called every progressInterval rows and once at the end; returning false cancels the export
+    using ProgressCallback = std::function<bool(qint64 rowsWritten, qint64 totalRows)>;
+
+    static constexpr int progressInterval = 500;
+
+    // Writes to a temporary file that only replaces outputFileName once the workbook is complete
     static bool exportExcel(int trialId, const QString &outputFileName, const QSqlDatabase &db);
+
+    // Number of data rows the report of the trial will have
+    [[nodiscard]] static tl::expected<qint64, QString> countRows(int trialId, const QSqlDatabase &db);
+    // Visits the report rows in a single ordered scan: grouped by modality/category, by time inside each group
+    [[nodiscard]] static tl::expected<qint64, QString> scanRows(int trialId, const QSqlDatabase &db, const RowVisitor &visitor);
+    // Streams the workbook into device; returns the number of data rows written
+    [[nodiscard]] static tl::expected<qint64, QString> writeExcel(int trialId, QIODevice *device, const QSqlDatabase &db,
+                                                                  const ProgressCallback &progress = {});
 };
 
 #endif // REPORT_H
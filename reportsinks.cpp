@@ -0,0 +1,201 @@
+#include "reportsinks.h"
+#include "utils/timeutils.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+
+QString Reports::formatName(const Format format) {
+    switch (format) {
+    case Format::Xlsx: return "Excel (XLSX)";
+    case Format::Csv: return "CSV";
+    case Format::Json: return "JSON";
+    }
+    return {};
+}
+
+QString Reports::fileExtension(const Format format) {
+    switch (format) {
+    case Format::Xlsx: return "xlsx";
+    case Format::Csv: return "csv";
+    case Format::Json: return "json";
+    }
+    return {};
+}
+
+// RowSink
+
+tl::expected<void, QString> Reports::RowSink::write(const Report::Row& row) {
+    if (!m_hasGroup || row.modalityId != m_modalityId || row.categoryId != m_categoryId) {
+        if (auto begun = beginGroup(row); !begun) {
+            return begun;
+        }
+        m_hasGroup = true;
+        m_modalityId = row.modalityId;
+        m_categoryId = row.categoryId;
+    }
+
+    writeRow(row);
+    ++m_rowsWritten;
+    return {};
+}
+
+std::unique_ptr<Reports::RowSink> Reports::RowSink::create(const Format format, QIODevice* device) {
+    switch (format) {
+    case Format::Xlsx: return std::make_unique<XlsxSink>(device);
+    case Format::Csv: return std::make_unique<CsvSink>(device);
+    case Format::Json: return std::make_unique<JsonSink>(device);
+    }
+    return nullptr;
+}
+
+const QStringList& Reports::RowSink::headers() {
+    static const QStringList headers = {"Placa", "Inicio", "Fim", "Duracao", "Notas"};
+    return headers;
+}
+
+QStringList Reports::RowSink::values(const Report::Row& row) {
+    return {
+        row.plateCode,
+        row.startTime.toString(Qt::ISODate),
+        row.endTime.toString(Qt::ISODate),
+        Utils::TimeFormatter::formatTimeShort(row.durationMs),
+        row.notes
+    };
+}
+
+// XlsxSink
+
+Reports::XlsxSink::XlsxSink(QIODevice* device)
+    : m_writer(device) {
+}
+
+tl::expected<void, QString> Reports::XlsxSink::beginGroup(const Report::Row& firstRow) {
+    // Column widths are fixed since the rows are not kept to measure them
+    static const QVector<double> columnWidths = {10, 22, 22, 12, 30};
+
+    if (m_writer.sheetCount() > 0) {
+        if (auto closed = m_writer.endSheet(); !closed) {
+            return closed;
+        }
+    }
+    if (auto begun = m_writer.beginSheet(firstRow.groupName, columnWidths); !begun) {
+        return begun;
+    }
+    m_writer.writeHeaderRow(headers());
+    m_zebra = false;
+    return {};
+}
+
+void Reports::XlsxSink::writeRow(const Report::Row& row) {
+    m_writer.writeRow(values(row), m_zebra ? Utils::XlsxStreamWriter::ZebraGrayStyle : Utils::XlsxStreamWriter::ZebraWhiteStyle);
+    m_zebra = !m_zebra;
+}
+
+tl::expected<void, QString> Reports::XlsxSink::finish() {
+    return m_writer.finish();
+}
+
+// TextSink
+
+Reports::TextSink::TextSink(QIODevice* device)
+    : m_device(device) {
+    m_buffer.reserve(flushThreshold + 4096);
+}
+
+void Reports::TextSink::append(const QByteArray& data) {
+    m_buffer += data;
+    if (m_buffer.size() >= flushThreshold) {
+        (void)flush();
+    }
+}
+
+tl::expected<void, QString> Reports::TextSink::flush() {
+    if (m_error.isEmpty() && !m_buffer.isEmpty() && m_device->write(m_buffer) != m_buffer.size()) {
+        m_error = "Error writing report: " + m_device->errorString();
+    }
+    m_buffer.clear();
+
+    if (!m_error.isEmpty()) {
+        return tl::unexpected(m_error);
+    }
+    return {};
+}
+
+// CsvSink
+
+Reports::CsvSink::CsvSink(QIODevice* device)
+    : TextSink(device) {
+    QByteArray header = "\xEF\xBB\xBF" "Grupo";
+    for (const auto& title : headers()) {
+        header += ',' + field(title);
+    }
+    append(header + "\r\n");
+}
+
+tl::expected<void, QString> Reports::CsvSink::beginGroup(const Report::Row& firstRow) {
+    m_group = field(firstRow.groupName);
+    return {};
+}
+
+void Reports::CsvSink::writeRow(const Report::Row& row) {
+    QByteArray line = m_group;
+    for (const auto& value : values(row)) {
+        line += ',' + field(value);
+    }
+    append(line + "\r\n");
+}
+
+tl::expected<void, QString> Reports::CsvSink::finish() {
+    return flush();
+}
+
+QByteArray Reports::CsvSink::field(const QString& text) {
+    QByteArray utf8 = text.toUtf8();
+    if (!utf8.contains(',') && !utf8.contains('"') && !utf8.contains('\n') && !utf8.contains('\r')) {
+        return utf8;
+    }
+    utf8.replace("\"", "\"\"");
+    return '"' + utf8 + '"';
+}
+
+// JsonSink
+
+Reports::JsonSink::JsonSink(QIODevice* device)
+    : TextSink(device) {
+    append("{\"groups\":[");
+}
+
+tl::expected<void, QString> Reports::JsonSink::beginGroup(const Report::Row& firstRow) {
+    const QJsonObject group {
+        { "name", firstRow.groupName },
+        { "modalityId", firstRow.modalityId },
+        { "categoryId", firstRow.categoryId }
+    };
+
+    // The group object is left open so its rows can be streamed into it
+    QByteArray json = QJsonDocument(group).toJson(QJsonDocument::Compact);
+    json.chop(1);
+    append((m_groupOpen ? "]}," : "") + json + ",\"rows\":[");
+
+    m_groupOpen = true;
+    m_firstRowInGroup = true;
+    return {};
+}
+
+void Reports::JsonSink::writeRow(const Report::Row& row) {
+    const QJsonObject object {
+        { "plateCode", row.plateCode },
+        { "startTime", row.startTime.toString(Qt::ISODateWithMs) },
+        { "endTime", row.endTime.toString(Qt::ISODateWithMs) },
+        { "durationMs", row.durationMs },
+        { "duration", Utils::TimeFormatter::formatTimeShort(row.durationMs) },
+        { "notes", row.notes }
+    };
+
+    append((m_firstRowInGroup ? "" : ",") + QJsonDocument(object).toJson(QJsonDocument::Compact));
+    m_firstRowInGroup = false;
+}
+
+tl::expected<void, QString> Reports::JsonSink::finish() {
+    append(m_groupOpen ? "]}]}\n" : "]}\n");
+    return flush();
+}
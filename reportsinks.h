@@ -0,0 +1,125 @@
+#ifndef REPORTSINKS_H
+#define REPORTSINKS_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <tl/expected.hpp>
+#include "report.h"
+#include "utils/xlsxstreamwriter.h"
+
+namespace Reports {
+
+enum class Format {
+    Xlsx,
+    Csv,
+    Json
+};
+
+[[nodiscard]] QString formatName(Format format);
+[[nodiscard]] QString fileExtension(Format format);
+
+// Destination of the report rows. Rows must arrive in Report::scanRows order;
+// a new group (sheet, JSON section) starts whenever the modality/category changes.
+class RowSink
+{
+public:
+    virtual ~RowSink() = default;
+
+    [[nodiscard]] tl::expected<void, QString> write(const Report::Row& row);
+    // Completes the document; nothing may be written afterwards
+    [[nodiscard]] virtual tl::expected<void, QString> finish() = 0;
+
+    [[nodiscard]] qint64 rowsWritten() const { return m_rowsWritten; }
+
+    [[nodiscard]] static std::unique_ptr<RowSink> create(Format format, QIODevice* device);
+
+protected:
+    static const QStringList& headers();
+    static QStringList values(const Report::Row& row);
+
+    [[nodiscard]] virtual tl::expected<void, QString> beginGroup(const Report::Row& firstRow) = 0;
+    virtual void writeRow(const Report::Row& row) = 0;
+
+private:
+    bool m_hasGroup = false;
+    int m_modalityId = 0;
+    int m_categoryId = 0;
+    qint64 m_rowsWritten = 0;
+};
+
+// One sheet per group, zebra rows
+class XlsxSink final : public RowSink
+{
+public:
+    explicit XlsxSink(QIODevice* device);
+
+    [[nodiscard]] tl::expected<void, QString> finish() override;
+
+protected:
+    [[nodiscard]] tl::expected<void, QString> beginGroup(const Report::Row& firstRow) override;
+    void writeRow(const Report::Row& row) override;
+
+private:
+    Utils::XlsxStreamWriter m_writer;
+    bool m_zebra = false;
+};
+
+// Text formats buffer their output and write it to the device in large chunks
+class TextSink : public RowSink
+{
+public:
+    explicit TextSink(QIODevice* device);
+
+protected:
+    void append(const QByteArray& data);
+    [[nodiscard]] tl::expected<void, QString> flush();
+
+private:
+    static constexpr qsizetype flushThreshold = 64 * 1024;
+
+    QIODevice* m_device;
+    QByteArray m_buffer;
+    QString m_error;
+};
+
+// RFC 4180, UTF-8 with BOM so spreadsheets detect the encoding; the group is the first column
+class CsvSink final : public TextSink
+{
+public:
+    explicit CsvSink(QIODevice* device);
+
+    [[nodiscard]] tl::expected<void, QString> finish() override;
+
+protected:
+    [[nodiscard]] tl::expected<void, QString> beginGroup(const Report::Row& firstRow) override;
+    void writeRow(const Report::Row& row) override;
+
+private:
+    QByteArray m_group;
+
+    static QByteArray field(const QString& text);
+};
+
+// {"groups": [{"name", "modalityId", "categoryId", "rows": [...]}, ...]}
+class JsonSink final : public TextSink
+{
+public:
+    explicit JsonSink(QIODevice* device);
+
+    [[nodiscard]] tl::expected<void, QString> finish() override;
+
+protected:
+    [[nodiscard]] tl::expected<void, QString> beginGroup(const Report::Row& firstRow) override;
+    void writeRow(const Report::Row& row) override;
+
+private:
+    bool m_groupOpen = false;
+    bool m_firstRowInGroup = true;
+};
+
+};
+
+#endif // REPORTSINKS_H
@@ -0,0 +1,79 @@
+#include "reportworker.h"
+#include "report.h"
+#include <QSaveFile>
+#include <QSqlError>
+#include <QUuid>
+#include <QDebug>
+
+ReportWorker::ReportWorker(const QString& databasePath, const DBPerformanceProfile& profile, const int trialId,
+                           const QString& outputFileName, QObject* parent)
+    : QThread(parent)
+    , m_databasePath(databasePath)
+    , m_profile(profile)
+    , m_trialId(trialId)
+    , m_outputFileName(outputFileName)
+    , m_connectionName("report-" + QUuid::createUuid().toString(QUuid::WithoutBraces)) {
+}
+
+ReportWorker::~ReportWorker() {
+    cancel();
+    wait();
+}
+
+void ReportWorker::cancel() {
+    m_cancelled.store(true, std::memory_order_relaxed);
+}
+
+void ReportWorker::run() {
+    {
+        auto opened = DBManager::openReader(m_connectionName, m_databasePath, m_profile);
+        if (opened.has_value()) {
+            QSqlDatabase& db = opened.value();
+            exportReport(db);
+            db.close();
+        } else {
+            emit reportFailed("[RW] " + opened.error());
+        }
+    }
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+void ReportWorker::exportReport(QSqlDatabase& db) {
+    QSaveFile file(m_outputFileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        emit reportFailed("[RW] Error opening " + m_outputFileName + ": " + file.errorString());
+        return;
+    }
+
+    // The count and the export read the same snapshot
+    if (!db.transaction()) {
+        emit reportFailed("[RW] Error starting read transaction: " + db.lastError().text());
+        return;
+    }
+
+    const auto written = Report::writeExcel(m_trialId, &file, db, [this](const qint64 rowsWritten, const qint64 totalRows) {
+        emit progressChanged(rowsWritten, totalRows);
+        return !isCancelled();
+    });
+    db.rollback();
+
+    if (isCancelled()) {
+        file.cancelWriting();
+        emit reportCancelled();
+        return;
+    }
+
+    if (!written) {
+        file.cancelWriting();
+        emit reportFailed("[RW] " + written.error());
+        return;
+    }
+
+    if (!file.commit()) {
+        emit reportFailed("[RW] Error saving " + m_outputFileName + ": " + file.errorString());
+        return;
+    }
+
+    qInfo() << "[RW] Report of trial" << m_trialId << "written to" << m_outputFileName << "-" << written.value() << "row(s)";
+    emit reportFinished(m_outputFileName, written.value());
+}
@@ -0,0 +1,50 @@
+#ifndef REPORTWORKER_H
+#define REPORTWORKER_H
+
+#include <QThread>
+#include <QString>
+#include <atomic>
+#include "dbmanager.h"
+
+// Generates the Excel report of a trial off the GUI thread.
+// The worker opens its own read-only connection and reads everything inside one
+// read transaction, i.e. one WAL snapshot: the journal keeps committing finishes
+// while the export runs and the report stays consistent. The workbook is written
+// to a temporary file that only replaces the target when it is complete.
+class ReportWorker : public QThread
+{
+    Q_OBJECT
+
+public:
+    ReportWorker(const QString& databasePath, const DBPerformanceProfile& profile, int trialId,
+                 const QString& outputFileName, QObject* parent = nullptr);
+    ~ReportWorker() override;
+
+    [[nodiscard]] const QString& outputFileName() const { return m_outputFileName; }
+    [[nodiscard]] bool isCancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+public slots:
+    // Thread-safe; the export stops at the next progress checkpoint and the target file is left untouched
+    void cancel();
+
+signals:
+    void progressChanged(qint64 rowsWritten, qint64 totalRows);
+    void reportFinished(const QString& fileName, qint64 rowsWritten);
+    void reportFailed(const QString& error);
+    void reportCancelled();
+
+protected:
+    void run() override;
+
+private:
+    QString m_databasePath;
+    DBPerformanceProfile m_profile;
+    int m_trialId;
+    QString m_outputFileName;
+    QString m_connectionName;
+    std::atomic<bool> m_cancelled { false };
+
+    void exportReport(QSqlDatabase& db);
+};
+
+#endif // REPORTWORKER_H
@@ -1,28 +1,9 @@
 #include "athletesrepository.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include "dbmanager.h"
 
 Athletes::Repository::Repository(const QSqlDatabase& db) : m_db(db) {
-    if (auto value = createAthletesTable(); !value) {
-        qFatal("Athletes table creation failed: %s", value.error().toLocal8Bit().constData());
-    }
-}
-
-tl::expected<void, QString> Athletes::Repository::createAthletesTable() const {
-    QSqlQuery query(m_db);
-
-    const QString sql = R"(
-        CREATE TABLE IF NOT EXISTS athletes (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            name TEXT NOT NULL
-        );
-    )";
-
-    if (!query.exec(sql)) {
-        return tl::unexpected("[AR] Error creating athletes:"  + query.lastError().text());
-    }
-
-    return {};
 }
 
 tl::expected<Athletes::Athlete, QString> Athletes::Repository::createAthlete(const QString& name) const {
@@ -30,16 +11,15 @@ tl::expected<Athletes::Athlete, QString> Athletes::Repository::createAthlete(con
         return tl::unexpected("[AR]: invalid name");
     }
 
-    QSqlQuery queryInsert(m_db);
     QString sql = R"(
         INSERT OR IGNORE INTO athletes(name) VALUES(:name)
     )";
 
-    queryInsert.prepare(sql);
-    queryInsert.bindValue(":name", name.trimmed());
+    auto queryInsert = DBManager::statement(m_db, sql);
+    queryInsert->bindValue(":name", name.trimmed());
 
-    if (!queryInsert.exec()) {
-        return tl::unexpected("[AR]: Error inserting " + name + " into athletes table. Error: " + queryInsert.lastError().text());
+    if (!queryInsert->exec()) {
+        return tl::unexpected("[AR]: Error inserting " + name + " into athletes table. Error: " + queryInsert->lastError().text());
     }
 
     sql = R"(
@@ -50,17 +30,16 @@ tl::expected<Athletes::Athlete, QString> Athletes::Repository::createAthlete(con
         WHERE name = :name
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
-    querySelect.bindValue(":name", name.trimmed());
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":name", name.trimmed());
 
-    if (!querySelect.exec() || !querySelect.next()) {
-        return tl::unexpected("[AR]: Error fetching '" + name + "' from athletes table. Error: " + querySelect.lastError().text());
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[AR]: Error fetching '" + name + "' from athletes table. Error: " + querySelect->lastError().text());
     }
 
     return (Athletes::Athlete) {
-        .id = querySelect.value(0).toInt(),
-        .name = querySelect.value(1).toString()
+        .id = querySelect->value(0).toInt(),
+        .name = querySelect->value(1).toString()
     };
 }
 
@@ -73,22 +52,20 @@ tl::expected<Athletes::Athlete, QString> Athletes::Repository::getAthleteById(co
         WHERE id = :id
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
-    querySelect.bindValue(":id", id);
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":id", id);
 
-    if (!querySelect.exec() || !querySelect.next()) {
-        return tl::unexpected("[AR]: Error fetching '" + QString::number(id) + "' from athletes table. Error: " + querySelect.lastError().text());
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[AR]: Error fetching '" + QString::number(id) + "' from athletes table. Error: " + querySelect->lastError().text());
     }
 
     return (Athletes::Athlete) {
         .id = id,
-        .name = querySelect.value(0).toString()
+        .name = querySelect->value(0).toString()
     };
 }
 
 tl::expected<Athletes::Athlete, QString> Athletes::Repository::getAthleteByName(const QString& name) const {
-    QSqlQuery querySelect(m_db);
     const QString sql = R"(
         SELECT
             id
@@ -96,16 +73,16 @@ tl::expected<Athletes::Athlete, QString> Athletes::Repository::getAthleteByName(
         WHERE name = :name
     )";
 
-    querySelect.prepare(sql);
-    querySelect.bindValue(":name", name);
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":name", name);
 
-    if (!querySelect.exec()) {
-        return tl::unexpected("[AR]: Error fetching '" + name + "' from athletes table. Error: " + querySelect.lastError().text());
+    if (!querySelect->exec()) {
+        return tl::unexpected("[AR]: Error fetching '" + name + "' from athletes table. Error: " + querySelect->lastError().text());
     }
 
-    if (querySelect.next()) {
+    if (querySelect->next()) {
         return (Athletes::Athlete) {
-            .id = querySelect.value(0).toInt(),
+            .id = querySelect->value(0).toInt(),
             .name = name
         };
     }
@@ -114,7 +91,6 @@ tl::expected<Athletes::Athlete, QString> Athletes::Repository::getAthleteByName(
 }
 
 tl::expected<QVector<Athletes::Athlete>, QString> Athletes::Repository::getAllAthletes() const {
-    QSqlQuery querySelect(m_db);
     const QString sql = R"(
         SELECT
             id,
@@ -123,15 +99,16 @@ tl::expected<QVector<Athletes::Athlete>, QString> Athletes::Repository::getAllAt
     )";
 
 
-    if (!querySelect.exec(sql)) {
-        return tl::unexpected("[AR]: Error fetching registers from athletes table. Error: " + querySelect.lastError().text());
+    auto querySelect = DBManager::statement(m_db, sql);
+    if (!querySelect->exec()) {
+        return tl::unexpected("[AR]: Error fetching registers from athletes table. Error: " + querySelect->lastError().text());
     }
 
     QVector<Athletes::Athlete> results;
-    while (querySelect.next()) {
+    while (querySelect->next()) {
         results.push_back({
-            .id = querySelect.value(0).toInt(),
-            .name = querySelect.value(1).toString()
+            .id = querySelect->value(0).toInt(),
+            .name = querySelect->value(1).toString()
         });
     }
 
@@ -144,36 +121,34 @@ tl::expected<Athletes::Athlete, QString> Athletes::Repository::updateAthleteById
         return tl::unexpected("[AR]: invalid name");
     }
 
-    QSqlQuery queryUpdate(m_db);
     const QString sql = R"(
         UPDATE athletes
         SET name = :name
         WHERE id = :id
     )";
 
-    queryUpdate.prepare(sql);
-    queryUpdate.bindValue(":id", id);
-    queryUpdate.bindValue(":name", athlete.name);
+    auto queryUpdate = DBManager::statement(m_db, sql);
+    queryUpdate->bindValue(":id", id);
+    queryUpdate->bindValue(":name", athlete.name);
 
-    if (!queryUpdate.exec()) {
-        return tl::unexpected("[AR]: Error updating '" + QString::number(athlete.id) + "'entry on athletes table. Error: " + queryUpdate.lastError().text());
+    if (!queryUpdate->exec()) {
+        return tl::unexpected("[AR]: Error updating '" + QString::number(athlete.id) + "'entry on athletes table. Error: " + queryUpdate->lastError().text());
     }
 
     return athlete;
 }
 
 tl::expected<int, QString> Athletes::Repository::deleteAthleteById(const int id) const {
-    QSqlQuery queryUpdate(m_db);
     const QString sql = R"(
         DELETE FROM athletes
         WHERE id = :id
     )";
 
-    queryUpdate.prepare(sql);
-    queryUpdate.bindValue(":id", id);
+    auto queryUpdate = DBManager::statement(m_db, sql);
+    queryUpdate->bindValue(":id", id);
 
-    if (!queryUpdate.exec()) {
-        return tl::unexpected("[AR]: Error updating '" + QString::number(id) + "'entry on athletes table. Error: " + queryUpdate.lastError().text());
+    if (!queryUpdate->exec()) {
+        return tl::unexpected("[AR]: Error updating '" + QString::number(id) + "'entry on athletes table. Error: " + queryUpdate->lastError().text());
     }
 
     return id;
@@ -24,7 +24,6 @@ public:
 
 private:
     QSqlDatabase m_db;
-    [[nodiscard]] tl::expected<void, QString> createAthletesTable() const;
 };
 
 };
@@ -1,28 +1,10 @@
 #include "categoriesrepository.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include "dbmanager.h"
+#include "utils/interning.h"
 
 Categories::Repository::Repository(const QSqlDatabase& db) : m_db(db) {
-    if (auto value = createCategoriesTable(); !value) {
-        qFatal("Categories table creation failed: %s", value.error().toLocal8Bit().constData());
-    }
-}
-
-tl::expected<void, QString> Categories::Repository::createCategoriesTable() const {
-    QSqlQuery query(m_db);
-
-    const QString sql = R"(
-        CREATE TABLE IF NOT EXISTS categories (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            name TEXT NOT NULL UNIQUE
-        );
-    )";
-
-    if (!query.exec(sql)) {
-        return tl::unexpected("[CR] Error creating categories:"  + query.lastError().text());
-    }
-
-    return {};
 }
 
 tl::expected<Categories::Category, QString> Categories::Repository::createCategory(const QString& name) const {
@@ -30,16 +12,15 @@ tl::expected<Categories::Category, QString> Categories::Repository::createCatego
         return tl::unexpected("[CR]: invalid name");
     }
 
-    QSqlQuery queryInsert(m_db);
     QString sql = R"(
         INSERT OR IGNORE INTO categories(name) VALUES(:name)
     )";
 
-    queryInsert.prepare(sql);
-    queryInsert.bindValue(":name", name.trimmed());
+    auto queryInsert = DBManager::statement(m_db, sql);
+    queryInsert->bindValue(":name", name.trimmed());
 
-    if (!queryInsert.exec()) {
-        return tl::unexpected("[CR]: Error inserting " + name + " into categories table. Error: " + queryInsert.lastError().text());
+    if (!queryInsert->exec()) {
+        return tl::unexpected("[CR]: Error inserting " + name + " into categories table. Error: " + queryInsert->lastError().text());
     }
 
     sql = R"(
@@ -50,17 +31,16 @@ tl::expected<Categories::Category, QString> Categories::Repository::createCatego
         WHERE name = :name
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
-    querySelect.bindValue(":name", name.trimmed());
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":name", name.trimmed());
 
-    if (!querySelect.exec() || !querySelect.next()) {
-        return tl::unexpected("[CR]: Error fetching '" + name + "' from categories table. Error: " + querySelect.lastError().text());
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[CR]: Error fetching '" + name + "' from categories table. Error: " + querySelect->lastError().text());
     }
 
     return (Categories::Category) {
-        .id = querySelect.value(0).toInt(),
-        .name = querySelect.value(1).toString()
+        .id = querySelect->value(0).toInt(),
+        .name = querySelect->value(1).toString()
     };
 }
 
@@ -72,23 +52,21 @@ tl::expected<Categories::Category, QString> Categories::Repository::getCategoryB
         WHERE id = :id
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
-    querySelect.bindValue(":id", id);
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":id", id);
 
-    if (!querySelect.exec() || !querySelect.next()) {
-        return tl::unexpected("[CR]: Error fetching '" + QString::number(id) + "' from categories table. Error: " + querySelect.lastError().text());
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[CR]: Error fetching '" + QString::number(id) + "' from categories table. Error: " + querySelect->lastError().text());
     }
 
     return (Categories::Category) {
         .id = id,
-        .name = querySelect.value(0).toString()
+        .name = Utils::NamePool::categories().resolve(id, [&querySelect]() { return querySelect->value(0).toString(); })
     };
 
 }
 
 tl::expected<Categories::Category, QString> Categories::Repository::getCategoryByName(const QString& name) const {
-    QSqlQuery querySelect(m_db);
     const QString sql = R"(
         SELECT
             id
@@ -96,21 +74,20 @@ tl::expected<Categories::Category, QString> Categories::Repository::getCategoryB
         WHERE name = :name
     )";
 
-    querySelect.prepare(sql);
-    querySelect.bindValue(":name", name);
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":name", name);
 
-    if (!querySelect.exec() || !querySelect.next()) {
-        return tl::unexpected("[CR]: Error fetching '" + name + "' from categories table. Error: " + querySelect.lastError().text());
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[CR]: Error fetching '" + name + "' from categories table. Error: " + querySelect->lastError().text());
     }
 
     return (Categories::Category) {
-        .id = querySelect.value(0).toInt(),
+        .id = querySelect->value(0).toInt(),
         .name = name
     };
 }
 
 tl::expected<QVector<Categories::Category>, QString> Categories::Repository::getAllCategories() const {
-    QSqlQuery querySelect(m_db);
     const QString sql = R"(
         SELECT
             id,
@@ -118,15 +95,17 @@ tl::expected<QVector<Categories::Category>, QString> Categories::Repository::get
         FROM categories
     )";
 
-    if (!querySelect.exec(sql)) {
-        return tl::unexpected("[CR]: Error fetching registers from categories table. Error: " + querySelect.lastError().text());
+    auto querySelect = DBManager::statement(m_db, sql);
+    if (!querySelect->exec()) {
+        return tl::unexpected("[CR]: Error fetching registers from categories table. Error: " + querySelect->lastError().text());
     }
 
     QVector<Categories::Category> results;
-    while (querySelect.next()) {
+    while (querySelect->next()) {
+        const int id = querySelect->value(0).toInt();
         results.push_back({
-            .id = querySelect.value(0).toInt(),
-            .name = querySelect.value(1).toString()
+            .id = id,
+            .name = Utils::NamePool::categories().resolve(id, [&querySelect]() { return querySelect->value(1).toString(); })
         });
     }
 
@@ -137,38 +116,38 @@ tl::expected<Categories::Category, QString> Categories::Repository::updateCatego
         return tl::unexpected("[CR]: invalid name");
     }
 
-    QSqlQuery queryUpdate(m_db);
     const QString sql = R"(
         UPDATE categories
         SET name = :name
         WHERE id = :id
     )";
 
-    queryUpdate.prepare(sql);
-    queryUpdate.bindValue(":name", category.name);
-    queryUpdate.bindValue(":id", id);
+    auto queryUpdate = DBManager::statement(m_db, sql);
+    queryUpdate->bindValue(":name", category.name);
+    queryUpdate->bindValue(":id", id);
 
-    if (!queryUpdate.exec()) {
-        return tl::unexpected("[CR]: Error updating '" + QString::number(id) + "'entry on categories table. Error: " + queryUpdate.lastError().text());
+    if (!queryUpdate->exec()) {
+        return tl::unexpected("[CR]: Error updating '" + QString::number(id) + "'entry on categories table. Error: " + queryUpdate->lastError().text());
     }
 
+    Utils::NamePool::categories().insert(id, category.name);
     return category;
 }
 
 tl::expected<int, QString> Categories::Repository::deleteCategoryById(const int id) const {
-    QSqlQuery queryUpdate(m_db);
     const QString sql = R"(
         DELETE FROM categories
         WHERE id = :id
     )";
 
-    queryUpdate.prepare(sql);
-    queryUpdate.bindValue(":id", id);
+    auto queryUpdate = DBManager::statement(m_db, sql);
+    queryUpdate->bindValue(":id", id);
 
-    if (!queryUpdate.exec()) {
-        return tl::unexpected("[CR]: Error updating '" + QString::number(id) + "'entry on categories table. Error: " + queryUpdate.lastError().text());
+    if (!queryUpdate->exec()) {
+        return tl::unexpected("[CR]: Error updating '" + QString::number(id) + "'entry on categories table. Error: " + queryUpdate->lastError().text());
     }
 
+    Utils::NamePool::categories().remove(id);
     return id;
 }
 
@@ -0,0 +1,264 @@
+#include "checkpointsrepository.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include "dbmanager.h"
+#include "utils/timeutils.h"
+
+Checkpoints::Repository::Repository(const QSqlDatabase& db) : m_db(db) {
+}
+
+tl::expected<Checkpoints::Checkpoint, QString> Checkpoints::Repository::createCheckpoint(
+    const int trialId,
+    const QString& code,
+    const QString& name,
+    const int sequence,
+    const int distanceM) const {
+
+    if (code.trimmed().isEmpty()) {
+        return tl::unexpected("[KR] Invalid checkpoint code");
+    }
+
+    const QString sql = R"(
+        INSERT INTO checkpoints(trialId, code, name, sequence, distanceM)
+        VALUES(:trialId, :code, :name, :sequence, :distanceM)
+    )";
+
+    auto queryInsert = DBManager::statement(m_db, sql);
+    queryInsert->bindValue(":trialId", trialId);
+    queryInsert->bindValue(":code", code.trimmed());
+    queryInsert->bindValue(":name", name.trimmed());
+    queryInsert->bindValue(":sequence", sequence);
+    queryInsert->bindValue(":distanceM", distanceM > 0 ? QVariant(distanceM) : QVariant());
+
+    if (!queryInsert->exec()) {
+        return tl::unexpected("[KR] Error inserting checkpoint " + code + ": " + queryInsert->lastError().text());
+    }
+
+    return (Checkpoint) {
+        .id = queryInsert->lastInsertId().toInt(),
+        .trialId = trialId,
+        .code = code.trimmed(),
+        .name = name.trimmed(),
+        .sequence = sequence,
+        .distanceM = distanceM
+    };
+}
+
+tl::expected<Checkpoints::Checkpoint, QString> Checkpoints::Repository::getCheckpointById(const int id) const {
+    const QString sql = R"(
+        SELECT trialId, code, name, sequence, distanceM
+        FROM checkpoints
+        WHERE id = :id
+    )";
+
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":id", id);
+
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[KR] Error fetching checkpoint " + QString::number(id) + ": " + querySelect->lastError().text());
+    }
+
+    return (Checkpoint) {
+        .id = id,
+        .trialId = querySelect->value(0).toInt(),
+        .code = querySelect->value(1).toString(),
+        .name = querySelect->value(2).toString(),
+        .sequence = querySelect->value(3).toInt(),
+        .distanceM = querySelect->value(4).toInt()
+    };
+}
+
+tl::expected<Checkpoints::Checkpoint, QString> Checkpoints::Repository::getCheckpointByCode(const int trialId, const QString& code) const {
+    const QString sql = R"(
+        SELECT id, name, sequence, distanceM
+        FROM checkpoints
+        WHERE trialId = :trialId AND code = :code
+    )";
+
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":trialId", trialId);
+    querySelect->bindValue(":code", code.trimmed());
+
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[KR] Error fetching checkpoint '" + code + "': " + querySelect->lastError().text());
+    }
+
+    return (Checkpoint) {
+        .id = querySelect->value(0).toInt(),
+        .trialId = trialId,
+        .code = code.trimmed(),
+        .name = querySelect->value(1).toString(),
+        .sequence = querySelect->value(2).toInt(),
+        .distanceM = querySelect->value(3).toInt()
+    };
+}
+
+tl::expected<QVector<Checkpoints::Checkpoint>, QString> Checkpoints::Repository::getCheckpointsByTrial(const int trialId) const {
+    const QString sql = R"(
+        SELECT id, code, name, sequence, distanceM
+        FROM checkpoints
+        WHERE trialId = :trialId
+        ORDER BY sequence, id
+    )";
+
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":trialId", trialId);
+
+    if (!querySelect->exec()) {
+        return tl::unexpected("[KR] Error fetching checkpoints of trial " + QString::number(trialId) + ": " + querySelect->lastError().text());
+    }
+
+    QVector<Checkpoint> checkpoints;
+    while (querySelect->next()) {
+        checkpoints.append({
+            .id = querySelect->value(0).toInt(),
+            .trialId = trialId,
+            .code = querySelect->value(1).toString(),
+            .name = querySelect->value(2).toString(),
+            .sequence = querySelect->value(3).toInt(),
+            .distanceM = querySelect->value(4).toInt()
+        });
+    }
+    return checkpoints;
+}
+
+tl::expected<Checkpoints::Checkpoint, QString> Checkpoints::Repository::updateCheckpointById(const int id, const Checkpoint& checkpoint) const {
+    const QString sql = R"(
+        UPDATE checkpoints
+        SET code = :code, name = :name, sequence = :sequence, distanceM = :distanceM
+        WHERE id = :id
+    )";
+
+    auto queryUpdate = DBManager::statement(m_db, sql);
+    queryUpdate->bindValue(":code", checkpoint.code.trimmed());
+    queryUpdate->bindValue(":name", checkpoint.name.trimmed());
+    queryUpdate->bindValue(":sequence", checkpoint.sequence);
+    queryUpdate->bindValue(":distanceM", checkpoint.distanceM > 0 ? QVariant(checkpoint.distanceM) : QVariant());
+    queryUpdate->bindValue(":id", id);
+
+    if (!queryUpdate->exec()) {
+        return tl::unexpected("[KR] Error updating checkpoint " + QString::number(id) + ": " + queryUpdate->lastError().text());
+    }
+    if (queryUpdate->numRowsAffected() == 0) {
+        return tl::unexpected("[KR] Checkpoint " + QString::number(id) + " not found");
+    }
+
+    return getCheckpointById(id);
+}
+
+tl::expected<int, QString> Checkpoints::Repository::deleteCheckpointById(const int id) const {
+    const QString sql = R"(
+        DELETE FROM checkpoints WHERE id = :id
+    )";
+
+    auto queryDelete = DBManager::statement(m_db, sql);
+    queryDelete->bindValue(":id", id);
+
+    if (!queryDelete->exec()) {
+        return tl::unexpected("[KR] Error deleting checkpoint " + QString::number(id) + ": " + queryDelete->lastError().text());
+    }
+    return queryDelete->numRowsAffected();
+}
+
+tl::expected<QVector<Checkpoints::Crossing>, QString> Checkpoints::Repository::appendCrossings(const QVector<Crossing>& crossings, QSqlError* sqlError) const {
+    if (crossings.isEmpty()) {
+        return QVector<Crossing>();
+    }
+
+    QSqlDatabase db = m_db;
+    if (!db.transaction()) {
+        if (sqlError) {
+            *sqlError = db.lastError();
+        }
+        return tl::unexpected("[KR] Error starting transaction: " + db.lastError().text());
+    }
+
+    // Replays are absorbed by the primary key and the eventId unique index
+    const QString sql = R"(
+        INSERT OR IGNORE INTO crossings(checkpointId, elapsedMs, registrationId, capturedAt, eventId)
+        VALUES(:checkpointId, :elapsedMs, :registrationId, :capturedAt, :eventId)
+    )";
+
+    auto queryInsert = DBManager::statement(db, sql);
+
+    QVector<Crossing> inserted;
+    inserted.reserve(crossings.size());
+
+    for (const auto& crossing : crossings) {
+        queryInsert->bindValue(":checkpointId", crossing.checkpointId);
+        queryInsert->bindValue(":elapsedMs", crossing.elapsedMs);
+        queryInsert->bindValue(":registrationId", crossing.registrationId);
+        queryInsert->bindValue(":capturedAt", crossing.capturedAt.isValid() ? QVariant(crossing.capturedAt.toMSecsSinceEpoch()) : QVariant());
+        queryInsert->bindValue(":eventId", crossing.eventId.isEmpty() ? QVariant() : QVariant(crossing.eventId));
+
+        if (!queryInsert->exec()) {
+            const QSqlError error = queryInsert->lastError();
+            db.rollback();
+            if (sqlError) {
+                *sqlError = error;
+            }
+            return tl::unexpected("[KR] Error inserting crossing for registration " + QString::number(crossing.registrationId) + ": " + error.text());
+        }
+
+        if (queryInsert->numRowsAffected() > 0) {
+            inserted.push_back(crossing);
+        }
+    }
+
+    if (!db.commit()) {
+        const QSqlError error = db.lastError();
+        db.rollback();
+        if (sqlError) {
+            *sqlError = error;
+        }
+        return tl::unexpected("[KR] Error committing crossings: " + error.text());
+    }
+
+    return inserted;
+}
+
+tl::expected<QVector<Checkpoints::Crossing>, QString> Checkpoints::Repository::getCrossingsByRegistration(const int registrationId) const {
+    const QString sql = R"(
+        SELECT x.checkpointId, x.elapsedMs, x.capturedAt, x.eventId
+        FROM crossings x
+        JOIN checkpoints cp ON cp.id = x.checkpointId
+        WHERE x.registrationId = :registrationId
+        ORDER BY cp.sequence, x.elapsedMs
+    )";
+
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":registrationId", registrationId);
+
+    if (!querySelect->exec()) {
+        return tl::unexpected("[KR] Error fetching crossings of registration " + QString::number(registrationId) + ": " + querySelect->lastError().text());
+    }
+
+    QVector<Crossing> crossings;
+    while (querySelect->next()) {
+        crossings.append({
+            .registrationId = registrationId,
+            .checkpointId = querySelect->value(0).toInt(),
+            .elapsedMs = querySelect->value(1).toInt(),
+            .capturedAt = Utils::DateTimeUtils::fromEpochMs(querySelect->value(2)),
+            .eventId = querySelect->value(3).toString()
+        });
+    }
+    return crossings;
+}
+
+tl::expected<int, QString> Checkpoints::Repository::countCrossingsByTrial(const int trialId) const {
+    const QString sql = R"(
+        SELECT COUNT(*)
+        FROM crossings x
+        JOIN checkpoints cp ON cp.id = x.checkpointId
+        WHERE cp.trialId = :trialId
+    )";
+
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":trialId", trialId);
+
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[KR] Error counting crossings of trial " + QString::number(trialId) + ": " + querySelect->lastError().text());
+    }
+    return querySelect->value(0).toInt();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "checkpoint.h"
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QString>
+#include <QVector>
+#include <tl/expected.hpp>
+
+namespace Checkpoints {
+
+class Repository
+{
+public:
+    explicit Repository(const QSqlDatabase& db);
+
+    [[nodiscard]] tl::expected<Checkpoint, QString> createCheckpoint(int trialId, const QString& code, const QString& name,
+                                                                     int sequence, int distanceM = 0) const;
+    [[nodiscard]] tl::expected<Checkpoint, QString> getCheckpointById(int id) const;
+    [[nodiscard]] tl::expected<Checkpoint, QString> getCheckpointByCode(int trialId, const QString& code) const;
+    // Ordered by sequence
+    [[nodiscard]] tl::expected<QVector<Checkpoint>, QString> getCheckpointsByTrial(int trialId) const;
+    [[nodiscard]] tl::expected<Checkpoint, QString> updateCheckpointById(int id, const Checkpoint& checkpoint) const;
+    // Also removes its crossings
+    [[nodiscard]] tl::expected<int, QString> deleteCheckpointById(int id) const;
+
+    // Appends in a single transaction. A crossing already stored (same event id, or same
+    // registration, checkpoint and time) is skipped; only the rows actually inserted are returned.
+    // The SQLite error behind a failure goes to sqlError when given.
+    [[nodiscard]] tl::expected<QVector<Crossing>, QString> appendCrossings(const QVector<Crossing>& crossings,
+                                                                           QSqlError* sqlError = nullptr) const;
+    // Ordered by checkpoint sequence, then time
+    [[nodiscard]] tl::expected<QVector<Crossing>, QString> getCrossingsByRegistration(int registrationId) const;
+    [[nodiscard]] tl::expected<int, QString> countCrossingsByTrial(int trialId) const;
+
+private:
+    QSqlDatabase m_db;
+};
+
+};
@@ -1,28 +1,10 @@
 #include "modalitiesrepository.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include "dbmanager.h"
+#include "utils/interning.h"
 
 Modalities::Repository::Repository(const QSqlDatabase& db) : m_db(db) {
-    if (auto value = createModalitiesTable(); !value) {
-        qFatal("Modalities table creation failed: %s", value.error().toLocal8Bit().constData());
-    }
-}
-
-tl::expected<void, QString> Modalities::Repository::createModalitiesTable() const {
-    QSqlQuery query(m_db);
-
-    const QString sql = R"(
-        CREATE TABLE IF NOT EXISTS modalities (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            name TEXT NOT NULL UNIQUE
-        );
-    )";
-
-    if (!query.exec(sql)) {
-        return tl::unexpected("[CR] Error creating modalities:"  + query.lastError().text());
-    }
-
-    return {};
 }
 
 tl::expected<Modalities::Modality, QString> Modalities::Repository::createModality(const QString& name) const {
@@ -30,16 +12,15 @@ tl::expected<Modalities::Modality, QString> Modalities::Repository::createModali
         return tl::unexpected("[CR]: invalid name");
     }
 
-    QSqlQuery queryInsert(m_db);
     QString sql = R"(
         INSERT OR IGNORE INTO modalities(name) VALUES(:name)
     )";
 
-    queryInsert.prepare(sql);
-    queryInsert.bindValue(":name", name.trimmed());
+    auto queryInsert = DBManager::statement(m_db, sql);
+    queryInsert->bindValue(":name", name.trimmed());
 
-    if (!queryInsert.exec()) {
-        return tl::unexpected("[CR]: Error inserting " + name + " into modalities table. Error: " + queryInsert.lastError().text());
+    if (!queryInsert->exec()) {
+        return tl::unexpected("[CR]: Error inserting " + name + " into modalities table. Error: " + queryInsert->lastError().text());
     }
 
     sql = R"(
@@ -50,17 +31,16 @@ tl::expected<Modalities::Modality, QString> Modalities::Repository::createModali
         WHERE name = :name
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
-    querySelect.bindValue(":name", name.trimmed());
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":name", name.trimmed());
 
-    if (!querySelect.exec() || !querySelect.next()) {
-        return tl::unexpected("[CR]: Error fetching '" + name + "' from modalities table. Error: " + querySelect.lastError().text());
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[CR]: Error fetching '" + name + "' from modalities table. Error: " + querySelect->lastError().text());
     }
 
     return (Modality) {
-        .id = querySelect.value(0).toInt(),
-        .name = querySelect.value(1).toString()
+        .id = querySelect->value(0).toInt(),
+        .name = querySelect->value(1).toString()
     };
 }
 
@@ -72,23 +52,21 @@ tl::expected<Modalities::Modality, QString> Modalities::Repository::getModalityB
         WHERE id = :id
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
-    querySelect.bindValue(":id", id);
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":id", id);
 
-    if (!querySelect.exec() || !querySelect.next()) {
-        return tl::unexpected("[CR]: Error fetching '" + QString::number(id) + "' from modalities table. Error: " + querySelect.lastError().text());
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[CR]: Error fetching '" + QString::number(id) + "' from modalities table. Error: " + querySelect->lastError().text());
     }
 
     return (Modality) {
         .id = id,
-        .name = querySelect.value(0).toString()
+        .name = Utils::NamePool::modalities().resolve(id, [&querySelect]() { return querySelect->value(0).toString(); })
     };
 
 }
 
 tl::expected<Modalities::Modality, QString> Modalities::Repository::getModalityByName(const QString& name) const {
-    QSqlQuery querySelect(m_db);
     const QString sql = R"(
         SELECT
             id
@@ -96,16 +74,16 @@ tl::expected<Modalities::Modality, QString> Modalities::Repository::getModalityB
         WHERE name = :name
     )";
 
-    querySelect.prepare(sql);
-    querySelect.bindValue(":name", name);
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":name", name);
 
-    if (!querySelect.exec()) {
-        return tl::unexpected("[CR]: Error fetching '" + name + "' from modalities table. Error: " + querySelect.lastError().text());
+    if (!querySelect->exec()) {
+        return tl::unexpected("[CR]: Error fetching '" + name + "' from modalities table. Error: " + querySelect->lastError().text());
     }
 
-    if (querySelect.next()) {
+    if (querySelect->next()) {
         return (Modality) {
-            .id = querySelect.value(0).toInt(),
+            .id = querySelect->value(0).toInt(),
             .name = name
         };
     }
@@ -114,7 +92,6 @@ tl::expected<Modalities::Modality, QString> Modalities::Repository::getModalityB
 }
 
 tl::expected<QVector<Modalities::Modality>, QString> Modalities::Repository::getAllModalities() const {
-    QSqlQuery querySelect(m_db);
     const QString sql = R"(
         SELECT
             id,
@@ -122,15 +99,17 @@ tl::expected<QVector<Modalities::Modality>, QString> Modalities::Repository::get
         FROM modalities
     )";
 
-    if (!querySelect.exec(sql)) {
-        return tl::unexpected("[CR]: Error fetching registers from modalities table. Error: " + querySelect.lastError().text());
+    auto querySelect = DBManager::statement(m_db, sql);
+    if (!querySelect->exec()) {
+        return tl::unexpected("[CR]: Error fetching registers from modalities table. Error: " + querySelect->lastError().text());
     }
 
     QVector<Modalities::Modality> results;
-    while (querySelect.next()) {
+    while (querySelect->next()) {
+        const int id = querySelect->value(0).toInt();
         results.push_back({
-            .id = querySelect.value(0).toInt(),
-            .name = querySelect.value(1).toString()
+            .id = id,
+            .name = Utils::NamePool::modalities().resolve(id, [&querySelect]() { return querySelect->value(1).toString(); })
         });
     }
 
@@ -141,21 +120,21 @@ tl::expected<Modalities::Modality, QString> Modalities::Repository::updateModali
         return tl::unexpected("[CR]: invalid name");
     }
 
-    QSqlQuery queryUpdate(m_db);
     const QString sql = R"(
         UPDATE modalities
         SET name = :name
         WHERE id = :id
     )";
 
-    queryUpdate.prepare(sql);
-    queryUpdate.bindValue(":name", modality.name);
-    queryUpdate.bindValue(":id", id);
+    auto queryUpdate = DBManager::statement(m_db, sql);
+    queryUpdate->bindValue(":name", modality.name);
+    queryUpdate->bindValue(":id", id);
 
-    if (!queryUpdate.exec()) {
-        return tl::unexpected("[CR]: Error updating '" + QString::number(id) + "'entry on modalities table. Error: " + queryUpdate.lastError().text());
+    if (!queryUpdate->exec()) {
+        return tl::unexpected("[CR]: Error updating '" + QString::number(id) + "'entry on modalities table. Error: " + queryUpdate->lastError().text());
     }
 
+    Utils::NamePool::modalities().insert(id, modality.name);
     return (Modality) {
         .id = id,
         .name = modality.name
@@ -163,19 +142,19 @@ tl::expected<Modalities::Modality, QString> Modalities::Repository::updateModali
 }
 
 tl::expected<int, QString> Modalities::Repository::deleteModalityById(const int id) const {
-    QSqlQuery queryUpdate(m_db);
     const QString sql = R"(
         DELETE FROM modalities
         WHERE id = :id
     )";
 
-    queryUpdate.prepare(sql);
-    queryUpdate.bindValue(":id", id);
+    auto queryUpdate = DBManager::statement(m_db, sql);
+    queryUpdate->bindValue(":id", id);
 
-    if (!queryUpdate.exec()) {
-        return tl::unexpected("[CR]: Error updating '" + QString::number(id) + "'entry on modalities table. Error: " + queryUpdate.lastError().text());
+    if (!queryUpdate->exec()) {
+        return tl::unexpected("[CR]: Error updating '" + QString::number(id) + "'entry on modalities table. Error: " + queryUpdate->lastError().text());
     }
 
+    Utils::NamePool::modalities().remove(id);
     return id;
 }
 
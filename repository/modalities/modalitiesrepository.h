@@ -23,7 +23,6 @@ public:
 
 private:
     QSqlDatabase m_db;
-    [[nodiscard]] tl::expected<void, QString> createModalitiesTable() const;
 };
 
 };
@@ -0,0 +1,299 @@
+#include "bulkimporter.h"
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariantList>
+#include <QElapsedTimer>
+#include <QDebug>
+#include "dbmanager.h"
+
+Registrations::BulkImporter::BulkImporter(const QSqlDatabase& db) : m_db(db) {
+}
+
+tl::expected<Registrations::BulkImporter::Summary, QString> Registrations::BulkImporter::import(const int trialId, const QVector<Row>& rows) const {
+    if (trialId <= 0) {
+        return tl::unexpected("[RI] Invalid trial id " + QString::number(trialId));
+    }
+
+    Summary summary;
+    if (rows.isEmpty()) {
+        return summary;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QSqlDatabase db = m_db;
+    if (!db.transaction()) {
+        return tl::unexpected("[RI] Error starting transaction: " + db.lastError().text());
+    }
+
+    auto fail = [&db](const QString& error) -> tl::expected<Summary, QString> {
+        db.rollback();
+        return tl::unexpected(error);
+    };
+
+    // The temp table lives on this connection only and is emptied on every run
+    auto created = exec(R"(
+        CREATE TEMP TABLE IF NOT EXISTS registration_import (
+            rowNo INTEGER PRIMARY KEY,
+            athleteName TEXT NOT NULL,
+            plateCode TEXT NOT NULL,
+            categoryName TEXT NOT NULL,
+            modalityName TEXT NOT NULL,
+            updateExisting INTEGER NOT NULL,
+            athleteId INTEGER,
+            categoryId INTEGER,
+            modalityId INTEGER,
+            skipReason INTEGER
+        )
+    )");
+    if (!created) {
+        return fail(created.error());
+    }
+    if (auto cleared = exec("DELETE FROM temp.registration_import"); !cleared) {
+        return fail(cleared.error());
+    }
+
+    if (auto staged = stage(rows); !staged) {
+        return fail(staged.error());
+    }
+    summary.staged = rows.size();
+
+    // Categories and modalities are matched case-insensitively, like the preview does
+    auto categories = exec(R"(
+        INSERT INTO categories(name)
+        SELECT MIN(s.categoryName)
+        FROM temp.registration_import s
+        WHERE s.categoryName <> ''
+          AND NOT EXISTS (SELECT 1 FROM categories c WHERE c.name = s.categoryName COLLATE NOCASE)
+        GROUP BY s.categoryName COLLATE NOCASE
+    )");
+    if (!categories) {
+        return fail(categories.error());
+    }
+    summary.categoriesCreated = categories.value();
+
+    auto modalities = exec(R"(
+        INSERT INTO modalities(name)
+        SELECT MIN(s.modalityName)
+        FROM temp.registration_import s
+        WHERE s.modalityName <> ''
+          AND NOT EXISTS (SELECT 1 FROM modalities m WHERE m.name = s.modalityName COLLATE NOCASE)
+        GROUP BY s.modalityName COLLATE NOCASE
+    )");
+    if (!modalities) {
+        return fail(modalities.error());
+    }
+    summary.modalitiesCreated = modalities.value();
+
+    // Athletes are matched by exact name, same as Athletes::Repository::getAthleteByName
+    auto athletes = exec(R"(
+        INSERT INTO athletes(name)
+        SELECT s.athleteName
+        FROM temp.registration_import s
+        WHERE NOT EXISTS (SELECT 1 FROM athletes a WHERE a.name = s.athleteName)
+        GROUP BY s.athleteName
+    )");
+    if (!athletes) {
+        return fail(athletes.error());
+    }
+    summary.athletesCreated = athletes.value();
+
+    auto resolved = exec(R"(
+        UPDATE temp.registration_import
+        SET athleteId = (SELECT MIN(a.id) FROM athletes a WHERE a.name = athleteName),
+            categoryId = (SELECT MIN(c.id) FROM categories c WHERE c.name = categoryName COLLATE NOCASE),
+            modalityId = (SELECT MIN(m.id) FROM modalities m WHERE m.name = modalityName COLLATE NOCASE)
+    )");
+    if (!resolved) {
+        return fail(resolved.error());
+    }
+
+    // Conflicting rows are marked up front so they can be counted and reported, not silently dropped
+    // An update needs exactly one registration of the athlete to overwrite
+    auto unmatched = exec(R"(
+        UPDATE temp.registration_import
+        SET skipReason = CASE (
+                SELECT COUNT(*) FROM registrations r
+                WHERE r.trialId = :trialId AND r.athleteId = registration_import.athleteId
+            )
+            WHEN 0 THEN :notRegistered
+            WHEN 1 THEN NULL
+            ELSE :severalRegistrations
+        END
+        WHERE updateExisting = 1
+    )", {
+        { ":trialId", trialId },
+        { ":notRegistered", static_cast<int>(SkipReason::NotRegistered) },
+        { ":severalRegistrations", static_cast<int>(SkipReason::SeveralRegistrations) }
+    });
+    if (!unmatched) {
+        return fail(unmatched.error());
+    }
+
+    // A plate already held by another athlete of the trial, or claimed by an earlier update row, is left alone
+    auto updateConflicts = exec(R"(
+        UPDATE temp.registration_import
+        SET skipReason = :reason
+        WHERE updateExisting = 1
+          AND skipReason IS NULL
+          AND (EXISTS (
+                   SELECT 1 FROM registrations r
+                   WHERE r.trialId = :trialId
+                     AND r.plateCode = registration_import.plateCode
+                     AND r.athleteId <> registration_import.athleteId
+               )
+               OR EXISTS (
+                   SELECT 1 FROM temp.registration_import o
+                   WHERE o.updateExisting = 1
+                     AND o.plateCode = registration_import.plateCode
+                     AND o.athleteId <> registration_import.athleteId
+                     AND o.rowNo < registration_import.rowNo
+               ))
+    )", { { ":reason", static_cast<int>(SkipReason::PlateTaken) }, { ":trialId", trialId } });
+    if (!updateConflicts) {
+        return fail(updateConflicts.error());
+    }
+
+    // Updates run first so a plate released by one athlete can be taken by a new registration
+    auto updated = exec(R"(
+        UPDATE registrations
+        SET plateCode = s.plateCode,
+            modalityId = s.modalityId,
+            categoryId = s.categoryId
+        FROM temp.registration_import s
+        WHERE s.updateExisting = 1
+          AND s.skipReason IS NULL
+          AND registrations.trialId = :trialId
+          AND registrations.athleteId = s.athleteId
+    )", { { ":trialId", trialId } });
+    if (!updated) {
+        return fail(updated.error());
+    }
+    summary.registrationsUpdated = updated.value();
+
+    // New registrations need a plate free in the trial; within the import the first row wins
+    auto insertConflicts = exec(R"(
+        UPDATE temp.registration_import
+        SET skipReason = :reason
+        WHERE updateExisting = 0
+          AND (EXISTS (
+                   SELECT 1 FROM registrations r
+                   WHERE r.trialId = :trialId AND r.plateCode = registration_import.plateCode
+               )
+               OR EXISTS (
+                   SELECT 1 FROM temp.registration_import o
+                   WHERE o.updateExisting = 0
+                     AND o.plateCode = registration_import.plateCode
+                     AND o.rowNo < registration_import.rowNo
+               ))
+    )", { { ":reason", static_cast<int>(SkipReason::PlateTaken) }, { ":trialId", trialId } });
+    if (!insertConflicts) {
+        return fail(insertConflicts.error());
+    }
+
+    auto inserted = exec(R"(
+        INSERT INTO registrations(trialId, athleteId, plateCode, modalityId, categoryId)
+        SELECT :trialId, s.athleteId, s.plateCode, s.modalityId, s.categoryId
+        FROM temp.registration_import s
+        WHERE s.updateExisting = 0
+          AND s.skipReason IS NULL
+        ORDER BY s.rowNo
+    )", { { ":trialId", trialId } });
+    if (!inserted) {
+        return fail(inserted.error());
+    }
+    summary.registrationsCreated = inserted.value();
+
+    auto skipped = skippedRows();
+    if (!skipped) {
+        return fail(skipped.error());
+    }
+    summary.skipped = std::move(skipped.value());
+
+    if (auto cleared = exec("DELETE FROM temp.registration_import"); !cleared) {
+        return fail(cleared.error());
+    }
+
+    if (!db.commit()) {
+        return fail("[RI] Error committing import: " + db.lastError().text());
+    }
+
+    qInfo().noquote() << QString("[RI] Imported %1 row(s) into trial %2 in %3 ms: %4 created, %5 updated, %6 skipped; new athletes %7, categories %8, modalities %9")
+                             .arg(summary.staged).arg(trialId).arg(timer.elapsed())
+                             .arg(summary.registrationsCreated).arg(summary.registrationsUpdated).arg(summary.skipped.size())
+                             .arg(summary.athletesCreated).arg(summary.categoriesCreated).arg(summary.modalitiesCreated);
+
+    return summary;
+}
+
+tl::expected<int, QString> Registrations::BulkImporter::exec(const QString& sql, const QVariantHash& values) const {
+    auto query = DBManager::statement(m_db, sql);
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        query->bindValue(it.key(), it.value());
+    }
+
+    if (!query->exec()) {
+        return tl::unexpected("[RI] Error running import statement: " + query->lastError().text());
+    }
+
+    return query->numRowsAffected();
+}
+
+tl::expected<void, QString> Registrations::BulkImporter::stage(const QVector<Row>& rows) const {
+    QVariantList athleteNames, plateCodes, categoryNames, modalityNames, updateExisting;
+    athleteNames.reserve(rows.size());
+    plateCodes.reserve(rows.size());
+    categoryNames.reserve(rows.size());
+    modalityNames.reserve(rows.size());
+    updateExisting.reserve(rows.size());
+
+    for (const auto& row : rows) {
+        athleteNames << row.athleteName.trimmed();
+        plateCodes << row.plateCode.trimmed();
+        categoryNames << row.categoryName.trimmed();
+        modalityNames << row.modalityName.trimmed();
+        updateExisting << (row.updateExisting ? 1 : 0);
+    }
+
+    auto query = DBManager::statement(m_db, R"(
+        INSERT INTO temp.registration_import(athleteName, plateCode, categoryName, modalityName, updateExisting)
+        VALUES(?, ?, ?, ?, ?)
+    )");
+    query->addBindValue(athleteNames);
+    query->addBindValue(plateCodes);
+    query->addBindValue(categoryNames);
+    query->addBindValue(modalityNames);
+    query->addBindValue(updateExisting);
+
+    if (!query->execBatch()) {
+        return tl::unexpected("[RI] Error staging import rows: " + query->lastError().text());
+    }
+
+    return {};
+}
+
+tl::expected<QVector<Registrations::BulkImporter::SkippedRow>, QString> Registrations::BulkImporter::skippedRows() const {
+    auto query = DBManager::statement(m_db, R"(
+        SELECT rowNo, athleteName, plateCode, skipReason
+        FROM temp.registration_import
+        WHERE skipReason IS NOT NULL
+        ORDER BY rowNo
+    )");
+
+    if (!query->exec()) {
+        return tl::unexpected("[RI] Error reading skipped import rows: " + query->lastError().text());
+    }
+
+    QVector<SkippedRow> skipped;
+    while (query->next()) {
+        skipped.append({
+            // rowNo counts from 1 in staging order
+            .row = query->value(0).toInt() - 1,
+            .athleteName = query->value(1).toString(),
+            .plateCode = query->value(2).toString(),
+            .reason = static_cast<SkipReason>(query->value(3).toInt())
+        });
+    }
+    return skipped;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QVariantHash>
+#include <QVector>
+#include <tl/expected.hpp>
+
+namespace Registrations {
+
+// Imports a whole participant list into one trial with a handful of set-based statements.
+// Rows are staged in a temp table and athletes, categories, modalities and registrations
+// are upserted from it inside a single transaction: either everything lands or nothing does.
+class BulkImporter
+{
+public:
+    struct Row {
+        QString athleteName;
+        QString plateCode;
+        QString categoryName;
+        QString modalityName;
+        // Overwrite plate/category/modality of the athlete's existing registration instead of inserting one
+        bool updateExisting = false;
+    };
+
+    enum class SkipReason {
+        PlateTaken = 1,     // held by another registration of the trial or an earlier row of the import
+        NotRegistered = 2,  // update of an athlete with no registration in the trial
+        SeveralRegistrations = 3    // update of an athlete registered more than once; which one is meant is unknown
+    };
+
+    struct SkippedRow {
+        int row = 0;        // index into the imported rows
+        QString athleteName;
+        QString plateCode;
+        SkipReason reason = SkipReason::PlateTaken;
+    };
+
+    struct Summary {
+        int staged = 0;
+        int athletesCreated = 0;
+        int categoriesCreated = 0;
+        int modalitiesCreated = 0;
+        int registrationsCreated = 0;
+        int registrationsUpdated = 0;
+        // Rows left out of the import, in import order
+        QVector<SkippedRow> skipped;
+    };
+
+    explicit BulkImporter(const QSqlDatabase& db);
+
+    [[nodiscard]] tl::expected<Summary, QString> import(int trialId, const QVector<Row>& rows) const;
+
+private:
+    QSqlDatabase m_db;
+
+    // Runs one statement with the given placeholder values; returns the rows affected
+    [[nodiscard]] tl::expected<int, QString> exec(const QString& sql, const QVariantHash& values = {}) const;
+    [[nodiscard]] tl::expected<void, QString> stage(const QVector<Row>& rows) const;
+    [[nodiscard]] tl::expected<QVector<SkippedRow>, QString> skippedRows() const;
+};
+
+};
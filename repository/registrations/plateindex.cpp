@@ -0,0 +1,136 @@
+#include "plateindex.h"
+#include <QSqlQuery>
+#include <QSqlError>
+
+namespace {
+
+// Every entry carries the effective start offset, however it is loaded
+const QString entrySelect = R"(
+    SELECT reg.id, reg.athleteId, reg.categoryId, reg.modalityId, reg.plateCode,
+           a.name, c.name, m.name,
+           reg.waveId, COALESCE(reg.startOffsetMs, w.startOffsetMs, 0), reg.startOffsetMs IS NOT NULL
+    FROM registrations reg
+    LEFT JOIN waves w ON reg.waveId = w.id
+    LEFT JOIN athletes a ON reg.athleteId = a.id
+    LEFT JOIN categories c ON reg.categoryId = c.id
+    LEFT JOIN modalities m ON reg.modalityId = m.id
+)";
+
+Registrations::PlateIndex::Entry readEntry(const QSqlQuery& query) {
+    return {
+        .registrationId = query.value(0).toInt(),
+        .athleteId = query.value(1).toInt(),
+        .categoryId = query.value(2).toInt(),
+        .modalityId = query.value(3).toInt(),
+        .plateCode = query.value(4).toString(),
+        .athleteName = query.value(5).toString(),
+        .categoryName = query.value(6).toString(),
+        .modalityName = query.value(7).toString(),
+        .waveId = query.value(8).toInt(),
+        .startOffsetMs = query.value(9).toInt(),
+        .individualStart = query.value(10).toBool()
+    };
+}
+
+};
+
+tl::expected<void, QString> Registrations::PlateIndex::rebuild(const QSqlDatabase& db, const int trialId) {
+    const QString sql = entrySelect + "WHERE reg.trialId = :trialId";
+
+    // Plates looked up after a failed load still fall back to the database for this trial
+    m_entries.clear();
+    m_trialId = trialId;
+
+    QSqlQuery querySelect(db);
+    querySelect.prepare(sql);
+    querySelect.bindValue(":trialId", trialId);
+
+    if (!querySelect.exec()) {
+        return tl::unexpected("[PI] Error loading plate index for trial " + QString::number(trialId) + ": " + querySelect.lastError().text());
+    }
+
+    QHash<QString, Entry> entries;
+    while (querySelect.next()) {
+        Entry entry = readEntry(querySelect);
+        entries.insert(entry.plateCode, entry);
+    }
+
+    m_entries = std::move(entries);
+
+    return {};
+}
+
+void Registrations::PlateIndex::clear() {
+    m_entries.clear();
+    m_trialId = -1;
+}
+
+void Registrations::PlateIndex::upsert(const Entry& entry) {
+    m_entries.insert(entry.plateCode, entry);
+}
+
+tl::expected<int, QString> Registrations::PlateIndex::load(const QSqlDatabase& db, const QStringList& plateCodes) {
+    // SQLite caps the number of host parameters per statement, so large bursts are split in chunks
+    constexpr qsizetype maxPlatesPerQuery = 500;
+
+    QStringList uniquePlates = plateCodes;
+    uniquePlates.removeDuplicates();
+
+    int loaded = 0;
+    for (qsizetype offset = 0; offset < uniquePlates.size(); offset += maxPlatesPerQuery) {
+        const QStringList chunk = uniquePlates.mid(offset, maxPlatesPerQuery);
+
+        QStringList placeholders;
+        placeholders.reserve(chunk.size());
+        for (qsizetype i = 0; i < chunk.size(); ++i) {
+            placeholders << "?";
+        }
+
+        // The placeholder count varies per burst, so these statements bypass the statement cache
+        QSqlQuery querySelect(db);
+        querySelect.prepare(entrySelect + QString("WHERE reg.trialId = ? AND reg.plateCode IN (%1)").arg(placeholders.join(", ")));
+        querySelect.addBindValue(m_trialId);
+        for (const auto& plateCode : chunk) {
+            querySelect.addBindValue(plateCode);
+        }
+
+        if (!querySelect.exec()) {
+            return tl::unexpected("[PI] Error loading plates for trial " + QString::number(m_trialId) + ": " + querySelect.lastError().text());
+        }
+
+        while (querySelect.next()) {
+            upsert(readEntry(querySelect));
+            ++loaded;
+        }
+    }
+    return loaded;
+}
+
+void Registrations::PlateIndex::remove(const QString& plateCode) {
+    m_entries.remove(plateCode);
+}
+
+void Registrations::PlateIndex::setWaveStart(const int waveId, const int startOffsetMs) {
+    for (auto& entry : m_entries) {
+        if (entry.waveId == waveId && !entry.individualStart) {
+            entry.startOffsetMs = startOffsetMs;
+        }
+    }
+}
+
+void Registrations::PlateIndex::setWave(const QString& plateCode, const int waveId, const int waveStartOffsetMs) {
+    const auto it = m_entries.find(plateCode);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    it->waveId = waveId;
+    if (!it->individualStart) {
+        it->startOffsetMs = waveStartOffsetMs;
+    }
+}
+
+const Registrations::PlateIndex::Entry* Registrations::PlateIndex::find(const QString& plateCode) const {
+    const auto it = m_entries.constFind(plateCode);
+    return it == m_entries.constEnd() ? nullptr : &it.value();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QHash>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <tl/expected.hpp>
+
+namespace Registrations {
+
+// In-memory plate -> registration index for the trial being timed.
+// Lookups never touch the database; the index is rebuilt when a trial is
+// started or resumed and kept in sync through upsert()/remove().
+class PlateIndex
+{
+public:
+    struct Entry {
+        int registrationId = 0;
+        int athleteId = 0;
+        int categoryId = 0;
+        int modalityId = 0;
+        QString plateCode;
+        QString athleteName;
+        QString categoryName;
+        QString modalityName;
+        int waveId = 0;
+        int startOffsetMs = 0;          // effective offset from the trial start; net time = elapsed - offset
+        bool individualStart = false;   // own offset, not following the wave
+    };
+
+    [[nodiscard]] tl::expected<void, QString> rebuild(const QSqlDatabase& db, int trialId);
+    void clear();
+
+    // Adds the given plates of the index's trial from the database, start offsets included;
+    // returns how many were found
+    [[nodiscard]] tl::expected<int, QString> load(const QSqlDatabase& db, const QStringList& plateCodes);
+
+    void upsert(const Entry& entry);
+    void remove(const QString& plateCode);
+
+    // Mirrors Waves::Repository changes so captures keep using the current offsets
+    void setWaveStart(int waveId, int startOffsetMs);
+    void setWave(const QString& plateCode, int waveId, int waveStartOffsetMs);
+
+    [[nodiscard]] const Entry* find(const QString& plateCode) const;
+    [[nodiscard]] int trialId() const { return m_trialId; }
+    [[nodiscard]] qsizetype size() const { return m_entries.size(); }
+    [[nodiscard]] bool isEmpty() const { return m_entries.isEmpty(); }
+
+private:
+    int m_trialId = -1;
+    QHash<QString, Entry> m_entries;
+};
+
+};
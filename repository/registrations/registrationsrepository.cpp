@@ -1,47 +1,9 @@
 #include "registrationsrepository.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include "dbmanager.h"
 
 Registrations::Repository::Repository(const QSqlDatabase& db) : m_db(db) {
-    if (auto value = createRegistrationsTable(); !value) {
-        qFatal("Registrations table creation failed: %s", value.error().toLocal8Bit().constData());
-    }
-}
-
-tl::expected<void, QString> Registrations::Repository::createRegistrationsTable() const {
-    QSqlQuery query(m_db);
-
-    QString sql = R"(
-        CREATE TABLE IF NOT EXISTS registrations (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            trialId INTEGER NOT NULL,
-            athleteId INTEGER NOT NULL,
-            plateCode TEXT NOT NULL,
-            modalityId INTEGER,
-            categoryId INTEGER,
-
-            FOREIGN KEY (trialId) REFERENCES trials(id) ON DELETE CASCADE,
-            FOREIGN KEY (athleteId) REFERENCES athletes(id),
-            FOREIGN KEY (modalityId) REFERENCES modalities(id),
-            FOREIGN KEY (categoryId) REFERENCES categories(id),
-
-            UNIQUE (trialId, plateCode)
-        );
-    )";
-
-    if (!query.exec(sql)) {
-        return tl::unexpected("[RR] Error creating registrations: " + query.lastError().text());
-    }
-
-    sql = R"(
-        CREATE INDEX IF NOT EXISTS idx_registrations_trial ON registrations(trialId);
-    )";
-
-    if (!query.exec(sql)) {
-        return tl::unexpected("[RR] Error creating index idx_registrations_trial: " + query.lastError().text());
-    }
-
-    return {};
 }
 
 tl::expected<Registrations::Registration, QString> Registrations::Repository::createRegistration(
@@ -55,24 +17,23 @@ tl::expected<Registrations::Registration, QString> Registrations::Repository::cr
         return tl::unexpected("[RR] Invalid plate code");
     }
 
-    QSqlQuery queryInsert(m_db);
     const QString sql = R"(
         INSERT INTO registrations(trialId, athleteId, plateCode, modalityId, categoryId) 
         VALUES(:trialId, :athleteId, :plateCode, :modalityId, :categoryId)
     )";
 
-    queryInsert.prepare(sql);
-    queryInsert.bindValue(":trialId", trialId);
-    queryInsert.bindValue(":athleteId", athleteId);
-    queryInsert.bindValue(":plateCode", plateCode.trimmed());
-    queryInsert.bindValue(":modalityId", modalityId);
-    queryInsert.bindValue(":categoryId", categoryId);
+    auto queryInsert = DBManager::statement(m_db, sql);
+    queryInsert->bindValue(":trialId", trialId);
+    queryInsert->bindValue(":athleteId", athleteId);
+    queryInsert->bindValue(":plateCode", plateCode.trimmed());
+    queryInsert->bindValue(":modalityId", modalityId);
+    queryInsert->bindValue(":categoryId", categoryId);
 
-    if (!queryInsert.exec()) {
-        return tl::unexpected("[RR] Error inserting registration: " + queryInsert.lastError().text());
+    if (!queryInsert->exec()) {
+        return tl::unexpected("[RR] Error inserting registration: " + queryInsert->lastError().text());
     }
 
-    const int newId = queryInsert.lastInsertId().toInt();
+    const int newId = queryInsert->lastInsertId().toInt();
     
     return (Registration) {
         .id = newId,
@@ -91,21 +52,20 @@ tl::expected<Registrations::Registration, QString> Registrations::Repository::ge
         WHERE id = :id
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
-    querySelect.bindValue(":id", id);
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":id", id);
 
-    if (!querySelect.exec() || !querySelect.next()) {
-        return tl::unexpected("[RR] Error fetching registration with id " + QString::number(id) + ": " + querySelect.lastError().text());
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[RR] Error fetching registration with id " + QString::number(id) + ": " + querySelect->lastError().text());
     }
 
     return (Registration) {
         .id = id,
-        .trialId = querySelect.value(0).toInt(),
-        .athleteId = querySelect.value(1).toInt(),
-        .plateCode = querySelect.value(2).toString(),
-        .modalityId = querySelect.value(3).toInt(),
-        .categoryId = querySelect.value(4).toInt()
+        .trialId = querySelect->value(0).toInt(),
+        .athleteId = querySelect->value(1).toInt(),
+        .plateCode = querySelect->value(2).toString(),
+        .modalityId = querySelect->value(3).toInt(),
+        .categoryId = querySelect->value(4).toInt()
     };
 }
 
@@ -116,25 +76,76 @@ tl::expected<Registrations::Registration, QString> Registrations::Repository::ge
         WHERE trialId = :trialId AND plateCode = :plateCode
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
-    querySelect.bindValue(":trialId", trialId);
-    querySelect.bindValue(":plateCode", plateCode);
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":trialId", trialId);
+    querySelect->bindValue(":plateCode", plateCode);
 
-    if (!querySelect.exec() || !querySelect.next()) {
-        return tl::unexpected("[RR] Error fetching registration with plate " + plateCode + ": " + querySelect.lastError().text());
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[RR] Error fetching registration with plate " + plateCode + ": " + querySelect->lastError().text());
     }
 
     return (Registration) {
-        .id = querySelect.value(0).toInt(),
+        .id = querySelect->value(0).toInt(),
         .trialId = trialId,
-        .athleteId = querySelect.value(1).toInt(),
+        .athleteId = querySelect->value(1).toInt(),
         .plateCode = plateCode,
-        .modalityId = querySelect.value(2).toInt(),
-        .categoryId = querySelect.value(3).toInt()
+        .modalityId = querySelect->value(2).toInt(),
+        .categoryId = querySelect->value(3).toInt()
     };
 }
 
+tl::expected<QVector<Registrations::Registration>, QString> Registrations::Repository::getRegistrationsByPlateCodes(const int trialId, const QStringList& plateCodes) const {
+    // SQLite caps the number of host parameters per statement, so large bursts are split in chunks
+    constexpr qsizetype maxPlatesPerQuery = 500;
+
+    QStringList uniquePlates = plateCodes;
+    uniquePlates.removeDuplicates();
+
+    QVector<Registration> results;
+    results.reserve(uniquePlates.size());
+
+    for (qsizetype offset = 0; offset < uniquePlates.size(); offset += maxPlatesPerQuery) {
+        const QStringList chunk = uniquePlates.mid(offset, maxPlatesPerQuery);
+
+        QStringList placeholders;
+        placeholders.reserve(chunk.size());
+        for (qsizetype i = 0; i < chunk.size(); ++i) {
+            placeholders << "?";
+        }
+
+        const QString sql = QString(R"(
+            SELECT id, athleteId, plateCode, modalityId, categoryId
+            FROM registrations
+            WHERE trialId = ? AND plateCode IN (%1)
+        )").arg(placeholders.join(", "));
+
+        // The placeholder count varies per burst, so these statements bypass the statement cache
+        QSqlQuery querySelect(m_db);
+        querySelect.prepare(sql);
+        querySelect.addBindValue(trialId);
+        for (const auto& plateCode : chunk) {
+            querySelect.addBindValue(plateCode);
+        }
+
+        if (!querySelect.exec()) {
+            return tl::unexpected("[RR] Error fetching registrations by plate for trial " + QString::number(trialId) + ": " + querySelect.lastError().text());
+        }
+
+        while (querySelect.next()) {
+            results.push_back({
+                .id = querySelect.value(0).toInt(),
+                .trialId = trialId,
+                .athleteId = querySelect.value(1).toInt(),
+                .plateCode = querySelect.value(2).toString(),
+                .modalityId = querySelect.value(3).toInt(),
+                .categoryId = querySelect.value(4).toInt()
+            });
+        }
+    }
+
+    return results;
+}
+
 tl::expected<QVector<Registrations::Registration>, QString> Registrations::Repository::getRegistrationsByTrial(const int trialId) const {
     const QString sql = R"(
         SELECT id, athleteId, plateCode, modalityId, categoryId
@@ -143,23 +154,22 @@ tl::expected<QVector<Registrations::Registration>, QString> Registrations::Repos
         ORDER BY plateCode
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
-    querySelect.bindValue(":trialId", trialId);
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":trialId", trialId);
 
-    if (!querySelect.exec()) {
-        return tl::unexpected("[RR] Error fetching registrations for trial " + QString::number(trialId) + ": " + querySelect.lastError().text());
+    if (!querySelect->exec()) {
+        return tl::unexpected("[RR] Error fetching registrations for trial " + QString::number(trialId) + ": " + querySelect->lastError().text());
     }
 
     QVector<Registration> results;
-    while (querySelect.next()) {
+    while (querySelect->next()) {
         results.push_back({
-            .id = querySelect.value(0).toInt(),
+            .id = querySelect->value(0).toInt(),
             .trialId = trialId,
-            .athleteId = querySelect.value(1).toInt(),
-            .plateCode = querySelect.value(2).toString(),
-            .modalityId = querySelect.value(3).toInt(),
-            .categoryId = querySelect.value(4).toInt()
+            .athleteId = querySelect->value(1).toInt(),
+            .plateCode = querySelect->value(2).toString(),
+            .modalityId = querySelect->value(3).toInt(),
+            .categoryId = querySelect->value(4).toInt()
         });
     }
 
@@ -173,22 +183,21 @@ tl::expected<QVector<Registrations::Registration>, QString> Registrations::Repos
         ORDER BY trialId, plateCode
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
+    auto querySelect = DBManager::statement(m_db, sql);
 
-    if (!querySelect.exec()) {
-        return tl::unexpected("[RR] Error fetching all registrations: " + querySelect.lastError().text());
+    if (!querySelect->exec()) {
+        return tl::unexpected("[RR] Error fetching all registrations: " + querySelect->lastError().text());
     }
 
     QVector<Registration> results;
-    while (querySelect.next()) {
+    while (querySelect->next()) {
         results.push_back({
-            .id = querySelect.value(0).toInt(),
-            .trialId = querySelect.value(1).toInt(),
-            .athleteId = querySelect.value(2).toInt(),
-            .plateCode = querySelect.value(3).toString(),
-            .modalityId = querySelect.value(4).toInt(),
-            .categoryId = querySelect.value(5).toInt()
+            .id = querySelect->value(0).toInt(),
+            .trialId = querySelect->value(1).toInt(),
+            .athleteId = querySelect->value(2).toInt(),
+            .plateCode = querySelect->value(3).toString(),
+            .modalityId = querySelect->value(4).toInt(),
+            .categoryId = querySelect->value(5).toInt()
         });
     }
 
@@ -200,7 +209,6 @@ tl::expected<Registrations::Registration, QString> Registrations::Repository::up
         return tl::unexpected("[RR] Invalid plate code");
     }
 
-    QSqlQuery queryUpdate(m_db);
     const QString sql = R"(
         UPDATE registrations
         SET trialId = :trialId, athleteId = :athleteId, plateCode = :plateCode, 
@@ -208,50 +216,48 @@ tl::expected<Registrations::Registration, QString> Registrations::Repository::up
         WHERE id = :id
     )";
 
-    queryUpdate.prepare(sql);
-    queryUpdate.bindValue(":id", id);
-    queryUpdate.bindValue(":trialId", registration.trialId);
-    queryUpdate.bindValue(":athleteId", registration.athleteId);
-    queryUpdate.bindValue(":plateCode", registration.plateCode.trimmed());
-    queryUpdate.bindValue(":modalityId", registration.modalityId);
-    queryUpdate.bindValue(":categoryId", registration.categoryId);
+    auto queryUpdate = DBManager::statement(m_db, sql);
+    queryUpdate->bindValue(":id", id);
+    queryUpdate->bindValue(":trialId", registration.trialId);
+    queryUpdate->bindValue(":athleteId", registration.athleteId);
+    queryUpdate->bindValue(":plateCode", registration.plateCode.trimmed());
+    queryUpdate->bindValue(":modalityId", registration.modalityId);
+    queryUpdate->bindValue(":categoryId", registration.categoryId);
 
-    if (!queryUpdate.exec()) {
-        return tl::unexpected("[RR] Error updating registration " + QString::number(id) + ": " + queryUpdate.lastError().text());
+    if (!queryUpdate->exec()) {
+        return tl::unexpected("[RR] Error updating registration " + QString::number(id) + ": " + queryUpdate->lastError().text());
     }
 
     return registration;
 }
 
 tl::expected<int, QString> Registrations::Repository::deleteRegistrationById(const int id) const {
-    QSqlQuery queryDelete(m_db);
     const QString sql = R"(
         DELETE FROM registrations
         WHERE id = :id
     )";
 
-    queryDelete.prepare(sql);
-    queryDelete.bindValue(":id", id);
+    auto queryDelete = DBManager::statement(m_db, sql);
+    queryDelete->bindValue(":id", id);
 
-    if (!queryDelete.exec()) {
-        return tl::unexpected("[RR] Error deleting registration " + QString::number(id) + ": " + queryDelete.lastError().text());
+    if (!queryDelete->exec()) {
+        return tl::unexpected("[RR] Error deleting registration " + QString::number(id) + ": " + queryDelete->lastError().text());
     }
 
     return id;
 }
 
 tl::expected<int, QString> Registrations::Repository::deleteRegistrationsByTrial(const int trialId) const {
-    QSqlQuery queryDelete(m_db);
     const QString sql = R"(
         DELETE FROM registrations
         WHERE trialId = :trialId
     )";
 
-    queryDelete.prepare(sql);
-    queryDelete.bindValue(":trialId", trialId);
+    auto queryDelete = DBManager::statement(m_db, sql);
+    queryDelete->bindValue(":trialId", trialId);
 
-    if (!queryDelete.exec()) {
-        return tl::unexpected("[RR] Error deleting registrations for trial " + QString::number(trialId) + ": " + queryDelete.lastError().text());
+    if (!queryDelete->exec()) {
+        return tl::unexpected("[RR] Error deleting registrations for trial " + QString::number(trialId) + ": " + queryDelete->lastError().text());
     }
 
     return trialId;
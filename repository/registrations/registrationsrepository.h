@@ -3,6 +3,7 @@
 #include "registration.h"
 #include <QSqlDatabase>
 #include <QString>
+#include <QStringList>
 #include <tl/expected.hpp>
 
 namespace Registrations {
@@ -21,6 +22,7 @@ public:
     ) const;
     [[nodiscard]] tl::expected<Registration, QString> getRegistrationById(int id) const;
     [[nodiscard]] tl::expected<Registration, QString> getRegistrationByPlateCode(int trialId, const QString& plateCode) const;
+    [[nodiscard]] tl::expected<QVector<Registration>, QString> getRegistrationsByPlateCodes(int trialId, const QStringList& plateCodes) const;
     [[nodiscard]] tl::expected<QVector<Registration>, QString> getRegistrationsByTrial(int trialId) const;
     [[nodiscard]] tl::expected<QVector<Registration>, QString> getAllRegistrations() const;
     [[nodiscard]] tl::expected<Registration, QString> updateRegistrationById(int id, const Registration& registration) const;
@@ -29,7 +31,6 @@ public:
 
 private:
     QSqlDatabase m_db;
-    [[nodiscard]] tl::expected<void, QString> createRegistrationsTable() const;
 };
 
 };
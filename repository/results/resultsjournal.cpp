@@ -0,0 +1,294 @@
+#include "resultsjournal.h"
+#include "utils/timeutils.h"
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QElapsedTimer>
+#include <QUuid>
+#include <QDebug>
+#include <optional>
+
+Results::Journal::Journal(const QString& databasePath, const DBPerformanceProfile& profile, QObject* parent)
+    : QThread(parent)
+    , m_databasePath(databasePath)
+    , m_profile(profile)
+    , m_connectionName("results-journal-" + QUuid::createUuid().toString(QUuid::WithoutBraces)) {
+    qRegisterMetaType<QVector<Results::Result>>("QVector<Results::Result>");
+    qRegisterMetaType<QVector<Checkpoints::Crossing>>("QVector<Checkpoints::Crossing>");
+}
+
+Results::Journal::~Journal() {
+    stop();
+}
+
+void Results::Journal::enqueue(Event event) {
+    if (!event.capturedAt.isValid()) {
+        event.capturedAt = Utils::DateTimeUtils::now();
+    }
+
+    m_queue.push(std::move(event));
+    m_enqueued.fetch_add(1, std::memory_order_relaxed);
+    m_queueDepth.fetch_add(1, std::memory_order_relaxed);
+    wake();
+}
+
+void Results::Journal::enqueue(const QVector<Event>& events) {
+    for (const auto& event : events) {
+        enqueue(event);
+    }
+}
+
+bool Results::Journal::flush(const int timeoutMs) const {
+    const qint64 target = m_enqueued.load(std::memory_order_relaxed);
+
+    QElapsedTimer timer;
+    timer.start();
+    while (m_committedEvents.load(std::memory_order_acquire) + m_droppedEvents.load(std::memory_order_acquire)
+           + m_rejectedEvents.load(std::memory_order_acquire) < target) {
+        if (!isRunning() || timer.elapsed() >= timeoutMs) {
+            return false;
+        }
+        QThread::msleep(2);
+    }
+    return true;
+}
+
+void Results::Journal::stop() {
+    if (!isRunning()) {
+        return;
+    }
+
+    m_stopping.store(true, std::memory_order_release);
+    wake();
+    wait();
+}
+
+Results::Journal::Stats Results::Journal::stats() const {
+    return Stats {
+        .queueDepth = m_queueDepth.load(std::memory_order_relaxed),
+        .committedEvents = m_committedEvents.load(std::memory_order_relaxed),
+        .committedBatches = m_committedBatches.load(std::memory_order_relaxed),
+        .failedCommits = m_failedCommits.load(std::memory_order_relaxed),
+        .droppedEvents = m_droppedEvents.load(std::memory_order_relaxed),
+        .rejectedEvents = m_rejectedEvents.load(std::memory_order_relaxed),
+        .duplicateEvents = m_duplicateEvents.load(std::memory_order_relaxed),
+        .lastCommitLatencyUs = m_lastCommitLatencyUs.load(std::memory_order_relaxed),
+        .maxCommitLatencyUs = m_maxCommitLatencyUs.load(std::memory_order_relaxed)
+    };
+}
+
+void Results::Journal::wake() {
+    m_wakeups.fetch_add(1, std::memory_order_release);
+    m_wakeups.notify_one();
+}
+
+void Results::Journal::run() {
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+        db.setDatabaseName(m_databasePath);
+
+        std::optional<Repository> resultsRepo;
+        std::optional<Checkpoints::Repository> checkpointsRepo;
+        // Retried with the batch, so a database that was briefly unavailable does not stop the journal for good
+        auto openConnection = [&](QString& error) {
+            if (resultsRepo) {
+                return true;
+            }
+            if (!db.open()) {
+                error = "[RJ] Error opening journal connection: " + db.lastError().text();
+                return false;
+            }
+            qInfo().noquote() << "[RJ]" << DBManager::applyConnectionPragmas(db, m_profile);
+            resultsRepo.emplace(db);
+            checkpointsRepo.emplace(db);
+            return true;
+        };
+
+        QVector<Event> batch;
+        batch.reserve(maxBatchSize);
+        // writeFailed is emitted once per streak of failed attempts, not on every retry
+        bool failing = false;
+
+        while (true) {
+            const quint64 seen = m_wakeups.load(std::memory_order_acquire);
+
+            Event event;
+            while (batch.size() < maxBatchSize && m_queue.tryPop(event)) {
+                batch.push_back(std::move(event));
+            }
+
+            if (!batch.isEmpty()) {
+                QString error;
+                bool transient = true;
+                if (openConnection(error) && commitBatch(*resultsRepo, *checkpointsRepo, batch, error, transient)) {
+                    m_queueDepth.fetch_sub(batch.size(), std::memory_order_relaxed);
+                    batch.clear();
+                    failing = false;
+                    continue;
+                }
+
+                if (!transient) {
+                    // Retrying a constraint failure fails the same way; store the events one at a time
+                    // so only the offending ones are rejected and the rest of the race keeps flowing
+                    const qsizetype done = commitEach(*resultsRepo, *checkpointsRepo, batch, error);
+                    m_queueDepth.fetch_sub(done, std::memory_order_relaxed);
+                    batch.remove(0, done);
+                    if (batch.isEmpty()) {
+                        failing = false;
+                        continue;
+                    }
+                }
+
+                if (m_stopping.load(std::memory_order_acquire)) {
+                    // Give up on the remaining events only when shutting down
+                    m_droppedEvents.fetch_add(batch.size(), std::memory_order_release);
+                    m_queueDepth.fetch_sub(batch.size(), std::memory_order_relaxed);
+                    const QString dropped = QString("[RJ] Dropping %1 finish event(s) on shutdown: %2").arg(batch.size()).arg(error);
+                    if (const QStringList eventIds = taggedEventIds(batch); !eventIds.isEmpty()) {
+                        emit eventsRejected(eventIds, dropped);
+                    }
+                    emit writeFailed(dropped);
+                    batch.clear();
+                    continue;
+                }
+
+                // Busy, locked, I/O or no connection: keep the batch and retry; events are never discarded while running
+                m_failedCommits.fetch_add(1, std::memory_order_relaxed);
+                if (!failing) {
+                    emit writeFailed(error + " (retrying)");
+                    failing = true;
+                }
+                QThread::msleep(retryDelayMs);
+                continue;
+            }
+
+            if (m_stopping.load(std::memory_order_acquire)) {
+                break;
+            }
+
+            m_wakeups.wait(seen, std::memory_order_acquire);
+        }
+
+        resultsRepo.reset();
+        checkpointsRepo.reset();
+        DBManager::releaseStatements(m_connectionName);
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+qsizetype Results::Journal::commitEach(const Repository& resultsRepo, const Checkpoints::Repository& checkpointsRepo,
+                                      const QVector<Event>& batch, QString& error) {
+    qsizetype done = 0;
+    for (; done < batch.size(); ++done) {
+        const Event& event = batch[done];
+        QString eventError;
+        bool transient = false;
+        if (commitBatch(resultsRepo, checkpointsRepo, { event }, eventError, transient)) {
+            continue;
+        }
+        if (transient) {
+            error = eventError;
+            break;
+        }
+
+        // E.g. the registration or checkpoint was deleted after the plate was resolved
+        m_rejectedEvents.fetch_add(1, std::memory_order_release);
+        if (!event.eventId.isEmpty()) {
+            emit eventsRejected({ event.eventId }, eventError);
+        }
+        emit writeFailed(QString("[RJ] Rejected finish event for plate %1: %2").arg(event.plateCode, eventError));
+    }
+    return done;
+}
+
+bool Results::Journal::commitBatch(const Repository& resultsRepo, const Checkpoints::Repository& checkpointsRepo,
+                                   const QVector<Event>& batch, QString& error, bool& transient) {
+    QVector<Result> results;
+    QVector<Checkpoints::Crossing> crossings;
+    QStringList eventIds;
+    bool tagged = false;
+    results.reserve(batch.size());
+    eventIds.reserve(batch.size());
+    for (const auto& event : batch) {
+        if (event.checkpointId > 0) {
+            crossings.push_back({
+                .registrationId = event.registrationId,
+                .checkpointId = event.checkpointId,
+                .elapsedMs = event.durationMs,
+                .capturedAt = event.capturedAt,
+                .eventId = event.eventId
+            });
+            continue;
+        }
+
+        tagged = tagged || !event.eventId.isEmpty();
+        eventIds.push_back(event.eventId);
+        results.push_back({
+            .id = 0,
+            .registrationId = event.registrationId,
+            .startTime = event.startTime,
+            .endTime = event.capturedAt,
+            .durationMs = event.durationMs,
+            .notes = event.notes,
+            .elapsedNs = event.elapsedNs
+        });
+    }
+
+    QElapsedTimer latency;
+    latency.start();
+
+    // Crossings go first: they are idempotent, so a batch retried after a failed
+    // results insert does not store them twice
+    QSqlError sqlError;
+    auto appended = checkpointsRepo.appendCrossings(crossings, &sqlError);
+    if (!appended.has_value()) {
+        error = appended.error();
+        transient = DBManager::isTransientError(sqlError);
+        return false;
+    }
+
+    // Local captures have no event id and keep the strict insert
+    tl::expected<QVector<Result>, QString> created = QVector<Result>();
+    if (!results.isEmpty()) {
+        created = resultsRepo.createResults(results, tagged ? eventIds : QStringList(), &sqlError);
+    }
+
+    const qint64 elapsedUs = latency.nsecsElapsed() / 1000;
+    m_lastCommitLatencyUs.store(elapsedUs, std::memory_order_relaxed);
+    qint64 currentMax = m_maxCommitLatencyUs.load(std::memory_order_relaxed);
+    while (elapsedUs > currentMax && !m_maxCommitLatencyUs.compare_exchange_weak(currentMax, elapsedUs, std::memory_order_relaxed)) {
+    }
+
+    if (!created.has_value()) {
+        error = created.error();
+        transient = DBManager::isTransientError(sqlError);
+        return false;
+    }
+
+    const qsizetype duplicates = (crossings.size() - appended.value().size()) + (results.size() - created.value().size());
+    m_duplicateEvents.fetch_add(duplicates, std::memory_order_relaxed);
+    m_committedBatches.fetch_add(1, std::memory_order_relaxed);
+    m_committedEvents.fetch_add(batch.size(), std::memory_order_release);
+
+    if (!appended.value().isEmpty()) {
+        emit crossingsCommitted(appended.value());
+    }
+    if (!created.value().isEmpty()) {
+        emit resultsCommitted(created.value());
+    }
+    if (const QStringList storedIds = taggedEventIds(batch); !storedIds.isEmpty()) {
+        emit eventsStored(storedIds);
+    }
+    return true;
+}
+
+QStringList Results::Journal::taggedEventIds(const QVector<Event>& events) {
+    QStringList eventIds;
+    for (const auto& event : events) {
+        if (!event.eventId.isEmpty()) {
+            eventIds.append(event.eventId);
+        }
+    }
+    return eventIds;
+}
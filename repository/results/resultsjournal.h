@@ -0,0 +1,107 @@
+#pragma once
+
+#include "result.h"
+#include "resultsrepository.h"
+#include "repository/checkpoints/checkpointsrepository.h"
+#include "utils/mpscqueue.h"
+#include "dbmanager.h"
+#include <QThread>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QDateTime>
+#include <atomic>
+
+namespace Results {
+
+// Write-behind journal for finish events.
+// The GUI thread only enqueues; a dedicated writer thread owns its own
+// SQLite connection and commits the queued events in group batches.
+class Journal : public QThread
+{
+    Q_OBJECT
+
+public:
+    struct Event {
+        int registrationId = 0;
+        QString plateCode;
+        QDateTime startTime;
+        QDateTime capturedAt;
+        qint64 elapsedNs = 0;
+        int durationMs = 0;
+        QString notes;
+        QString eventId;        // set by capture stations; an id already stored is not stored again
+        int checkpointId = 0;   // non-zero for an intermediate split, stored as a crossing instead of a result
+    };
+
+    struct Stats {
+        qint64 queueDepth = 0;
+        qint64 committedEvents = 0;
+        qint64 committedBatches = 0;
+        qint64 failedCommits = 0;
+        qint64 droppedEvents = 0;
+        qint64 rejectedEvents = 0;
+        qint64 duplicateEvents = 0;
+        qint64 lastCommitLatencyUs = 0;
+        qint64 maxCommitLatencyUs = 0;
+    };
+
+    explicit Journal(const QString& databasePath, const DBPerformanceProfile& profile = DBPerformanceProfile(), QObject* parent = nullptr);
+    ~Journal() override;
+
+    void enqueue(Event event);
+    void enqueue(const QVector<Event>& events);
+
+    // Blocks until every event enqueued so far has been committed (or rejected) or the timeout expires
+    bool flush(int timeoutMs = 5000) const;
+    void stop();
+
+    [[nodiscard]] Stats stats() const;
+
+signals:
+    void resultsCommitted(const QVector<Results::Result>& results);
+    void crossingsCommitted(const QVector<Checkpoints::Crossing>& crossings);
+    // Event ids of a committed batch, including the ones skipped as already stored
+    void eventsStored(const QStringList& eventIds);
+    // Event ids that were not stored: rejected for good, or dropped on shutdown
+    void eventsRejected(const QStringList& eventIds, const QString& error);
+    void writeFailed(const QString& error);
+
+protected:
+    void run() override;
+
+private:
+    static constexpr int maxBatchSize = 256;
+    static constexpr int retryDelayMs = 200;
+
+    QString m_databasePath;
+    DBPerformanceProfile m_profile;
+    QString m_connectionName;
+    Utils::MpscQueue<Event> m_queue;
+
+    std::atomic<quint64> m_wakeups { 0 };
+    std::atomic<bool> m_stopping { false };
+
+    std::atomic<qint64> m_enqueued { 0 };
+    std::atomic<qint64> m_queueDepth { 0 };
+    std::atomic<qint64> m_committedEvents { 0 };
+    std::atomic<qint64> m_committedBatches { 0 };
+    std::atomic<qint64> m_failedCommits { 0 };
+    std::atomic<qint64> m_droppedEvents { 0 };
+    std::atomic<qint64> m_rejectedEvents { 0 };
+    std::atomic<qint64> m_duplicateEvents { 0 };
+    std::atomic<qint64> m_lastCommitLatencyUs { 0 };
+    std::atomic<qint64> m_maxCommitLatencyUs { 0 };
+
+    void wake();
+    // transient is set when the failure may go away on retry (busy, locked, I/O)
+    [[nodiscard]] bool commitBatch(const Repository& resultsRepo, const Checkpoints::Repository& checkpointsRepo,
+                                   const QVector<Event>& batch, QString& error, bool& transient);
+    // Commits the events one at a time, rejecting those that fail for good. Stops at the first
+    // transient failure and returns how many events were committed or rejected.
+    [[nodiscard]] qsizetype commitEach(const Repository& resultsRepo, const Checkpoints::Repository& checkpointsRepo,
+                                       const QVector<Event>& batch, QString& error);
+    [[nodiscard]] static QStringList taggedEventIds(const QVector<Event>& events);
+};
+
+};
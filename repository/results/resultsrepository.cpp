@@ -1,44 +1,10 @@
 #include "resultsrepository.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include "dbmanager.h"
+#include "utils/timeutils.h"
 
 Results::Repository::Repository(const QSqlDatabase& db) : m_db(db) {
-    if (auto value = createResultsTable(); !value) {
-        qFatal("Results table creation failed: %s", value.error().toLocal8Bit().constData());
-    }
-}
-
-tl::expected<void, QString> Results::Repository::createResultsTable() const {
-    QSqlQuery query(m_db);
-
-    QString sql = R"(
-        CREATE TABLE IF NOT EXISTS results (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            registrationId INTEGER NOT NULL,
-            startTime TEXT NOT NULL,
-            endTime TEXT,
-            durationMs INTEGER,
-            notes TEXT,
-
-            FOREIGN KEY (registrationId)
-                REFERENCES registrations(id)
-                ON DELETE CASCADE
-        );
-    )";
-
-    if (!query.exec(sql)) {
-        return tl::unexpected("[ResR] Error creating results: " + query.lastError().text());
-    }
-
-    sql = R"(
-        CREATE INDEX IF NOT EXISTS idx_results_registration ON results(registrationId);
-    )";
-
-    if (!query.exec(sql)) {
-        return tl::unexpected("[ResR] Error creating index idx_results_registration: " + query.lastError().text());
-    }
-
-    return {};
 }
 
 tl::expected<Results::Result, QString> Results::Repository::createResult(
@@ -46,30 +12,31 @@ tl::expected<Results::Result, QString> Results::Repository::createResult(
     const QDateTime& startTime, 
     const QDateTime& endTime,
     const int durationMs,
-    const QString& notes) const {
+    const QString& notes,
+    const qint64 elapsedNs) const {
 
     if (!startTime.isValid()) {
         return tl::unexpected("[ResR] Invalid start time");
     }
 
-    QSqlQuery queryInsert(m_db);
     const QString sql = R"(
-        INSERT INTO results(registrationId, startTime, endTime, durationMs, notes) 
-        VALUES(:registrationId, :startTime, :endTime, :durationMs, :notes)
+        INSERT INTO results(registrationId, startTime, endTime, durationMs, notes, elapsedNs) 
+        VALUES(:registrationId, :startTime, :endTime, :durationMs, :notes, :elapsedNs)
     )";
 
-    queryInsert.prepare(sql);
-    queryInsert.bindValue(":registrationId", registrationId);
-    queryInsert.bindValue(":startTime", startTime.toString(Qt::ISODate));
-    queryInsert.bindValue(":endTime", endTime.isValid() ? endTime.toString(Qt::ISODate) : QVariant());
-    queryInsert.bindValue(":durationMs", durationMs);
-    queryInsert.bindValue(":notes", notes);
+    auto queryInsert = DBManager::statement(m_db, sql);
+    queryInsert->bindValue(":registrationId", registrationId);
+    queryInsert->bindValue(":startTime", startTime.toMSecsSinceEpoch());
+    queryInsert->bindValue(":endTime", endTime.isValid() ? QVariant(endTime.toMSecsSinceEpoch()) : QVariant());
+    queryInsert->bindValue(":durationMs", durationMs);
+    queryInsert->bindValue(":notes", notes);
+    queryInsert->bindValue(":elapsedNs", elapsedNs > 0 ? QVariant(elapsedNs) : QVariant());
 
-    if (!queryInsert.exec()) {
-        return tl::unexpected("[ResR] Error inserting result: " + queryInsert.lastError().text());
+    if (!queryInsert->exec()) {
+        return tl::unexpected("[ResR] Error inserting result: " + queryInsert->lastError().text());
     }
 
-    const int newId = queryInsert.lastInsertId().toInt();
+    const int newId = queryInsert->lastInsertId().toInt();
     
     return (Result) {
         .id = newId,
@@ -77,86 +44,174 @@ tl::expected<Results::Result, QString> Results::Repository::createResult(
         .startTime = startTime,
         .endTime = endTime,
         .durationMs = durationMs,
-        .notes = notes
+        .notes = notes,
+        .elapsedNs = elapsedNs
     };
 }
 
+tl::expected<QVector<Results::Result>, QString> Results::Repository::createResults(const QVector<Result>& results) const {
+    return createResults(results, {});
+}
+
+tl::expected<QVector<Results::Result>, QString> Results::Repository::createResults(const QVector<Result>& results,
+                                                                                  const QStringList& eventIds,
+                                                                                  QSqlError* sqlError) const {
+    if (results.isEmpty()) {
+        return QVector<Result>();
+    }
+
+    if (!eventIds.isEmpty() && eventIds.size() != results.size()) {
+        return tl::unexpected(QString("[ResR] %1 event id(s) for %2 result(s)").arg(eventIds.size()).arg(results.size()));
+    }
+
+    for (const auto& result : results) {
+        if (!result.startTime.isValid()) {
+            return tl::unexpected("[ResR] Invalid start time for registration " + QString::number(result.registrationId));
+        }
+    }
+
+    QSqlDatabase db = m_db;
+    if (!db.transaction()) {
+        if (sqlError) {
+            *sqlError = db.lastError();
+        }
+        return tl::unexpected("[ResR] Error starting transaction: " + db.lastError().text());
+    }
+
+    // Tagged batches skip events already stored (eventId unique index); untagged ones keep failing on any conflict
+    const QString sql = eventIds.isEmpty()
+        ? QStringLiteral(R"(
+            INSERT INTO results(registrationId, startTime, endTime, durationMs, notes, elapsedNs, eventId)
+            VALUES(:registrationId, :startTime, :endTime, :durationMs, :notes, :elapsedNs, :eventId)
+        )")
+        : QStringLiteral(R"(
+            INSERT OR IGNORE INTO results(registrationId, startTime, endTime, durationMs, notes, elapsedNs, eventId)
+            VALUES(:registrationId, :startTime, :endTime, :durationMs, :notes, :elapsedNs, :eventId)
+        )");
+
+    auto queryInsert = DBManager::statement(db, sql);
+
+    QVector<Result> created;
+    created.reserve(results.size());
+
+    for (qsizetype i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        const QString eventId = eventIds.isEmpty() ? QString() : eventIds[i];
+
+        queryInsert->bindValue(":registrationId", result.registrationId);
+        queryInsert->bindValue(":startTime", result.startTime.toMSecsSinceEpoch());
+        queryInsert->bindValue(":endTime", result.endTime.isValid() ? QVariant(result.endTime.toMSecsSinceEpoch()) : QVariant());
+        queryInsert->bindValue(":durationMs", result.durationMs);
+        queryInsert->bindValue(":notes", result.notes);
+        queryInsert->bindValue(":elapsedNs", result.elapsedNs > 0 ? QVariant(result.elapsedNs) : QVariant());
+        queryInsert->bindValue(":eventId", eventId.isEmpty() ? QVariant() : QVariant(eventId));
+
+        if (!queryInsert->exec()) {
+            const QSqlError error = queryInsert->lastError();
+            db.rollback();
+            if (sqlError) {
+                *sqlError = error;
+            }
+            return tl::unexpected("[ResR] Error inserting result for registration " + QString::number(result.registrationId) + ": " + error.text());
+        }
+
+        if (queryInsert->numRowsAffected() == 0) {
+            continue; // event already stored
+        }
+
+        Result stored = result;
+        stored.id = queryInsert->lastInsertId().toInt();
+        created.push_back(stored);
+    }
+
+    if (!db.commit()) {
+        const QSqlError error = db.lastError();
+        db.rollback();
+        if (sqlError) {
+            *sqlError = error;
+        }
+        return tl::unexpected("[ResR] Error committing results: " + error.text());
+    }
+
+    return created;
+}
+
 tl::expected<Results::Result, QString> Results::Repository::getResultById(const int id) const {
     const QString sql = R"(
-        SELECT registrationId, startTime, endTime, durationMs, notes
+        SELECT registrationId, startTime, endTime, durationMs, notes, elapsedNs
         FROM results
         WHERE id = :id
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
-    querySelect.bindValue(":id", id);
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":id", id);
 
-    if (!querySelect.exec() || !querySelect.next()) {
-        return tl::unexpected("[ResR] Error fetching result with id " + QString::number(id) + ": " + querySelect.lastError().text());
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[ResR] Error fetching result with id " + QString::number(id) + ": " + querySelect->lastError().text());
     }
 
     return (Result) {
         .id = id,
-        .registrationId = querySelect.value(0).toInt(),
-        .startTime = QDateTime::fromString(querySelect.value(1).toString(), Qt::ISODate),
-        .endTime = querySelect.value(2).isNull() ? QDateTime() : QDateTime::fromString(querySelect.value(2).toString(), Qt::ISODate),
-        .durationMs = querySelect.value(3).toInt(),
-        .notes = querySelect.value(4).toString()
+        .registrationId = querySelect->value(0).toInt(),
+        .startTime = Utils::DateTimeUtils::fromEpochMs(querySelect->value(1)),
+        .endTime = Utils::DateTimeUtils::fromEpochMs(querySelect->value(2)),
+        .durationMs = querySelect->value(3).toInt(),
+        .notes = querySelect->value(4).toString(),
+        .elapsedNs = querySelect->value(5).toLongLong()
     };
 }
 
 tl::expected<Results::Result, QString> Results::Repository::getResultByRegistration(const int registrationId) const {
     const QString sql = R"(
-        SELECT id, startTime, endTime, durationMs, notes
+        SELECT id, startTime, endTime, durationMs, notes, elapsedNs
         FROM results
         WHERE registrationId = :registrationId
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
-    querySelect.bindValue(":registrationId", registrationId);
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":registrationId", registrationId);
 
-    if (!querySelect.exec() || !querySelect.next()) {
-        return tl::unexpected("[ResR] Error fetching result for registration " + QString::number(registrationId) + ": " + querySelect.lastError().text());
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[ResR] Error fetching result for registration " + QString::number(registrationId) + ": " + querySelect->lastError().text());
     }
 
     return (Result) {
-        .id = querySelect.value(0).toInt(),
+        .id = querySelect->value(0).toInt(),
         .registrationId = registrationId,
-        .startTime = QDateTime::fromString(querySelect.value(1).toString(), Qt::ISODate),
-        .endTime = querySelect.value(2).isNull() ? QDateTime() : QDateTime::fromString(querySelect.value(2).toString(), Qt::ISODate),
-        .durationMs = querySelect.value(3).toInt(),
-        .notes = querySelect.value(4).toString()
+        .startTime = Utils::DateTimeUtils::fromEpochMs(querySelect->value(1)),
+        .endTime = Utils::DateTimeUtils::fromEpochMs(querySelect->value(2)),
+        .durationMs = querySelect->value(3).toInt(),
+        .notes = querySelect->value(4).toString(),
+        .elapsedNs = querySelect->value(5).toLongLong()
     };
 }
 
 tl::expected<QVector<Results::Result>, QString> Results::Repository::getResultsByTrial(int trialId) const {
     const QString sql = R"(
-        SELECT r.id, r.registrationId, r.startTime, r.endTime, r.durationMs, r.notes
+        SELECT r.id, r.registrationId, r.startTime, r.endTime, r.durationMs, r.notes, r.elapsedNs
         FROM results r
         INNER JOIN registrations reg ON r.registrationId = reg.id
         WHERE reg.trialId = :trialId
         ORDER BY r.durationMs ASC
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
-    querySelect.bindValue(":trialId", trialId);
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":trialId", trialId);
 
-    if (!querySelect.exec()) {
-        return tl::unexpected("[ResR] Error fetching results for trial " + QString::number(trialId) + ": " + querySelect.lastError().text());
+    if (!querySelect->exec()) {
+        return tl::unexpected("[ResR] Error fetching results for trial " + QString::number(trialId) + ": " + querySelect->lastError().text());
     }
 
     QVector<Result> results;
-    while (querySelect.next()) {
+    while (querySelect->next()) {
         results.push_back({
-            .id = querySelect.value(0).toInt(),
-            .registrationId = querySelect.value(1).toInt(),
-            .startTime = QDateTime::fromString(querySelect.value(2).toString(), Qt::ISODate),
-            .endTime = querySelect.value(3).isNull() ? QDateTime() : QDateTime::fromString(querySelect.value(3).toString(), Qt::ISODate),
-            .durationMs = querySelect.value(4).toInt(),
-            .notes = querySelect.value(5).toString()
+            .id = querySelect->value(0).toInt(),
+            .registrationId = querySelect->value(1).toInt(),
+            .startTime = Utils::DateTimeUtils::fromEpochMs(querySelect->value(2)),
+            .endTime = Utils::DateTimeUtils::fromEpochMs(querySelect->value(3)),
+            .durationMs = querySelect->value(4).toInt(),
+            .notes = querySelect->value(5).toString(),
+            .elapsedNs = querySelect->value(6).toLongLong()
         });
     }
 
@@ -165,27 +220,27 @@ tl::expected<QVector<Results::Result>, QString> Results::Repository::getResultsB
 
 tl::expected<QVector<Results::Result>, QString> Results::Repository::getAllResults() const {
     const QString sql = R"(
-        SELECT id, registrationId, startTime, endTime, durationMs, notes
+        SELECT id, registrationId, startTime, endTime, durationMs, notes, elapsedNs
         FROM results
         ORDER BY durationMs ASC
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
+    auto querySelect = DBManager::statement(m_db, sql);
 
-    if (!querySelect.exec()) {
-        return tl::unexpected("[ResR] Error fetching all results: " + querySelect.lastError().text());
+    if (!querySelect->exec()) {
+        return tl::unexpected("[ResR] Error fetching all results: " + querySelect->lastError().text());
     }
 
     QVector<Result> results;
-    while (querySelect.next()) {
+    while (querySelect->next()) {
         results.push_back({
-            .id = querySelect.value(0).toInt(),
-            .registrationId = querySelect.value(1).toInt(),
-            .startTime = QDateTime::fromString(querySelect.value(2).toString(), Qt::ISODate),
-            .endTime = querySelect.value(3).isNull() ? QDateTime() : QDateTime::fromString(querySelect.value(3).toString(), Qt::ISODate),
-            .durationMs = querySelect.value(4).toInt(),
-            .notes = querySelect.value(5).toString()
+            .id = querySelect->value(0).toInt(),
+            .registrationId = querySelect->value(1).toInt(),
+            .startTime = Utils::DateTimeUtils::fromEpochMs(querySelect->value(2)),
+            .endTime = Utils::DateTimeUtils::fromEpochMs(querySelect->value(3)),
+            .durationMs = querySelect->value(4).toInt(),
+            .notes = querySelect->value(5).toString(),
+            .elapsedNs = querySelect->value(6).toLongLong()
         });
     }
 
@@ -197,59 +252,92 @@ tl::expected<Results::Result, QString> Results::Repository::updateResultById(con
         return tl::unexpected("[ResR] Invalid start time");
     }
 
-    QSqlQuery queryUpdate(m_db);
     const QString sql = R"(
         UPDATE results
         SET registrationId = :registrationId, startTime = :startTime, endTime = :endTime, 
-            durationMs = :durationMs, notes = :notes
+            durationMs = :durationMs, notes = :notes, elapsedNs = :elapsedNs
         WHERE id = :id
     )";
 
-    queryUpdate.prepare(sql);
-    queryUpdate.bindValue(":id", id);
-    queryUpdate.bindValue(":registrationId", result.registrationId);
-    queryUpdate.bindValue(":startTime", result.startTime.toString(Qt::ISODate));
-    queryUpdate.bindValue(":endTime", result.endTime.isValid() ? result.endTime.toString(Qt::ISODate) : QVariant());
-    queryUpdate.bindValue(":durationMs", result.durationMs);
-    queryUpdate.bindValue(":notes", result.notes);
-
-    if (!queryUpdate.exec()) {
-        return tl::unexpected("[ResR] Error updating result " + QString::number(id) + ": " + queryUpdate.lastError().text());
+    auto queryUpdate = DBManager::statement(m_db, sql);
+    queryUpdate->bindValue(":id", id);
+    queryUpdate->bindValue(":registrationId", result.registrationId);
+    queryUpdate->bindValue(":startTime", result.startTime.toMSecsSinceEpoch());
+    queryUpdate->bindValue(":endTime", result.endTime.isValid() ? QVariant(result.endTime.toMSecsSinceEpoch()) : QVariant());
+    queryUpdate->bindValue(":durationMs", result.durationMs);
+    queryUpdate->bindValue(":notes", result.notes);
+    queryUpdate->bindValue(":elapsedNs", result.elapsedNs > 0 ? QVariant(result.elapsedNs) : QVariant());
+
+    if (!queryUpdate->exec()) {
+        return tl::unexpected("[ResR] Error updating result " + QString::number(id) + ": " + queryUpdate->lastError().text());
     }
 
     return result;
 }
 
 tl::expected<int, QString> Results::Repository::deleteResultById(const int id) const {
-    QSqlQuery queryDelete(m_db);
     const QString sql = R"(
         DELETE FROM results
         WHERE id = :id
     )";
 
-    queryDelete.prepare(sql);
-    queryDelete.bindValue(":id", id);
+    auto queryDelete = DBManager::statement(m_db, sql);
+    queryDelete->bindValue(":id", id);
 
-    if (!queryDelete.exec()) {
-        return tl::unexpected("[ResR] Error deleting result " + QString::number(id) + ": " + queryDelete.lastError().text());
+    if (!queryDelete->exec()) {
+        return tl::unexpected("[ResR] Error deleting result " + QString::number(id) + ": " + queryDelete->lastError().text());
     }
 
     return id;
 }
 
 tl::expected<int, QString> Results::Repository::deleteResultsByRegistration(const int registrationId) const {
-    QSqlQuery queryDelete(m_db);
     const QString sql = R"(
         DELETE FROM results
         WHERE registrationId = :registrationId
     )";
 
-    queryDelete.prepare(sql);
-    queryDelete.bindValue(":registrationId", registrationId);
+    auto queryDelete = DBManager::statement(m_db, sql);
+    queryDelete->bindValue(":registrationId", registrationId);
 
-    if (!queryDelete.exec()) {
-        return tl::unexpected("[ResR] Error deleting results for registration " + QString::number(registrationId) + ": " + queryDelete.lastError().text());
+    if (!queryDelete->exec()) {
+        return tl::unexpected("[ResR] Error deleting results for registration " + QString::number(registrationId) + ": " + queryDelete->lastError().text());
     }
 
     return registrationId;
 }
+
+tl::expected<int, QString> Results::Repository::deleteResultsByTrial(const int trialId) const {
+    QSqlDatabase db = m_db;
+    if (!db.transaction()) {
+        return tl::unexpected("[ResR] Error starting transaction: " + db.lastError().text());
+    }
+
+    auto queryResults = DBManager::statement(db, R"(
+        DELETE FROM results
+        WHERE registrationId IN (SELECT id FROM registrations WHERE trialId = :trialId)
+    )");
+    queryResults->bindValue(":trialId", trialId);
+
+    // Left behind, old splits would stay in the split rankings and their event ids would
+    // swallow the new splits of a station that restarts its counter
+    auto queryCrossings = DBManager::statement(db, R"(
+        DELETE FROM crossings
+        WHERE checkpointId IN (SELECT id FROM checkpoints WHERE trialId = :trialId)
+    )");
+    queryCrossings->bindValue(":trialId", trialId);
+
+    if (!queryResults->exec() || !queryCrossings->exec()) {
+        const QString error = queryResults->lastError().isValid() ? queryResults->lastError().text() : queryCrossings->lastError().text();
+        db.rollback();
+        return tl::unexpected("[ResR] Error deleting results for trial " + QString::number(trialId) + ": " + error);
+    }
+    const int deleted = queryResults->numRowsAffected() + queryCrossings->numRowsAffected();
+
+    if (!db.commit()) {
+        const QString error = db.lastError().text();
+        db.rollback();
+        return tl::unexpected("[ResR] Error committing deletion of trial " + QString::number(trialId) + " results: " + error);
+    }
+    return deleted;
+}
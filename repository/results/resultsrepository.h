@@ -2,7 +2,9 @@
 
 #include "result.h"
 #include <QSqlDatabase>
+#include <QSqlError>
 #include <QString>
+#include <QStringList>
 #include <QDateTime>
 #include <tl/expected.hpp>
 
@@ -18,8 +20,17 @@ public:
         const QDateTime& startTime, 
         const QDateTime& endTime, 
         int durationMs, 
-        const QString& notes = ""
+        const QString& notes = "",
+        qint64 elapsedNs = 0
     ) const;
+    // Inserts all results in a single transaction; either every row is stored or none is
+    [[nodiscard]] tl::expected<QVector<Result>, QString> createResults(const QVector<Result>& results) const;
+    // Same, for results tagged with an event id (parallel to results; empty ids are untagged).
+    // A tagged result whose id is already stored is skipped, so replaying events is harmless;
+    // only the rows actually inserted are returned. The SQLite error behind a failure goes to sqlError when given.
+    [[nodiscard]] tl::expected<QVector<Result>, QString> createResults(const QVector<Result>& results,
+                                                                       const QStringList& eventIds,
+                                                                       QSqlError* sqlError = nullptr) const;
     [[nodiscard]] tl::expected<Result, QString> getResultById(int id) const;
     [[nodiscard]] tl::expected<Result, QString> getResultByRegistration(int registrationId) const;
     [[nodiscard]] tl::expected<QVector<Result>, QString> getResultsByTrial(int trialId) const;
@@ -27,10 +38,12 @@ public:
     [[nodiscard]] tl::expected<Result, QString> updateResultById(int id, const Result& result) const;
     [[nodiscard]] tl::expected<int, QString> deleteResultById(int id) const;
     [[nodiscard]] tl::expected<int, QString> deleteResultsByRegistration(int registrationId) const;
+    // Clears a trial for a fresh start: its results and the crossings at its checkpoints go in one
+    // transaction. Returns how many rows were removed.
+    [[nodiscard]] tl::expected<int, QString> deleteResultsByTrial(int trialId) const;
 
 private:
     QSqlDatabase m_db;
-    [[nodiscard]] tl::expected<void, QString> createResultsTable() const;
 };
 
 };
@@ -1,6 +1,7 @@
 #include "trialsrepository.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include "dbmanager.h"
 #include <QDebug>
 #include <algorithm>
 #include <optional>
@@ -9,30 +10,6 @@
 namespace Trials {
 
 Repository::Repository(const QSqlDatabase& db) : m_db(db) {
-    if (auto value = createTrialsTable(); !value) {
-        qFatal("Trials table creation failed: %s", value.error().toLocal8Bit().constData());
-    }
-}
-
-tl::expected<void, QString> Repository::createTrialsTable() const {
-    QSqlQuery query(m_db);
-
-    const QString sql = R"(
-        CREATE TABLE IF NOT EXISTS trials (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            name TEXT NOT NULL UNIQUE,
-            scheduledDateTime TEXT,
-            startDateTime TEXT,
-            endDateTime TEXT,
-            createdAt TEXT NOT NULL DEFAULT (datetime('now'))
-        );
-    )";
-
-    if (!query.exec(sql)) {
-        return tl::unexpected("[TR] Error creating trials:" + query.lastError().text());
-    }
-
-    return {};
 }
 
 tl::expected<TrialInfo, QString> Repository::createTrial(const QString& name, const QDateTime& schedTime) const {
@@ -40,17 +17,16 @@ tl::expected<TrialInfo, QString> Repository::createTrial(const QString& name, co
         return tl::unexpected("[TR]: invalid name");
     }
 
-    QSqlQuery queryInsert(m_db);
     QString sql = R"(
         INSERT OR IGNORE INTO trials(name, scheduledDateTime) VALUES(:name, :schedTime)
     )";
 
-    queryInsert.prepare(sql);
-    queryInsert.bindValue(":name", name.trimmed());
-    queryInsert.bindValue(":schedTime", schedTime.toString(Qt::ISODate));
+    auto queryInsert = DBManager::statement(m_db, sql);
+    queryInsert->bindValue(":name", name.trimmed());
+    queryInsert->bindValue(":schedTime", Utils::DateTimeUtils::toEpochMsOrNull(schedTime));
 
-    if (!queryInsert.exec()) {
-        return tl::unexpected("[TR]: Error inserting " + name + " into trials table. Error: " + queryInsert.lastError().text());
+    if (!queryInsert->exec()) {
+        return tl::unexpected("[TR]: Error inserting " + name + " into trials table. Error: " + queryInsert->lastError().text());
     }
 
     sql = R"(
@@ -61,17 +37,16 @@ tl::expected<TrialInfo, QString> Repository::createTrial(const QString& name, co
         WHERE name = :name
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
-    querySelect.bindValue(":name", name.trimmed());
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":name", name.trimmed());
 
-    if (!querySelect.exec() || !querySelect.next()) {
-        return tl::unexpected("[TR]: Error fetching '" + name + "' from trials table. Error: " + querySelect.lastError().text());
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[TR]: Error fetching '" + name + "' from trials table. Error: " + querySelect->lastError().text());
     }
 
     return (TrialInfo) {
-        .id = querySelect.value(0).toInt(),
-        .name = querySelect.value(1).toString(),
+        .id = querySelect->value(0).toInt(),
+        .name = querySelect->value(1).toString(),
         .scheduledDateTime = schedTime,
         .startDateTime = Utils::DateTimeUtils::epochZero(),
         .endDateTime = Utils::DateTimeUtils::epochZero()
@@ -89,32 +64,30 @@ tl::expected<TrialInfo, QString> Repository::getTrialById(const int id) const {
         WHERE id = :id
     )";
 
-    QSqlQuery querySelect(m_db);
-    querySelect.prepare(sql);
-    querySelect.bindValue(":id", id);
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":id", id);
 
-    if (!querySelect.exec()) {
-        return tl::unexpected("[TR]: Error fetching '" + QString::number(id) + "' from trials table. Error: " + querySelect.lastError().text());
+    if (!querySelect->exec()) {
+        return tl::unexpected("[TR]: Error fetching '" + QString::number(id) + "' from trials table. Error: " + querySelect->lastError().text());
     }
 
-    if (querySelect.next()) {
-        const auto scheduledDateTime = querySelect.value(1).toString();
-        const auto startDateTime = querySelect.value(2).toString();
-        const auto endDateTime = querySelect.value(3).toString();
+    if (querySelect->next()) {
+        const auto scheduledDateTime = querySelect->value(1);
+        const auto startDateTime = querySelect->value(2);
+        const auto endDateTime = querySelect->value(3);
 
         return (TrialInfo) {
             .id = id,
-            .name = querySelect.value(0).toString(),
-            .scheduledDateTime = Utils::DateTimeUtils::fromStringOrDefault(scheduledDateTime),
-            .startDateTime = Utils::DateTimeUtils::fromStringOrDefault(startDateTime),
-            .endDateTime = Utils::DateTimeUtils::fromStringOrDefault(endDateTime),
+            .name = querySelect->value(0).toString(),
+            .scheduledDateTime = Utils::DateTimeUtils::fromEpochMsOrDefault(scheduledDateTime),
+            .startDateTime = Utils::DateTimeUtils::fromEpochMsOrDefault(startDateTime),
+            .endDateTime = Utils::DateTimeUtils::fromEpochMsOrDefault(endDateTime),
         };
     }
     return {};
 }
 
 tl::expected<TrialInfo, QString> Repository::getTrialByName(const QString& name) const {
-    QSqlQuery querySelect(m_db);
     const QString sql = R"(
         SELECT
             id,
@@ -125,31 +98,30 @@ tl::expected<TrialInfo, QString> Repository::getTrialByName(const QString& name)
         WHERE name = :name
     )";
 
-    querySelect.prepare(sql);
-    querySelect.bindValue(":name", name.trimmed());
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":name", name.trimmed());
 
-    if (!querySelect.exec()) {
-        return tl::unexpected("[TR]: Error fetching '" + name + "' from trials table. Error: " + querySelect.lastError().text());
+    if (!querySelect->exec()) {
+        return tl::unexpected("[TR]: Error fetching '" + name + "' from trials table. Error: " + querySelect->lastError().text());
     }
 
-    if (querySelect.next()) {
-        const auto scheduledDateTime = querySelect.value(1).toString();
-        const auto startDateTime = querySelect.value(2).toString();
-        const auto endDateTime = querySelect.value(3).toString();
+    if (querySelect->next()) {
+        const auto scheduledDateTime = querySelect->value(1);
+        const auto startDateTime = querySelect->value(2);
+        const auto endDateTime = querySelect->value(3);
 
         return (TrialInfo) {
-            .id = querySelect.value(0).toInt(),
+            .id = querySelect->value(0).toInt(),
             .name = name,
-            .scheduledDateTime = Utils::DateTimeUtils::fromStringOrDefault(scheduledDateTime),
-            .startDateTime = Utils::DateTimeUtils::fromStringOrDefault(startDateTime),
-            .endDateTime = Utils::DateTimeUtils::fromStringOrDefault(endDateTime),
+            .scheduledDateTime = Utils::DateTimeUtils::fromEpochMsOrDefault(scheduledDateTime),
+            .startDateTime = Utils::DateTimeUtils::fromEpochMsOrDefault(startDateTime),
+            .endDateTime = Utils::DateTimeUtils::fromEpochMsOrDefault(endDateTime),
         };
     }
     return {};
 }
 
 tl::expected<QVector<TrialInfo>, QString> Repository::getAllTrials() const {
-    QSqlQuery querySelect(m_db);
     const QString sql = R"(
         SELECT
             id,
@@ -161,22 +133,23 @@ tl::expected<QVector<TrialInfo>, QString> Repository::getAllTrials() const {
         ORDER BY scheduledDateTime DESC
     )";
 
-    if (!querySelect.exec(sql)) {
-        return tl::unexpected("[TR]: Error fetching registers from trials table. Error: " + querySelect.lastError().text());
+    auto querySelect = DBManager::statement(m_db, sql);
+    if (!querySelect->exec()) {
+        return tl::unexpected("[TR]: Error fetching registers from trials table. Error: " + querySelect->lastError().text());
     }
 
     QVector<TrialInfo> results;
-    while (querySelect.next()) {
-        const auto scheduledDateTime = querySelect.value(2).toString();
-        const auto startDateTime = querySelect.value(3).toString();
-        const auto endDateTime = querySelect.value(4).toString();
+    while (querySelect->next()) {
+        const auto scheduledDateTime = querySelect->value(2);
+        const auto startDateTime = querySelect->value(3);
+        const auto endDateTime = querySelect->value(4);
 
         results.push_back({
-            .id = querySelect.value(0).toInt(),
-            .name = querySelect.value(1).toString(),
-            .scheduledDateTime = Utils::DateTimeUtils::fromStringOrDefault(scheduledDateTime),
-            .startDateTime = Utils::DateTimeUtils::fromStringOrDefault(startDateTime),
-            .endDateTime = Utils::DateTimeUtils::fromStringOrDefault(endDateTime),
+            .id = querySelect->value(0).toInt(),
+            .name = querySelect->value(1).toString(),
+            .scheduledDateTime = Utils::DateTimeUtils::fromEpochMsOrDefault(scheduledDateTime),
+            .startDateTime = Utils::DateTimeUtils::fromEpochMsOrDefault(startDateTime),
+            .endDateTime = Utils::DateTimeUtils::fromEpochMsOrDefault(endDateTime),
         });
     }
 
@@ -184,7 +157,6 @@ tl::expected<QVector<TrialInfo>, QString> Repository::getAllTrials() const {
 }
 
 tl::expected<QVector<TrialInfo>, QString> Repository::getTrialsByDate(const QDate& date) const {
-    QSqlQuery querySelect(m_db);
     const QString sql = R"(
         SELECT
             id,
@@ -193,29 +165,31 @@ tl::expected<QVector<TrialInfo>, QString> Repository::getTrialsByDate(const QDat
             startDateTime,
             endDateTime
         FROM trials
-        WHERE DATE(scheduledDateTime) = :date
+        WHERE scheduledDateTime >= :dayStart AND scheduledDateTime < :dayEnd
         ORDER BY scheduledDateTime ASC
     )";
 
-    querySelect.prepare(sql);
-    querySelect.bindValue(":date", date.toString(Qt::ISODate));
+    // Range over the local day so the idx_trials_scheduled index can be used
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":dayStart", date.startOfDay().toMSecsSinceEpoch());
+    querySelect->bindValue(":dayEnd", date.addDays(1).startOfDay().toMSecsSinceEpoch());
 
-    if (!querySelect.exec()) {
-        return tl::unexpected("[TR]: Error fetching trials by date from trials table. Error: " + querySelect.lastError().text());
+    if (!querySelect->exec()) {
+        return tl::unexpected("[TR]: Error fetching trials by date from trials table. Error: " + querySelect->lastError().text());
     }
 
     QVector<Trials::TrialInfo> results;
-    while (querySelect.next()) {
-        const auto scheduledDateTime = querySelect.value(2).toString();
-        const auto startDateTime = querySelect.value(3).toString();
-        const auto endDateTime = querySelect.value(4).toString();
+    while (querySelect->next()) {
+        const auto scheduledDateTime = querySelect->value(2);
+        const auto startDateTime = querySelect->value(3);
+        const auto endDateTime = querySelect->value(4);
 
         results.push_back({
-           .id = querySelect.value(0).toInt(),
-           .name = querySelect.value(1).toString(),
-            .scheduledDateTime = Utils::DateTimeUtils::fromStringOrDefault(scheduledDateTime),
-            .startDateTime = Utils::DateTimeUtils::fromStringOrDefault(startDateTime),
-            .endDateTime = Utils::DateTimeUtils::fromStringOrDefault(endDateTime),
+           .id = querySelect->value(0).toInt(),
+           .name = querySelect->value(1).toString(),
+            .scheduledDateTime = Utils::DateTimeUtils::fromEpochMsOrDefault(scheduledDateTime),
+            .startDateTime = Utils::DateTimeUtils::fromEpochMsOrDefault(startDateTime),
+            .endDateTime = Utils::DateTimeUtils::fromEpochMsOrDefault(endDateTime),
         });
     }
 
@@ -223,7 +197,6 @@ tl::expected<QVector<TrialInfo>, QString> Repository::getTrialsByDate(const QDat
 }
 
 tl::expected<TrialInfo, QString> Repository::updateTrialById(const int id, const TrialInfo& trial) const {
-    QSqlQuery queryUpdate(m_db);
     QStringList updateFields;
     
     if (Utils::DateTimeUtils::isValid(trial.endDateTime)) {
@@ -247,49 +220,49 @@ tl::expected<TrialInfo, QString> Repository::updateTrialById(const int id, const
                      .arg(updateFields.join(", "));
 
     qDebug() << "[TR] Generated SQL:" << sql;
-    queryUpdate.prepare(sql);
+    // Only a handful of field combinations exist, so each one gets its own cached statement
+    auto queryUpdate = DBManager::statement(m_db, sql);
     
     if (Utils::DateTimeUtils::isValid(trial.endDateTime)) {
-        queryUpdate.bindValue(":endDateTime", trial.endDateTime.toString(Qt::ISODate));
+        queryUpdate->bindValue(":endDateTime", trial.endDateTime.toMSecsSinceEpoch());
         qDebug() << "[TR] Binding endDateTime:" << trial.endDateTime.toString(Qt::ISODate);
     }
     if (Utils::DateTimeUtils::isValid(trial.startDateTime)) {
-        queryUpdate.bindValue(":startDateTime", trial.startDateTime.toString(Qt::ISODate));
+        queryUpdate->bindValue(":startDateTime", trial.startDateTime.toMSecsSinceEpoch());
         qDebug() << "[TR] Binding startDateTime:" << trial.startDateTime.toString(Qt::ISODate);
     }
     if (Utils::DateTimeUtils::isValid(trial.scheduledDateTime)) {
-        queryUpdate.bindValue(":scheduledDateTime", trial.scheduledDateTime.toString(Qt::ISODate));
+        queryUpdate->bindValue(":scheduledDateTime", trial.scheduledDateTime.toMSecsSinceEpoch());
         qDebug() << "[TR] Binding scheduledDateTime:" << trial.scheduledDateTime.toString(Qt::ISODate);
     }
     if (!trial.name.isEmpty()) {
-        queryUpdate.bindValue(":name", trial.name);
+        queryUpdate->bindValue(":name", trial.name);
         qDebug() << "[TR] Binding name:" << trial.name;
     }
 
-    queryUpdate.bindValue(":id", id);
+    queryUpdate->bindValue(":id", id);
     qDebug() << "[TR] Binding id:" << id;
 
-    if (!queryUpdate.exec()) {
-        qDebug() << "[TR] SQL execution failed. Last query:" << queryUpdate.lastQuery();
-        qDebug() << "[TR] Bound values:" << queryUpdate.boundValues();
-        return tl::unexpected("[TR]: Error updating '" + QString::number(id) + "' entry on trials table. Error: " + queryUpdate.lastError().text());
+    if (!queryUpdate->exec()) {
+        qDebug() << "[TR] SQL execution failed. Last query:" << queryUpdate->lastQuery();
+        qDebug() << "[TR] Bound values:" << queryUpdate->boundValues();
+        return tl::unexpected("[TR]: Error updating '" + QString::number(id) + "' entry on trials table. Error: " + queryUpdate->lastError().text());
     }
 
     return getTrialById(id);
 }
 
 tl::expected<int, QString> Repository::deleteTrialById(const int id) const {
-    QSqlQuery queryUpdate(m_db);
     const QString sql = R"(
         DELETE FROM trials
         WHERE id = :id
     )";
 
-    queryUpdate.prepare(sql);
-    queryUpdate.bindValue(":id", id);
+    auto queryUpdate = DBManager::statement(m_db, sql);
+    queryUpdate->bindValue(":id", id);
 
-    if (!queryUpdate.exec()) {
-        return tl::unexpected("[TR]: Error updating '" + QString::number(id) + "'entry on trials table. Error: " + queryUpdate.lastError().text());
+    if (!queryUpdate->exec()) {
+        return tl::unexpected("[TR]: Error updating '" + QString::number(id) + "'entry on trials table. Error: " + queryUpdate->lastError().text());
     }
 
     return id;
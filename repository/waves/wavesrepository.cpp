@@ -0,0 +1,350 @@
+#include "wavesrepository.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+#include "dbmanager.h"
+
+namespace {
+
+// Effective start offset of a registration row `reg` joined to its wave `w`
+constexpr auto effectiveOffsetSql = "COALESCE(reg.startOffsetMs, w.startOffsetMs, 0)";
+
+Waves::Wave waveFromQuery(const QSqlQuery& query) {
+    return (Waves::Wave) {
+        .id = query.value(0).toInt(),
+        .trialId = query.value(1).toInt(),
+        .name = query.value(2).toString(),
+        .startOffsetMs = query.value(3).toInt(),
+        .started = !query.value(3).isNull()
+    };
+}
+
+};
+
+Waves::Repository::Repository(const QSqlDatabase& db) : m_db(db) {
+}
+
+tl::expected<Waves::Wave, QString> Waves::Repository::createWave(const int trialId, const QString& name) const {
+    if (name.trimmed().isEmpty()) {
+        return tl::unexpected("[WV] Invalid wave name");
+    }
+
+    const QString sql = R"(
+        INSERT INTO waves(trialId, name) VALUES(:trialId, :name)
+    )";
+
+    auto queryInsert = DBManager::statement(m_db, sql);
+    queryInsert->bindValue(":trialId", trialId);
+    queryInsert->bindValue(":name", name.trimmed());
+
+    if (!queryInsert->exec()) {
+        return tl::unexpected("[WV] Error inserting wave " + name + ": " + queryInsert->lastError().text());
+    }
+
+    return (Wave) {
+        .id = queryInsert->lastInsertId().toInt(),
+        .trialId = trialId,
+        .name = name.trimmed()
+    };
+}
+
+tl::expected<Waves::Wave, QString> Waves::Repository::getWaveById(const int id) const {
+    const QString sql = R"(
+        SELECT id, trialId, name, startOffsetMs FROM waves WHERE id = :id
+    )";
+
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":id", id);
+
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[WV] Error fetching wave " + QString::number(id) + ": " + querySelect->lastError().text());
+    }
+    return waveFromQuery(*querySelect);
+}
+
+tl::expected<Waves::Wave, QString> Waves::Repository::getWaveByName(const int trialId, const QString& name) const {
+    const QString sql = R"(
+        SELECT id, trialId, name, startOffsetMs FROM waves WHERE trialId = :trialId AND name = :name
+    )";
+
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":trialId", trialId);
+    querySelect->bindValue(":name", name.trimmed());
+
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[WV] Error fetching wave '" + name + "': " + querySelect->lastError().text());
+    }
+    return waveFromQuery(*querySelect);
+}
+
+tl::expected<QVector<Waves::Wave>, QString> Waves::Repository::getWavesByTrial(const int trialId) const {
+    const QString sql = R"(
+        SELECT id, trialId, name, startOffsetMs FROM waves WHERE trialId = :trialId ORDER BY id
+    )";
+
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":trialId", trialId);
+
+    if (!querySelect->exec()) {
+        return tl::unexpected("[WV] Error fetching waves of trial " + QString::number(trialId) + ": " + querySelect->lastError().text());
+    }
+
+    QVector<Wave> waves;
+    while (querySelect->next()) {
+        waves.append(waveFromQuery(*querySelect));
+    }
+    return waves;
+}
+
+tl::expected<int, QString> Waves::Repository::deleteWaveById(const int id) const {
+    QSqlDatabase db = m_db;
+    if (!db.transaction()) {
+        return tl::unexpected("[WV] Error starting transaction: " + db.lastError().text());
+    }
+
+    if (auto remembered = rememberOffsets("reg.waveId = :waveId", { { ":waveId", id } }); !remembered) {
+        db.rollback();
+        return tl::unexpected(remembered.error());
+    }
+
+    // Not left to ON DELETE SET NULL, which depends on the connection's foreign_keys pragma
+    auto queryDetach = DBManager::statement(db, "UPDATE registrations SET waveId = NULL WHERE waveId = :waveId");
+    queryDetach->bindValue(":waveId", id);
+    auto queryDelete = DBManager::statement(db, "DELETE FROM waves WHERE id = :id");
+    queryDelete->bindValue(":id", id);
+
+    if (!queryDetach->exec() || !queryDelete->exec()) {
+        const QString error = queryDetach->lastError().isValid() ? queryDetach->lastError().text() : queryDelete->lastError().text();
+        db.rollback();
+        return tl::unexpected("[WV] Error deleting wave " + QString::number(id) + ": " + error);
+    }
+    const int deleted = queryDelete->numRowsAffected();
+
+    if (auto shifted = shiftRecordedTimes(); !shifted) {
+        db.rollback();
+        return tl::unexpected(shifted.error());
+    }
+
+    if (!db.commit()) {
+        const QString error = db.lastError().text();
+        db.rollback();
+        return tl::unexpected("[WV] Error committing wave removal: " + error);
+    }
+    return deleted;
+}
+
+tl::expected<int, QString> Waves::Repository::startWave(const int waveId, const int startOffsetMs) const {
+    if (startOffsetMs < 0) {
+        return tl::unexpected("[WV] A wave cannot start before the trial");
+    }
+
+    QSqlDatabase db = m_db;
+    if (!db.transaction()) {
+        return tl::unexpected("[WV] Error starting transaction: " + db.lastError().text());
+    }
+
+    // Registrations with an individual start are not affected by their wave's
+    if (auto remembered = rememberOffsets("reg.waveId = :waveId AND reg.startOffsetMs IS NULL", { { ":waveId", waveId } }); !remembered) {
+        db.rollback();
+        return tl::unexpected(remembered.error());
+    }
+
+    auto queryUpdate = DBManager::statement(db, "UPDATE waves SET startOffsetMs = :startOffsetMs WHERE id = :id");
+    queryUpdate->bindValue(":startOffsetMs", startOffsetMs);
+    queryUpdate->bindValue(":id", waveId);
+
+    if (!queryUpdate->exec()) {
+        const QString error = queryUpdate->lastError().text();
+        db.rollback();
+        return tl::unexpected("[WV] Error starting wave " + QString::number(waveId) + ": " + error);
+    }
+    if (queryUpdate->numRowsAffected() == 0) {
+        db.rollback();
+        return tl::unexpected("[WV] Wave " + QString::number(waveId) + " not found");
+    }
+
+    auto shifted = shiftRecordedTimes();
+    if (!shifted) {
+        db.rollback();
+        return shifted;
+    }
+
+    if (!db.commit()) {
+        const QString error = db.lastError().text();
+        db.rollback();
+        return tl::unexpected("[WV] Error committing wave start: " + error);
+    }
+    return shifted;
+}
+
+tl::expected<int, QString> Waves::Repository::assignRegistrations(const int waveId, const QVector<int>& registrationIds) const {
+    if (registrationIds.isEmpty()) {
+        return 0;
+    }
+
+    QSqlDatabase db = m_db;
+    if (!db.transaction()) {
+        return tl::unexpected("[WV] Error starting transaction: " + db.lastError().text());
+    }
+
+    auto queryAssign = DBManager::statement(db, "UPDATE registrations SET waveId = :waveId WHERE id = :id");
+
+    for (const int registrationId : registrationIds) {
+        if (auto remembered = rememberOffsets("reg.id = :registrationId", { { ":registrationId", registrationId } }); !remembered) {
+            db.rollback();
+            return tl::unexpected(remembered.error());
+        }
+
+        queryAssign->bindValue(":waveId", waveId > 0 ? QVariant(waveId) : QVariant());
+        queryAssign->bindValue(":id", registrationId);
+        if (!queryAssign->exec()) {
+            const QString error = queryAssign->lastError().text();
+            db.rollback();
+            return tl::unexpected("[WV] Error assigning registration " + QString::number(registrationId) + ": " + error);
+        }
+    }
+
+    auto shifted = shiftRecordedTimes();
+    if (!shifted) {
+        db.rollback();
+        return shifted;
+    }
+
+    if (!db.commit()) {
+        const QString error = db.lastError().text();
+        db.rollback();
+        return tl::unexpected("[WV] Error committing wave assignment: " + error);
+    }
+    return shifted;
+}
+
+tl::expected<int, QString> Waves::Repository::setRegistrationStartOffset(const int registrationId, const std::optional<int> startOffsetMs) const {
+    if (startOffsetMs && *startOffsetMs < 0) {
+        return tl::unexpected("[WV] An athlete cannot start before the trial");
+    }
+
+    QSqlDatabase db = m_db;
+    if (!db.transaction()) {
+        return tl::unexpected("[WV] Error starting transaction: " + db.lastError().text());
+    }
+
+    if (auto remembered = rememberOffsets("reg.id = :registrationId", { { ":registrationId", registrationId } }); !remembered) {
+        db.rollback();
+        return tl::unexpected(remembered.error());
+    }
+
+    auto queryUpdate = DBManager::statement(db, "UPDATE registrations SET startOffsetMs = :startOffsetMs WHERE id = :id");
+    queryUpdate->bindValue(":startOffsetMs", startOffsetMs ? QVariant(*startOffsetMs) : QVariant());
+    queryUpdate->bindValue(":id", registrationId);
+
+    if (!queryUpdate->exec()) {
+        const QString error = queryUpdate->lastError().text();
+        db.rollback();
+        return tl::unexpected("[WV] Error setting start of registration " + QString::number(registrationId) + ": " + error);
+    }
+    if (queryUpdate->numRowsAffected() == 0) {
+        db.rollback();
+        return tl::unexpected("[WV] Registration " + QString::number(registrationId) + " not found");
+    }
+
+    auto shifted = shiftRecordedTimes();
+    if (!shifted) {
+        db.rollback();
+        return shifted;
+    }
+
+    if (!db.commit()) {
+        const QString error = db.lastError().text();
+        db.rollback();
+        return tl::unexpected("[WV] Error committing individual start: " + error);
+    }
+    return shifted;
+}
+
+tl::expected<int, QString> Waves::Repository::getStartOffsetMs(const int registrationId) const {
+    const QString sql = QString(R"(
+        SELECT %1
+        FROM registrations reg
+        LEFT JOIN waves w ON w.id = reg.waveId
+        WHERE reg.id = :registrationId
+    )").arg(effectiveOffsetSql);
+
+    auto querySelect = DBManager::statement(m_db, sql);
+    querySelect->bindValue(":registrationId", registrationId);
+
+    if (!querySelect->exec() || !querySelect->next()) {
+        return tl::unexpected("[WV] Error fetching start of registration " + QString::number(registrationId) + ": " + querySelect->lastError().text());
+    }
+    return querySelect->value(0).toInt();
+}
+
+tl::expected<void, QString> Waves::Repository::rememberOffsets(const QString& condition, const QVariantHash& values) const {
+    // Connection-local scratch table; rows only live until shiftRecordedTimes() in the same transaction
+    QSqlQuery queryCreate(m_db);
+    if (!queryCreate.exec("CREATE TEMP TABLE IF NOT EXISTS start_changes (registrationId INTEGER PRIMARY KEY, previousOffsetMs INTEGER NOT NULL)")) {
+        return tl::unexpected("[WV] Error creating start change table: " + queryCreate.lastError().text());
+    }
+
+    const QString sql = QString(R"(
+        INSERT OR IGNORE INTO start_changes(registrationId, previousOffsetMs)
+        SELECT reg.id, %1
+        FROM registrations reg
+        LEFT JOIN waves w ON w.id = reg.waveId
+        WHERE %2
+    )").arg(effectiveOffsetSql, condition);
+
+    auto queryInsert = DBManager::statement(m_db, sql);
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        queryInsert->bindValue(it.key(), it.value());
+    }
+
+    if (!queryInsert->exec()) {
+        return tl::unexpected("[WV] Error reading start offsets: " + queryInsert->lastError().text());
+    }
+    return {};
+}
+
+tl::expected<int, QString> Waves::Repository::shiftRecordedTimes() const {
+    // Stored net time = gun time - offset, so a new offset moves it by the difference
+    const QString deltas = QString(R"(
+        SELECT sc.registrationId, %1 - sc.previousOffsetMs AS deltaMs
+        FROM start_changes sc
+        JOIN registrations reg ON reg.id = sc.registrationId
+        LEFT JOIN waves w ON w.id = reg.waveId
+    )").arg(effectiveOffsetSql);
+
+    const QString resultsSql = QString(R"(
+        UPDATE results
+        SET durationMs = results.durationMs - d.deltaMs, startTime = results.startTime + d.deltaMs
+        FROM (%1) d
+        WHERE results.registrationId = d.registrationId AND d.deltaMs <> 0
+    )").arg(deltas);
+
+    const QString crossingsSql = QString(R"(
+        UPDATE crossings
+        SET elapsedMs = crossings.elapsedMs - d.deltaMs
+        FROM (%1) d
+        WHERE crossings.registrationId = d.registrationId AND d.deltaMs <> 0
+    )").arg(deltas);
+
+    auto queryResults = DBManager::statement(m_db, resultsSql);
+    if (!queryResults->exec()) {
+        return tl::unexpected("[WV] Error shifting results: " + queryResults->lastError().text());
+    }
+    const int shifted = queryResults->numRowsAffected();
+
+    auto queryCrossings = DBManager::statement(m_db, crossingsSql);
+    if (!queryCrossings->exec()) {
+        return tl::unexpected("[WV] Error shifting crossings: " + queryCrossings->lastError().text());
+    }
+
+    QSqlQuery queryClear(m_db);
+    if (!queryClear.exec("DELETE FROM start_changes")) {
+        return tl::unexpected("[WV] Error clearing start changes: " + queryClear.lastError().text());
+    }
+
+    if (shifted > 0) {
+        qDebug() << "[WV] Shifted" << shifted << "recorded result(s) to the new start offsets";
+    }
+    return shifted;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "wave.h"
+#include <QSqlDatabase>
+#include <QString>
+#include <QVariantHash>
+#include <QVector>
+#include <optional>
+#include <tl/expected.hpp>
+
+namespace Waves {
+
+// Waves and individual start offsets. Finishes are stored as net times, so every change
+// to a registration's effective offset also shifts the results and crossings it already
+// has, in the same transaction.
+class Repository
+{
+public:
+    explicit Repository(const QSqlDatabase& db);
+
+    [[nodiscard]] tl::expected<Wave, QString> createWave(int trialId, const QString& name) const;
+    [[nodiscard]] tl::expected<Wave, QString> getWaveById(int id) const;
+    [[nodiscard]] tl::expected<Wave, QString> getWaveByName(int trialId, const QString& name) const;
+    [[nodiscard]] tl::expected<QVector<Wave>, QString> getWavesByTrial(int trialId) const;
+    // Registrations of the wave revert to the trial start
+    [[nodiscard]] tl::expected<int, QString> deleteWaveById(int id) const;
+
+    // Records (or corrects) the wave's start; returns the number of results shifted
+    [[nodiscard]] tl::expected<int, QString> startWave(int waveId, int startOffsetMs) const;
+    // Returns the number of results shifted
+    [[nodiscard]] tl::expected<int, QString> assignRegistrations(int waveId, const QVector<int>& registrationIds) const;
+    // Individual start; std::nullopt falls back to the wave. Returns the number of results shifted
+    [[nodiscard]] tl::expected<int, QString> setRegistrationStartOffset(int registrationId, std::optional<int> startOffsetMs) const;
+
+    // Own offset, else the wave's, else 0
+    [[nodiscard]] tl::expected<int, QString> getStartOffsetMs(int registrationId) const;
+
+private:
+    QSqlDatabase m_db;
+
+    [[nodiscard]] tl::expected<void, QString> rememberOffsets(const QString& condition, const QVariantHash& values) const;
+    [[nodiscard]] tl::expected<int, QString> shiftRecordedTimes() const;
+};
+
+};
@@ -0,0 +1,20 @@
+QT       += core network
+QT       -= gui
+
+CONFIG += c++20 console
+CONFIG -= app_bundle
+
+TARGET = ingestsim
+
+INCLUDEPATH += \
+    $$PWD/../.. \
+    $$PWD/../../third_party/expected/include
+
+SOURCES += \
+    main.cpp \
+    ../../ingest/stationevent.cpp \
+    ../../utils/timeutils.cpp
+
+HEADERS += \
+    ../../ingest/stationevent.h \
+    ../../utils/timeutils.h
@@ -0,0 +1,238 @@
+// Load generator for the station ingest endpoint.
+// Replays finish (and optionally split) events from many simulated capture stations over a
+// few local connections, resends a share of them to exercise idempotency, and reports
+// throughput, ack latency and the rejection reasons.
+
+#include "ingest/stationevent.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QLocalSocket>
+#include <QPair>
+#include <QRandomGenerator>
+#include <QTimer>
+#include <QVector>
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <memory>
+
+namespace {
+
+struct Options {
+    QString serverName;
+    int stations = 0;
+    int eventsPerStation = 0;
+    int connections = 0;
+    int firstPlate = 0;
+    int lastPlate = 0;
+    int batchSize = 0;
+    int intervalMs = 0;
+    double duplicateRatio = 0;
+    double splitRatio = 0;
+    qint64 startEpochMs = 0;
+};
+
+struct Batch {
+    QByteArray payload;
+    int lines = 0;
+};
+
+// One socket carrying the events of several stations
+struct Connection {
+    QLocalSocket socket;
+    QVector<Batch> batches;
+    qsizetype nextBatch = 0;
+    int pendingAcks = 0;
+    QElapsedTimer batchTimer;
+    QVector<qint64> latenciesUs;
+};
+
+struct Totals {
+    qint64 sent = 0;
+    qint64 ok = 0;
+    qint64 rejected = 0;
+    QHash<QString, qint64> reasons;
+    int finishedConnections = 0;
+};
+
+QVector<QVector<Ingest::StationEvent>> generateEvents(const Options& options) {
+    QRandomGenerator random(42);
+    QVector<QVector<Ingest::StationEvent>> perStation(options.stations);
+
+    const int plateCount = options.lastPlate - options.firstPlate + 1;
+    for (int s = 0; s < options.stations; ++s) {
+        const QString stationId = QString("st%1").arg(s + 1, 4, 10, QChar('0'));
+        qint64 capturedAt = options.startEpochMs;
+
+        auto& events = perStation[s];
+        events.reserve(options.eventsPerStation);
+        for (int e = 0; e < options.eventsPerStation; ++e) {
+            capturedAt += random.bounded(1, 2000);
+            const bool split = random.generateDouble() < options.splitRatio;
+            events.append({
+                .eventId = QString("%1-%2").arg(stationId).arg(e + 1, 7, 10, QChar('0')),
+                .stationId = stationId,
+                .type = split ? Ingest::StationEvent::Split : Ingest::StationEvent::Finish,
+                .plateCode = QString::number(options.firstPlate + random.bounded(plateCount)),
+                .checkpoint = split ? QString("CP%1").arg(1 + random.bounded(3)) : QString(),
+                .capturedAt = QDateTime::fromMSecsSinceEpoch(capturedAt)
+            });
+
+            // Resends reuse the event id; the server must store them once
+            if (random.generateDouble() < options.duplicateRatio) {
+                events.append(events.last());
+            }
+        }
+    }
+    return perStation;
+}
+
+void sendNextBatch(Connection& connection, Totals& totals) {
+    if (connection.nextBatch >= connection.batches.size()) {
+        connection.socket.disconnectFromServer();
+        return;
+    }
+
+    const Batch& batch = connection.batches[connection.nextBatch++];
+    connection.pendingAcks = batch.lines;
+    connection.batchTimer.start();
+    connection.socket.write(batch.payload);
+    totals.sent += batch.lines;
+}
+
+void printSummary(const Totals& totals, const QVector<std::shared_ptr<Connection>>& connections, const qint64 elapsedMs) {
+    QVector<qint64> latencies;
+    for (const auto& connection : connections) {
+        latencies += connection->latenciesUs;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](const double p) {
+        return latencies.isEmpty() ? 0.0 : static_cast<double>(latencies[static_cast<qsizetype>(p * static_cast<double>(latencies.size() - 1))]) / 1000.0;
+    };
+
+    std::printf("events sent:   %lld\n", static_cast<long long>(totals.sent));
+    std::printf("accepted:      %lld\n", static_cast<long long>(totals.ok));
+    std::printf("rejected:      %lld\n", static_cast<long long>(totals.rejected));
+    std::printf("elapsed:       %.3f s\n", static_cast<double>(elapsedMs) / 1000.0);
+    std::printf("throughput:    %.0f events/s\n", elapsedMs > 0 ? static_cast<double>(totals.sent) * 1000.0 / static_cast<double>(elapsedMs) : 0.0);
+    std::printf("batch ack:     p50 %.2f ms | p95 %.2f ms | p99 %.2f ms\n", percentile(0.50), percentile(0.95), percentile(0.99));
+
+    QVector<QPair<qint64, QString>> reasons;
+    for (auto it = totals.reasons.constBegin(); it != totals.reasons.constEnd(); ++it) {
+        reasons.append({ it.value(), it.key() });
+    }
+    std::sort(reasons.begin(), reasons.end(), std::greater<>());
+    for (qsizetype i = 0; i < std::min<qsizetype>(reasons.size(), 5); ++i) {
+        std::printf("  %8lld x %s\n", static_cast<long long>(reasons[i].first), qPrintable(reasons[i].second));
+    }
+}
+
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replays capture station events against the chronometer ingest endpoint.");
+    parser.addHelpOption();
+    const QCommandLineOption serverOption("server", "Local server name.", "name", "crono-ingest");
+    const QCommandLineOption stationsOption("stations", "Simulated stations.", "count", "100");
+    const QCommandLineOption eventsOption("events", "Events per station.", "count", "100");
+    const QCommandLineOption connectionsOption("connections", "Sockets shared by the stations.", "count", "16");
+    const QCommandLineOption platesOption("plates", "Plate range, e.g. 1-500.", "range", "1-500");
+    const QCommandLineOption batchOption("batch", "Lines per write.", "count", "50");
+    const QCommandLineOption intervalOption("interval-ms", "Pause between batches of a connection.", "ms", "0");
+    const QCommandLineOption duplicatesOption("duplicates", "Share of events sent twice.", "ratio", "0.05");
+    const QCommandLineOption splitsOption("splits", "Share of intermediate split events.", "ratio", "0");
+    const QCommandLineOption startOption("start", "Capture time of the first event (epoch ms); default now.", "ms");
+    parser.addOptions({ serverOption, stationsOption, eventsOption, connectionsOption, platesOption, batchOption,
+                        intervalOption, duplicatesOption, splitsOption, startOption });
+    parser.process(app);
+
+    const QStringList plateRange = parser.value(platesOption).split('-');
+    Options options {
+        .serverName = parser.value(serverOption),
+        .stations = std::max(1, parser.value(stationsOption).toInt()),
+        .eventsPerStation = std::max(1, parser.value(eventsOption).toInt()),
+        .connections = std::max(1, parser.value(connectionsOption).toInt()),
+        .firstPlate = plateRange.value(0).toInt(),
+        .lastPlate = plateRange.value(1, plateRange.value(0)).toInt(),
+        .batchSize = std::max(1, parser.value(batchOption).toInt()),
+        .intervalMs = std::max(0, parser.value(intervalOption).toInt()),
+        .duplicateRatio = parser.value(duplicatesOption).toDouble(),
+        .splitRatio = parser.value(splitsOption).toDouble(),
+        .startEpochMs = parser.isSet(startOption) ? parser.value(startOption).toLongLong() : QDateTime::currentMSecsSinceEpoch()
+    };
+    if (options.lastPlate < options.firstPlate) {
+        std::fprintf(stderr, "invalid plate range\n");
+        return 1;
+    }
+    options.connections = std::min(options.connections, options.stations);
+
+    // Events are encoded up front so the measurement only covers the transfer and the ingest
+    const auto perStation = generateEvents(options);
+    QVector<std::shared_ptr<Connection>> connections;
+    for (int c = 0; c < options.connections; ++c) {
+        connections.append(std::make_shared<Connection>());
+    }
+    for (int s = 0; s < options.stations; ++s) {
+        auto& batches = connections[s % options.connections]->batches;
+        for (const auto& event : perStation[s]) {
+            if (batches.isEmpty() || batches.last().lines >= options.batchSize) {
+                batches.append({});
+            }
+            batches.last().payload += Ingest::encodeEvent(event);
+            ++batches.last().lines;
+        }
+    }
+
+    Totals totals;
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    for (const auto& connection : connections) {
+        Connection* raw = connection.get();
+
+        QObject::connect(&raw->socket, &QLocalSocket::connected, [raw, &totals]() { sendNextBatch(*raw, totals); });
+
+        QObject::connect(&raw->socket, &QLocalSocket::readyRead, [raw, &totals, &options]() {
+            while (raw->socket.canReadLine()) {
+                auto ack = Ingest::parseAck(raw->socket.readLine());
+                if (ack && ack->ok) {
+                    ++totals.ok;
+                } else {
+                    ++totals.rejected;
+                    ++totals.reasons[ack ? ack->error : ack.error()];
+                }
+
+                if (--raw->pendingAcks == 0) {
+                    raw->latenciesUs.append(raw->batchTimer.nsecsElapsed() / 1000);
+                    if (options.intervalMs > 0) {
+                        QTimer::singleShot(options.intervalMs, [raw, &totals]() { sendNextBatch(*raw, totals); });
+                    } else {
+                        sendNextBatch(*raw, totals);
+                    }
+                }
+            }
+        });
+
+        QObject::connect(&raw->socket, &QLocalSocket::disconnected, [&totals, &options, &connections, &elapsed]() {
+            if (++totals.finishedConnections == options.connections) {
+                printSummary(totals, connections, elapsed.elapsed());
+                QCoreApplication::quit();
+            }
+        });
+
+        QObject::connect(&raw->socket, &QLocalSocket::errorOccurred, [raw, &options](QLocalSocket::LocalSocketError) {
+            std::fprintf(stderr, "%s: %s\n", qPrintable(options.serverName), qPrintable(raw->socket.errorString()));
+            QCoreApplication::exit(2);
+        });
+
+        raw->socket.connectToServer(options.serverName);
+    }
+
+    return app.exec();
+}
@@ -0,0 +1,219 @@
+#include "durationstats.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DURATIONSTATS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// 1-based nearest rank of percentile p among count values, as a 0-based index
+qsizetype nearestRankIndex(const double p, const qsizetype count) {
+    const auto rank = static_cast<qsizetype>(std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(count)));
+    return std::clamp<qsizetype>(rank, 1, count) - 1;
+}
+
+template <typename T>
+Utils::DurationStatistics computeStatistics(const T* values, const qsizetype count, const QVector<double>& percentiles, const int bucketCount) {
+    Utils::DurationStatistics stats;
+    stats.percentiles = percentiles;
+    stats.count = count;
+    if (count <= 0) {
+        stats.percentileValues.fill(0, percentiles.size());
+        return stats;
+    }
+
+    const auto extent = Utils::DurationStats::extent(values, count);
+    stats.min = extent.min;
+    stats.max = extent.max;
+    stats.mean = static_cast<double>(extent.sum) / static_cast<double>(count);
+    // Second pass around the mean; a single sum-of-squares pass loses precision on long races
+    stats.stddev = std::sqrt(Utils::DurationStats::sumSquaredDeviations(values, count, stats.mean) / static_cast<double>(count));
+
+    // Percentiles: select the requested ranks in increasing order, each nth_element working
+    // only on the part of the copy past the previously placed rank
+    QVector<T> ordered(values, values + count);
+    QVector<qsizetype> targets;
+    targets.reserve(percentiles.size() + 1);
+    targets.append(nearestRankIndex(50.0, count));
+    for (const double p : percentiles) {
+        targets.append(nearestRankIndex(p, count));
+    }
+    QVector<qsizetype> selection = targets;
+    std::sort(selection.begin(), selection.end());
+    selection.erase(std::unique(selection.begin(), selection.end()), selection.end());
+
+    auto first = ordered.begin();
+    for (const qsizetype index : selection) {
+        std::nth_element(first, ordered.begin() + index, ordered.end());
+        first = ordered.begin() + index + 1;
+    }
+
+    stats.median = ordered[targets.first()];
+    stats.percentileValues.reserve(percentiles.size());
+    for (qsizetype i = 1; i < targets.size(); ++i) {
+        stats.percentileValues.append(ordered[targets[i]]);
+    }
+
+    // Histogram over [min, max]; never more buckets than distinct possible values
+    const qint64 range = stats.max - stats.min + 1;
+    const qint64 buckets = std::clamp<qint64>(bucketCount, 1, range);
+    stats.histogramStart = stats.min;
+    stats.bucketWidth = (range + buckets - 1) / buckets;
+    stats.histogram.fill(0, static_cast<qsizetype>(buckets));
+
+    // Multiplying by the reciprocal avoids a division per value; the result is at most one bucket off
+    const double inverse = 1.0 / static_cast<double>(stats.bucketWidth);
+    int* histogram = stats.histogram.data();
+    for (qsizetype i = 0; i < count; ++i) {
+        const qint64 offset = static_cast<qint64>(values[i]) - stats.histogramStart;
+        auto bucket = static_cast<qint64>(static_cast<double>(offset) * inverse);
+        if (bucket * stats.bucketWidth > offset) {
+            --bucket;
+        } else if ((bucket + 1) * stats.bucketWidth <= offset) {
+            ++bucket;
+        }
+        ++histogram[bucket];
+    }
+
+    return stats;
+}
+
+};
+
+Utils::DurationStatistics Utils::DurationStats::compute(const int* values, const qsizetype count, const QVector<double>& percentiles, const int bucketCount) {
+    return computeStatistics(values, count, percentiles, bucketCount);
+}
+
+Utils::DurationStatistics Utils::DurationStats::compute(const qint64* values, const qsizetype count, const QVector<double>& percentiles, const int bucketCount) {
+    return computeStatistics(values, count, percentiles, bucketCount);
+}
+
+Utils::DurationStats::Extent Utils::DurationStats::extent(const int* values, const qsizetype count) {
+    qsizetype i = 0;
+    int min = std::numeric_limits<int>::max();
+    int max = std::numeric_limits<int>::min();
+    qint64 sum = 0;
+
+#ifdef DURATIONSTATS_SSE2
+    if (count >= 4) {
+        // SSE2 has no 32-bit min/max, so compare and select; sums are widened to 64-bit lanes
+        __m128i vmin = _mm_set1_epi32(min);
+        __m128i vmax = _mm_set1_epi32(max);
+        __m128i vsum = _mm_setzero_si128();
+
+        for (; i + 4 <= count; i += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+
+            const __m128i lower = _mm_cmplt_epi32(v, vmin);
+            vmin = _mm_or_si128(_mm_and_si128(lower, v), _mm_andnot_si128(lower, vmin));
+            const __m128i greater = _mm_cmpgt_epi32(v, vmax);
+            vmax = _mm_or_si128(_mm_and_si128(greater, v), _mm_andnot_si128(greater, vmax));
+
+            const __m128i sign = _mm_srai_epi32(v, 31);
+            vsum = _mm_add_epi64(vsum, _mm_unpacklo_epi32(v, sign));
+            vsum = _mm_add_epi64(vsum, _mm_unpackhi_epi32(v, sign));
+        }
+
+        alignas(16) int mins[4];
+        alignas(16) int maxs[4];
+        alignas(16) qint64 sums[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(mins), vmin);
+        _mm_store_si128(reinterpret_cast<__m128i*>(maxs), vmax);
+        _mm_store_si128(reinterpret_cast<__m128i*>(sums), vsum);
+
+        min = std::min({ mins[0], mins[1], mins[2], mins[3] });
+        max = std::max({ maxs[0], maxs[1], maxs[2], maxs[3] });
+        sum = sums[0] + sums[1];
+    }
+#endif
+
+    for (; i < count; ++i) {
+        min = std::min(min, values[i]);
+        max = std::max(max, values[i]);
+        sum += values[i];
+    }
+
+    return { .min = min, .max = max, .sum = sum };
+}
+
+Utils::DurationStats::Extent Utils::DurationStats::extent(const qint64* values, const qsizetype count) {
+    // 64-bit compares need SSE4.2; four independent accumulators keep the scalar loop pipelined
+    qint64 mins[4] = { values[0], values[0], values[0], values[0] };
+    qint64 maxs[4] = { values[0], values[0], values[0], values[0] };
+    qint64 sums[4] = { 0, 0, 0, 0 };
+
+    qsizetype i = 0;
+    for (; i + 4 <= count; i += 4) {
+        for (int lane = 0; lane < 4; ++lane) {
+            mins[lane] = std::min(mins[lane], values[i + lane]);
+            maxs[lane] = std::max(maxs[lane], values[i + lane]);
+            sums[lane] += values[i + lane];
+        }
+    }
+    for (; i < count; ++i) {
+        mins[0] = std::min(mins[0], values[i]);
+        maxs[0] = std::max(maxs[0], values[i]);
+        sums[0] += values[i];
+    }
+
+    return {
+        .min = std::min({ mins[0], mins[1], mins[2], mins[3] }),
+        .max = std::max({ maxs[0], maxs[1], maxs[2], maxs[3] }),
+        .sum = sums[0] + sums[1] + sums[2] + sums[3]
+    };
+}
+
+double Utils::DurationStats::sumSquaredDeviations(const int* values, const qsizetype count, const double mean) {
+    qsizetype i = 0;
+    double total = 0.0;
+
+#ifdef DURATIONSTATS_SSE2
+    const __m128d vmean = _mm_set1_pd(mean);
+    __m128d low = _mm_setzero_pd();
+    __m128d high = _mm_setzero_pd();
+
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        const __m128d d0 = _mm_sub_pd(_mm_cvtepi32_pd(v), vmean);
+        const __m128d d1 = _mm_sub_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2))), vmean);
+        low = _mm_add_pd(low, _mm_mul_pd(d0, d0));
+        high = _mm_add_pd(high, _mm_mul_pd(d1, d1));
+    }
+
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, _mm_add_pd(low, high));
+    total = lanes[0] + lanes[1];
+#endif
+
+    for (; i < count; ++i) {
+        const double deviation = static_cast<double>(values[i]) - mean;
+        total += deviation * deviation;
+    }
+    return total;
+}
+
+double Utils::DurationStats::sumSquaredDeviations(const qint64* values, const qsizetype count, const double mean) {
+    double lanes[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+    qsizetype i = 0;
+    for (; i + 4 <= count; i += 4) {
+        for (int lane = 0; lane < 4; ++lane) {
+            const double deviation = static_cast<double>(values[i + lane]) - mean;
+            lanes[lane] += deviation * deviation;
+        }
+    }
+    for (; i < count; ++i) {
+        const double deviation = static_cast<double>(values[i]) - mean;
+        lanes[0] += deviation * deviation;
+    }
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+const QVector<double>& Utils::DurationStats::defaultPercentiles() {
+    static const QVector<double> percentiles { 10.0, 25.0, 75.0, 90.0, 95.0 };
+    return percentiles;
+}
@@ -0,0 +1,70 @@
+#ifndef DURATIONSTATS_H
+#define DURATIONSTATS_H
+
+#include <QVector>
+#include <QtGlobal>
+
+namespace Utils {
+
+// Summary of a set of durations. Values are in the unit of the input (ms for results, ns for elapsedNs).
+struct DurationStatistics {
+    qsizetype count = 0;
+    qint64 min = 0;
+    qint64 max = 0;
+    double mean = 0.0;
+    double stddev = 0.0;            // population standard deviation
+    qint64 median = 0;
+
+    QVector<double> percentiles;    // requested ranks, 0-100
+    QVector<qint64> percentileValues;
+
+    // histogram[i] counts values in [histogramStart + i * bucketWidth, histogramStart + (i + 1) * bucketWidth)
+    qint64 histogramStart = 0;
+    qint64 bucketWidth = 0;
+    QVector<int> histogram;
+};
+
+// Statistics kernel over contiguous duration arrays.
+// Min/max/sum and the squared deviations run four lanes at a time with SSE2 on x86
+// (baseline on x86-64) and fall back to a scalar loop elsewhere; percentiles use
+// nearest-rank selection on a copy, so the input is never reordered.
+class DurationStats
+{
+public:
+    static constexpr int defaultBucketCount = 20;
+
+    struct Extent {
+        qint64 min = 0;
+        qint64 max = 0;
+        qint64 sum = 0;
+    };
+
+    [[nodiscard]] static DurationStatistics compute(const int* values, qsizetype count,
+                                                    const QVector<double>& percentiles = defaultPercentiles(),
+                                                    int bucketCount = defaultBucketCount);
+    [[nodiscard]] static DurationStatistics compute(const qint64* values, qsizetype count,
+                                                    const QVector<double>& percentiles = defaultPercentiles(),
+                                                    int bucketCount = defaultBucketCount);
+    [[nodiscard]] static DurationStatistics compute(const QVector<int>& values,
+                                                    const QVector<double>& percentiles = defaultPercentiles(),
+                                                    int bucketCount = defaultBucketCount) {
+        return compute(values.constData(), values.size(), percentiles, bucketCount);
+    }
+    [[nodiscard]] static DurationStatistics compute(const QVector<qint64>& values,
+                                                    const QVector<double>& percentiles = defaultPercentiles(),
+                                                    int bucketCount = defaultBucketCount) {
+        return compute(values.constData(), values.size(), percentiles, bucketCount);
+    }
+
+    // Building blocks; count must be > 0
+    [[nodiscard]] static Extent extent(const int* values, qsizetype count);
+    [[nodiscard]] static Extent extent(const qint64* values, qsizetype count);
+    [[nodiscard]] static double sumSquaredDeviations(const int* values, qsizetype count, double mean);
+    [[nodiscard]] static double sumSquaredDeviations(const qint64* values, qsizetype count, double mean);
+
+    [[nodiscard]] static const QVector<double>& defaultPercentiles();
+};
+
+};
+
+#endif // DURATIONSTATS_H
@@ -2,10 +2,10 @@
 #include <QDebug>
 #include <QFileInfo>
 #include <cmath>
-#include "xlsxdocument.h"
-#include "xlsxworksheet.h"
+#include <algorithm>
+#include "xlsxstreamreader.h"
 
-tl::expected<QVector<QVector<QVariant>>, QString> Utils::ExcelUtils::readExcelFile(const QString& filePath)
+tl::expected<int, QString> Utils::ExcelUtils::forEachRow(const QString& filePath, const RowCallback& onRow)
 {
     try {
         const QFileInfo fileInfo(filePath);
@@ -13,78 +13,82 @@ tl::expected<QVector<QVector<QVariant>>, QString> Utils::ExcelUtils::readExcelFi
             return tl::unexpected("File not found: " + filePath);
         }
         
-        if (!fileInfo.suffix().toLower().contains("xls")) {
-            return tl::unexpected("Unsupported file format. Please use .xlsx or .xls files");
+        if (!QStringList{ "xlsx", "xlsm" }.contains(fileInfo.suffix().toLower())) {
+            return tl::unexpected(QString("Unsupported file format. Please use .xlsx files"));
         }
 
-        const QXlsx::Document xlsx(filePath);
-        if (!xlsx.load()) {
-            return tl::unexpected("Error opening Excel file: " + filePath);
-        }
+        int delivered = 0;
+        QStringList rowData;
 
-        const QXlsx::Worksheet* worksheet = xlsx.currentWorksheet();
-        if (!worksheet) {
-            return tl::unexpected("No worksheet found in Excel file");
-        }
-        
-        QVector<QVector<QVariant>> result;
-        
-        // Get the range of cells with data
-        const auto dimension = worksheet->dimension();
-        if (!dimension.isValid()) {
-            return tl::unexpected("Worksheet is empty or contains invalid data");
-        }
-        
-        // Read all rows with data
-        for (int row = dimension.firstRow(); row <= dimension.lastRow(); ++row) {
-            QVector<QVariant> rowData;
+        auto streamed = XlsxStreamReader::forEachRow(filePath, [&](const int rowNumber, const QVector<QVariant>& cells) {
+            rowData.clear();
+            rowData.reserve(cells.size());
             bool hasData = false;
-            
-            for (int col = dimension.firstColumn(); col <= dimension.lastColumn(); ++col) {
-                QVariant cellValue = worksheet->read(row, col);
-                
-                // Debug: Log raw cell value and type for plate code column (column 1, index 0)
-                if (col == 1 && row <= 5) { // Log first few rows of plate code column
-                    qDebug() << QString("Row %1, Col %2 - Type: %3, Raw: '%4'")
-                               .arg(row).arg(col).arg(cellValue.metaType().name(), cellValue.toString());
-                }
-                
-                // Convert to string and trim
+
+            for (const auto& cell : cells) {
                 QString stringValue;
-                if (parseExcelCell(cellValue, stringValue)) {
+                if (parseExcelCell(cell, stringValue)) {
                     hasData = true;
                 }
-                
-                // Debug: Log processed value for plate code column
-                if (col == 1 && row <= 5) {
-                    qDebug() << QString("Row %1, Col %2 - Processed: '%3'")
-                               .arg(row).arg(col).arg(stringValue);
-                }
-                
-                rowData.append(QVariant(stringValue));
+                rowData.append(stringValue);
             }
-            
-            // Only add rows that have some data
-            if (hasData) {
-                result.append(rowData);
+
+            // Only rows that have some data are delivered
+            if (!hasData) {
+                return true;
             }
+
+            delivered++;
+            return onRow(rowNumber, rowData);
+        });
+
+        if (!streamed.has_value()) {
+            return tl::unexpected(streamed.error());
         }
-        
-        if (result.isEmpty()) {
-            return tl::unexpected("No data found in the worksheet");
-        }
-        
-        qDebug() << QString("Excel file loaded successfully: %1 rows, %2 columns")
-                   .arg(result.size())
-                   .arg(result.first().size());
-        
-        return result;
-        
+
+        return delivered;
+
     } catch (const std::exception& e) {
         return tl::unexpected(QString("Error processing Excel file: %1").arg(e.what()));
     } catch (...) {
-        return tl::unexpected("Unknown error processing Excel file");
+        return tl::unexpected(QString("Unknown error processing Excel file"));
+    }
+}
+
+tl::expected<QVector<QVector<QVariant>>, QString> Utils::ExcelUtils::readExcelFile(const QString& filePath)
+{
+    QVector<QVector<QVariant>> result;
+    qsizetype columnCount = 0;
+
+    auto read = forEachRow(filePath, [&](int, const QStringList& cells) {
+        QVector<QVariant> rowData;
+        rowData.reserve(cells.size());
+        for (const auto& cell : cells) {
+            rowData.append(QVariant(cell));
+        }
+        columnCount = std::max(columnCount, rowData.size());
+        result.append(std::move(rowData));
+        return true;
+    });
+
+    if (!read.has_value()) {
+        return tl::unexpected(read.error());
+    }
+
+    if (result.isEmpty()) {
+        return tl::unexpected(QString("No data found in the worksheet"));
     }
+
+    // Keep the previous rectangular shape: every row has the same number of columns
+    for (auto& row : result) {
+        row.resize(columnCount, QVariant(QString()));
+    }
+
+    qDebug() << QString("Excel file loaded successfully: %1 rows, %2 columns")
+               .arg(result.size())
+               .arg(columnCount);
+
+    return result;
 }
 
 bool Utils::ExcelUtils::parseExcelCell(const QVariant& cell, QString& result)
@@ -112,7 +116,6 @@ bool Utils::ExcelUtils::parseExcelCell(const QVariant& cell, QString& result)
             // Use original string if it looks like a formatted number (has leading zeros)
             if (originalString.length() > 1 && originalString.at(0) == '0' && originalString.toInt() > 0) {
                 stringValue = originalString; // Preserve "001", "007", etc.
-                qDebug() << QString("Preserving leading zeros from int: '%1'").arg(originalString);
             } else {
                 stringValue = QString::number(cell.toLongLong());
             }
@@ -124,8 +127,6 @@ bool Utils::ExcelUtils::parseExcelCell(const QVariant& cell, QString& result)
             if (const double value = cell.toDouble(); originalString.length() > 1 && originalString.at(0) == '0' &&
                                                 value == std::floor(value) && value > 0) {
                 stringValue = originalString; // Preserve original format like "001"
-                qDebug() << QString("Preserving leading zeros: '%1' (was double %2)")
-                           .arg(originalString).arg(value);
             } else if (value == std::floor(value)) {
                 stringValue = QString::number(static_cast<long long>(value));
             } else {
@@ -2,14 +2,22 @@
 #define EXCELUTILS_H
 
 #include <QSqlDatabase>
+#include <QStringList>
 #include <QVariant>
+#include <functional>
 #include <tl/expected.hpp>
 
 namespace Utils {
 class ExcelUtils
 {
 public: 
-    // New method for reading Excel files
+    // Called once per non-empty row with the cleaned cell texts (index 0 = column A). Return false to stop.
+    using RowCallback = std::function<bool(int rowNumber, const QStringList& cells)>;
+
+    // Streams the worksheet row by row without loading the whole workbook; returns the rows delivered
+    static tl::expected<int, QString> forEachRow(const QString& filePath, const RowCallback& onRow);
+
+    // Reads the whole worksheet into memory; prefer forEachRow for large files
     static tl::expected<QVector<QVector<QVariant>>, QString> readExcelFile(const QString& filePath);
 
 private:
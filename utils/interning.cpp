@@ -0,0 +1,39 @@
+#include "interning.h"
+
+Utils::NamePool& Utils::NamePool::categories() {
+    static NamePool pool;
+    return pool;
+}
+
+Utils::NamePool& Utils::NamePool::modalities() {
+    static NamePool pool;
+    return pool;
+}
+
+void Utils::NamePool::insert(const int id, const QString& name) {
+    if (id <= 0) {
+        return;
+    }
+    QWriteLocker locker(&m_lock);
+    m_names.insert(id, name);
+}
+
+void Utils::NamePool::remove(const int id) {
+    QWriteLocker locker(&m_lock);
+    m_names.remove(id);
+}
+
+bool Utils::NamePool::contains(const int id) const {
+    QReadLocker locker(&m_lock);
+    return m_names.contains(id);
+}
+
+QString Utils::NamePool::name(const int id) const {
+    QReadLocker locker(&m_lock);
+    return m_names.value(id);
+}
+
+qsizetype Utils::NamePool::size() const {
+    QReadLocker locker(&m_lock);
+    return m_names.size();
+}
@@ -0,0 +1,55 @@
+#ifndef INTERNING_H
+#define INTERNING_H
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <utility>
+
+namespace Utils {
+
+// Process-wide id -> name table for lookup entities with only a handful of distinct values
+// (categories, modalities). Each name is stored once and handed out as an implicitly shared
+// copy, so the thousands of rows that refer to the same id never allocate their own text.
+// Safe to use from the export and journal threads.
+class NamePool
+{
+public:
+    static NamePool& categories();
+    static NamePool& modalities();
+
+    // Replaces the stored name; callers that rename or delete an entity keep the pool in sync
+    void insert(int id, const QString& name);
+    void remove(int id);
+
+    // Pooled name of the id, calling loadName only the first time the id is seen so row
+    // readers can skip materialising the column. Ids <= 0 (unset or NULL joins) are not pooled.
+    template <typename Loader>
+    QString resolve(int id, Loader&& loadName) {
+        if (id <= 0) {
+            return {};
+        }
+        {
+            QReadLocker locker(&m_lock);
+            if (const auto it = m_names.constFind(id); it != m_names.constEnd()) {
+                return it.value();
+            }
+        }
+        const QString name = std::forward<Loader>(loadName)();
+        QWriteLocker locker(&m_lock);
+        return *m_names.insert(id, name);
+    }
+
+    [[nodiscard]] bool contains(int id) const;
+    // Empty for an id never seen
+    [[nodiscard]] QString name(int id) const;
+    [[nodiscard]] qsizetype size() const;
+
+private:
+    mutable QReadWriteLock m_lock;
+    QHash<int, QString> m_names;
+};
+
+};
+
+#endif // INTERNING_H
@@ -0,0 +1,90 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+namespace Utils {
+
+// Unbounded lock-free multi-producer / single-consumer queue (Vyukov).
+// push() may be called from any thread; tryPop() only from the consumer thread.
+template <typename T>
+class MpscQueue
+{
+public:
+    MpscQueue() : m_head(&m_stub), m_tail(&m_stub) {}
+
+    ~MpscQueue() {
+        T value;
+        while (tryPop(value)) {
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        auto* node = new Node;
+        node->value = std::move(value);
+        enqueue(node);
+    }
+
+    bool tryPop(T& out) {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == &m_stub) {
+            if (!next) {
+                return false;
+            }
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            m_tail = next;
+            out = std::move(tail->value);
+            delete tail;
+            return true;
+        }
+
+        // A producer swapped the head but has not linked its node yet
+        if (tail != m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        m_stub.next.store(nullptr, std::memory_order_relaxed);
+        enqueue(&m_stub);
+
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            m_tail = next;
+            out = std::move(tail->value);
+            delete tail;
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next { nullptr };
+        T value {};
+    };
+
+    void enqueue(Node* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    std::atomic<Node*> m_head;
+    Node* m_tail;
+    Node m_stub;
+};
+
+};
+
+#endif // MPSCQUEUE_H
@@ -0,0 +1,177 @@
+#ifndef ORDERSTATISTICTREE_H
+#define ORDERSTATISTICTREE_H
+
+#include <QtGlobal>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Utils {
+
+// Ordered set of unique keys that also answers "how many keys are smaller than k"
+// and "which key is at index i" in O(log n). Implemented as a treap whose nodes
+// carry their subtree size. Key needs operator< and operator==.
+template <typename Key>
+class OrderStatisticTree
+{
+public:
+    OrderStatisticTree() = default;
+    OrderStatisticTree(OrderStatisticTree&&) noexcept = default;
+    OrderStatisticTree& operator=(OrderStatisticTree&&) noexcept = default;
+
+    [[nodiscard]] qsizetype size() const { return sizeOf(m_root); }
+    [[nodiscard]] bool isEmpty() const { return !m_root; }
+
+    void clear() { m_root.reset(); }
+
+    // Returns false when the key is already present
+    bool insert(const Key& key) {
+        if (contains(key)) {
+            return false;
+        }
+        auto [less, greaterOrEqual] = split(std::move(m_root), key, false);
+        auto node = std::make_unique<Node>(key, nextPriority());
+        m_root = merge(merge(std::move(less), std::move(node)), std::move(greaterOrEqual));
+        return true;
+    }
+
+    // Returns false when the key was not present
+    bool erase(const Key& key) {
+        auto [less, rest] = split(std::move(m_root), key, false);
+        auto [equal, greater] = split(std::move(rest), key, true);
+        const bool erased = static_cast<bool>(equal);
+        m_root = merge(std::move(less), std::move(greater));
+        return erased;
+    }
+
+    [[nodiscard]] bool contains(const Key& key) const {
+        const Node* node = m_root.get();
+        while (node) {
+            if (key < node->key) {
+                node = node->left.get();
+            } else if (node->key < key) {
+                node = node->right.get();
+            } else {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Number of keys strictly smaller than key
+    [[nodiscard]] qsizetype rank(const Key& key) const {
+        qsizetype smaller = 0;
+        const Node* node = m_root.get();
+        while (node) {
+            if (node->key < key) {
+                smaller += sizeOf(node->left) + 1;
+                node = node->right.get();
+            } else {
+                node = node->left.get();
+            }
+        }
+        return smaller;
+    }
+
+    // Key at 0-based index; index must be in [0, size())
+    [[nodiscard]] const Key& at(qsizetype index) const {
+        const Node* node = m_root.get();
+        while (true) {
+            const qsizetype leftSize = sizeOf(node->left);
+            if (index < leftSize) {
+                node = node->left.get();
+            } else if (index == leftSize) {
+                return node->key;
+            } else {
+                index -= leftSize + 1;
+                node = node->right.get();
+            }
+        }
+    }
+
+    // Visits keys in ascending order; stops after `limit` keys (limit < 0 visits all) or when visit returns false
+    template <typename Visitor>
+    void forEach(Visitor&& visit, const qsizetype limit = -1) const {
+        std::vector<const Node*> stack;
+        const Node* node = m_root.get();
+        qsizetype visited = 0;
+        while ((node || !stack.empty()) && (limit < 0 || visited < limit)) {
+            while (node) {
+                stack.push_back(node);
+                node = node->left.get();
+            }
+            node = stack.back();
+            stack.pop_back();
+            ++visited;
+            if (!visit(node->key)) {
+                return;
+            }
+            node = node->right.get();
+        }
+    }
+
+private:
+    struct Node {
+        Node(const Key& k, const quint32 p) : key(k), priority(p) {}
+
+        Key key;
+        quint32 priority;
+        qsizetype size = 1;
+        std::unique_ptr<Node> left;
+        std::unique_ptr<Node> right;
+    };
+    using NodePtr = std::unique_ptr<Node>;
+
+    NodePtr m_root;
+    quint32 m_seed = 0x9E3779B9u;
+
+    static qsizetype sizeOf(const NodePtr& node) { return node ? node->size : 0; }
+
+    static void update(Node* node) {
+        node->size = 1 + sizeOf(node->left) + sizeOf(node->right);
+    }
+
+    // xorshift32: heap priorities only need to be well spread, not unpredictable
+    quint32 nextPriority() {
+        m_seed ^= m_seed << 13;
+        m_seed ^= m_seed >> 17;
+        m_seed ^= m_seed << 5;
+        return m_seed;
+    }
+
+    // Splits into (keys < key, keys >= key), or (keys <= key, keys > key) when inclusive
+    static std::pair<NodePtr, NodePtr> split(NodePtr node, const Key& key, const bool inclusive) {
+        if (!node) {
+            return {};
+        }
+        const bool goesLeft = inclusive ? !(key < node->key) : node->key < key;
+        if (goesLeft) {
+            auto [less, greater] = split(std::move(node->right), key, inclusive);
+            node->right = std::move(less);
+            update(node.get());
+            return { std::move(node), std::move(greater) };
+        }
+        auto [less, greater] = split(std::move(node->left), key, inclusive);
+        node->left = std::move(greater);
+        update(node.get());
+        return { std::move(less), std::move(node) };
+    }
+
+    // Every key of a must be smaller than every key of b
+    static NodePtr merge(NodePtr a, NodePtr b) {
+        if (!a) return b;
+        if (!b) return a;
+        if (a->priority > b->priority) {
+            a->right = merge(std::move(a->right), std::move(b));
+            update(a.get());
+            return a;
+        }
+        b->left = merge(std::move(a), std::move(b->left));
+        update(b.get());
+        return b;
+    }
+};
+
+};
+
+#endif // ORDERSTATISTICTREE_H
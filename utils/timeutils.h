@@ -3,6 +3,7 @@
 
 #include <QString>
 #include <QDateTime>
+#include <QVariant>
 
 namespace Utils {
 
@@ -34,6 +35,19 @@ public:
     static QString toStringOrEmpty(const QDateTime& dateTime, Qt::DateFormat format = Qt::ISODate) {
         return isValid(dateTime) ? dateTime.toString(format) : QString();
     }
+
+    // Timestamps são gravados no banco como epoch em milissegundos (INTEGER); NULL = não definido
+    static QVariant toEpochMsOrNull(const QDateTime& dateTime) {
+        return dateTime.isValid() && isValid(dateTime) ? QVariant(dateTime.toMSecsSinceEpoch()) : QVariant();
+    }
+
+    static QDateTime fromEpochMs(const QVariant& value) {
+        return value.isNull() ? QDateTime() : QDateTime::fromMSecsSinceEpoch(value.toLongLong());
+    }
+
+    static QDateTime fromEpochMsOrDefault(const QVariant& value) {
+        return value.isNull() ? epochZero() : QDateTime::fromMSecsSinceEpoch(value.toLongLong());
+    }
 };
 
 };
@@ -0,0 +1,34 @@
+#include "trialclock.h"
+#include "timeutils.h"
+
+void Utils::TrialClock::start(const QDateTime& trialStart) {
+    m_timer.start();
+    m_anchorWall = trialStart;
+
+    // Single wall-clock read: how far into the trial we are at the anchor instant
+    const qint64 offsetMs = trialStart.msecsTo(DateTimeUtils::now());
+    m_anchorOffsetNs = offsetMs > 0 ? offsetMs * 1000000 : 0;
+}
+
+void Utils::TrialClock::stop() {
+    m_timer.invalidate();
+    m_anchorOffsetNs = 0;
+}
+
+qint64 Utils::TrialClock::elapsedNs() const {
+    if (!m_timer.isValid()) {
+        return 0;
+    }
+    return m_anchorOffsetNs + m_timer.nsecsElapsed();
+}
+
+Utils::TrialClock::Capture Utils::TrialClock::capture() const {
+    const qint64 ns = elapsedNs();
+    const qint64 ms = ns / 1000000;
+
+    return Capture {
+        .elapsedNs = ns,
+        .elapsedMs = ms,
+        .wallTime = m_anchorWall.addMSecs(ms)
+    };
+}
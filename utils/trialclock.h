@@ -0,0 +1,41 @@
+#ifndef TRIALCLOCK_H
+#define TRIALCLOCK_H
+
+#include <QDateTime>
+#include <QElapsedTimer>
+
+namespace Utils {
+
+// Monotonic timing source for a running trial.
+// The wall clock is read once, when the clock is anchored; every later reading
+// comes from the monotonic QElapsedTimer, so NTP steps and DST changes do not
+// affect durations.
+class TrialClock
+{
+public:
+    struct Capture {
+        qint64 elapsedNs = 0;   // monotonic time since the trial start
+        qint64 elapsedMs = 0;
+        QDateTime wallTime;     // trial start + elapsed, derived from the anchor
+    };
+
+    // Anchors the clock to the trial start. A start in the past (resumed trial)
+    // is honoured by offsetting the monotonic base once.
+    void start(const QDateTime& trialStart);
+    void stop();
+
+    [[nodiscard]] bool isRunning() const { return m_timer.isValid(); }
+    [[nodiscard]] QDateTime startWallTime() const { return m_anchorWall; }
+    [[nodiscard]] qint64 elapsedNs() const;
+    [[nodiscard]] qint64 elapsedMs() const { return elapsedNs() / 1000000; }
+    [[nodiscard]] Capture capture() const;
+
+private:
+    QElapsedTimer m_timer;
+    QDateTime m_anchorWall;
+    qint64 m_anchorOffsetNs = 0;
+};
+
+};
+
+#endif // TRIALCLOCK_H
@@ -0,0 +1,233 @@
+#include "xlsxstreamreader.h"
+#include "ziparchive.h"
+#include <QHash>
+#include <QXmlStreamReader>
+
+namespace {
+
+constexpr auto relationshipsNamespace = "http://schemas.openxmlformats.org/officeDocument/2006/relationships";
+
+QString resolvePath(const QString& baseDir, const QString& target) {
+    if (target.startsWith('/')) {
+        return target.mid(1);
+    }
+
+    // Targets are relative to the folder of the part that owns the .rels file
+    QStringList parts = baseDir.isEmpty() ? QStringList() : baseDir.split('/');
+    for (const auto& part : target.split('/')) {
+        if (part == "..") {
+            if (!parts.isEmpty()) {
+                parts.removeLast();
+            }
+        } else if (part != ".") {
+            parts.append(part);
+        }
+    }
+    return parts.join('/');
+}
+
+QVariant typedCellValue(const QString& type, const QString& text, const QStringList& sharedStrings) {
+    if (type == "s") {
+        const int index = text.toInt();
+        return index >= 0 && index < sharedStrings.size() ? QVariant(sharedStrings[index]) : QVariant();
+    }
+    if (type == "inlineStr" || type == "str" || type == "e") {
+        return text;
+    }
+    if (type == "b") {
+        return text == "1";
+    }
+
+    bool ok = false;
+    const double number = text.toDouble(&ok);
+    return ok ? QVariant(number) : (text.isEmpty() ? QVariant() : QVariant(text));
+}
+
+};
+
+QHash<QString, Utils::XlsxStreamReader::Relationship> Utils::XlsxStreamReader::readRelationships(const QByteArray& xml, const QString& baseDir) {
+    QHash<QString, Relationship> relationships;
+
+    QXmlStreamReader reader(xml);
+    while (!reader.atEnd()) {
+        if (reader.readNext() == QXmlStreamReader::StartElement && reader.name() == u"Relationship") {
+            const auto attributes = reader.attributes();
+            relationships.insert(attributes.value("Id").toString(), {
+                .type = attributes.value("Type").toString(),
+                .target = resolvePath(baseDir, attributes.value("Target").toString())
+            });
+        }
+    }
+
+    return relationships;
+}
+
+tl::expected<QString, QString> Utils::XlsxStreamReader::findActiveSheetPath(const QByteArray& workbookXml, const QHash<QString, Relationship>& relationships) {
+    QStringList sheetIds;
+    int activeTab = 0;
+
+    QXmlStreamReader reader(workbookXml);
+    while (!reader.atEnd()) {
+        if (reader.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+
+        if (reader.name() == u"workbookView") {
+            activeTab = reader.attributes().value("activeTab").toInt();
+        } else if (reader.name() == u"sheet") {
+            sheetIds.append(reader.attributes().value(relationshipsNamespace, "id").toString());
+        }
+    }
+
+    if (reader.hasError()) {
+        return tl::unexpected("Invalid workbook: " + reader.errorString());
+    }
+    if (sheetIds.isEmpty()) {
+        return tl::unexpected(QString("No worksheet found in Excel file"));
+    }
+
+    const QString sheetId = sheetIds.value(activeTab, sheetIds.first());
+    if (!relationships.contains(sheetId)) {
+        return tl::unexpected("Worksheet relationship not found: " + sheetId);
+    }
+
+    return relationships.value(sheetId).target;
+}
+
+tl::expected<QStringList, QString> Utils::XlsxStreamReader::readSharedStrings(const QByteArray& xml) {
+    QStringList strings;
+    QString current;
+    bool inPhonetic = false;
+
+    QXmlStreamReader reader(xml);
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QXmlStreamReader::StartElement:
+            if (reader.name() == u"si") {
+                current.clear();
+            } else if (reader.name() == u"rPh") {
+                inPhonetic = true;
+            } else if (reader.name() == u"t" && !inPhonetic) {
+                // Rich text is split in runs (<r><t>..</t></r>); plain text has a single <t>
+                current += reader.readElementText();
+            }
+            break;
+        case QXmlStreamReader::EndElement:
+            if (reader.name() == u"si") {
+                strings.append(current);
+            } else if (reader.name() == u"rPh") {
+                inPhonetic = false;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (reader.hasError()) {
+        return tl::unexpected("Invalid shared strings table: " + reader.errorString());
+    }
+
+    return strings;
+}
+
+int Utils::XlsxStreamReader::columnIndex(const QStringView cellReference) {
+    int column = 0;
+    for (const QChar ch : cellReference) {
+        if (!ch.isLetter()) {
+            break;
+        }
+        column = column * 26 + (ch.toUpper().unicode() - 'A' + 1);
+    }
+    return column - 1;
+}
+
+tl::expected<int, QString> Utils::XlsxStreamReader::forEachRow(const QString& filePath, const RowCallback& onRow) {
+    const ZipArchive zip(filePath);
+    if (!zip.isReadable()) {
+        return tl::unexpected("Error opening Excel file: " + filePath);
+    }
+
+    // Package -> workbook -> active sheet, following the relationship parts
+    QString workbookPath = "xl/workbook.xml";
+    for (const auto& relationship : readRelationships(zip.fileData("_rels/.rels"), QString())) {
+        if (relationship.type.endsWith("/officeDocument")) {
+            workbookPath = relationship.target;
+        }
+    }
+
+    const QString workbookDir = workbookPath.section('/', 0, -2);
+    const QString workbookRelsPath = (workbookDir.isEmpty() ? QString() : workbookDir + "/") + "_rels/" + workbookPath.section('/', -1) + ".rels";
+    const auto relationships = readRelationships(zip.fileData(workbookRelsPath), workbookDir);
+
+    const auto sheetPath = findActiveSheetPath(zip.fileData(workbookPath), relationships);
+    if (!sheetPath) {
+        return tl::unexpected(sheetPath.error());
+    }
+
+    QStringList sharedStrings;
+    for (const auto& relationship : relationships) {
+        if (relationship.type.endsWith("/sharedStrings")) {
+            auto strings = readSharedStrings(zip.fileData(relationship.target));
+            if (!strings) {
+                return tl::unexpected(strings.error());
+            }
+            sharedStrings = std::move(strings.value());
+        }
+    }
+
+    const QByteArray sheetXml = zip.fileData(sheetPath.value());
+    if (sheetXml.isEmpty()) {
+        return tl::unexpected("Worksheet not found in Excel file: " + sheetPath.value());
+    }
+
+    QXmlStreamReader reader(sheetXml);
+    QVector<QVariant> cells;
+    int rowNumber = 0;
+    int cellColumn = 0;
+    QString cellType;
+    QString cellText;
+    int delivered = 0;
+
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QXmlStreamReader::StartElement:
+            if (reader.name() == u"row") {
+                const int declaredRow = reader.attributes().value("r").toInt();
+                rowNumber = declaredRow > 0 ? declaredRow : rowNumber + 1;
+                cells.clear();
+            } else if (reader.name() == u"c") {
+                const auto attributes = reader.attributes();
+                const auto reference = attributes.value("r");
+                cellColumn = reference.isEmpty() ? static_cast<int>(cells.size()) : columnIndex(reference);
+                cellType = attributes.value("t").toString();
+                cellText.clear();
+            } else if (reader.name() == u"v" || reader.name() == u"t") {
+                // <v> holds the value; inline strings keep it in <is><t>
+                cellText += reader.readElementText();
+            }
+            break;
+        case QXmlStreamReader::EndElement:
+            if (reader.name() == u"c" && cellColumn >= 0) {
+                if (cellColumn >= cells.size()) {
+                    cells.resize(cellColumn + 1);
+                }
+                cells[cellColumn] = typedCellValue(cellType, cellText, sharedStrings);
+            } else if (reader.name() == u"row") {
+                delivered++;
+                if (!onRow(rowNumber, cells)) {
+                    return delivered;
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (reader.hasError()) {
+        return tl::unexpected(QString("Invalid worksheet XML at line %1: %2").arg(reader.lineNumber()).arg(reader.errorString()));
+    }
+
+    return delivered;
+}
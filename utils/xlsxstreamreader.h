@@ -0,0 +1,43 @@
+#ifndef XLSXSTREAMREADER_H
+#define XLSXSTREAMREADER_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <functional>
+#include <tl/expected.hpp>
+
+namespace Utils {
+
+// Row-by-row reader for .xlsx workbooks.
+// Only the sheet XML and the shared strings table are kept in memory; the sheet is
+// parsed with QXmlStreamReader and every row is handed to the callback as it is read,
+// so no cell matrix or QXlsx::Document is ever built.
+class XlsxStreamReader
+{
+public:
+    // cells[0] is column A and gaps are filled with null variants. Values are typed like
+    // QXlsx::Worksheet::read() returns them (QString, double or bool). Return false to stop.
+    using RowCallback = std::function<bool(int rowNumber, const QVector<QVariant>& cells)>;
+
+    // Streams the workbook's active sheet (the first one when none is marked active).
+    // Returns the number of rows handed to the callback.
+    static tl::expected<int, QString> forEachRow(const QString& filePath, const RowCallback& onRow);
+
+private:
+    struct Relationship {
+        QString type;
+        QString target;
+    };
+
+    static QHash<QString, Relationship> readRelationships(const QByteArray& xml, const QString& baseDir);
+    static tl::expected<QString, QString> findActiveSheetPath(const QByteArray& workbookXml, const QHash<QString, Relationship>& relationships);
+    static tl::expected<QStringList, QString> readSharedStrings(const QByteArray& xml);
+    static int columnIndex(QStringView cellReference);
+};
+
+};
+
+#endif // XLSXSTREAMREADER_H
@@ -0,0 +1,466 @@
+#include "xlsxstreamwriter.h"
+#include <QDateTime>
+#include <QRegularExpression>
+#include <algorithm>
+#include <array>
+
+namespace {
+
+void putU16(QByteArray& out, const quint16 value) {
+    out.append(static_cast<char>(value & 0xFF));
+    out.append(static_cast<char>((value >> 8) & 0xFF));
+}
+
+void putU32(QByteArray& out, const quint32 value) {
+    putU16(out, static_cast<quint16>(value & 0xFFFF));
+    putU16(out, static_cast<quint16>(value >> 16));
+}
+
+constexpr quint32 localHeaderSignature = 0x04034b50;
+constexpr quint32 centralHeaderSignature = 0x02014b50;
+constexpr quint32 endOfCentralDirectorySignature = 0x06054b50;
+constexpr quint16 zipVersion = 20;
+// bit 11: names are UTF-8; CRC and sizes are patched into the local header, so no data descriptor (bit 3)
+constexpr quint16 entryFlags = 0x0800;
+// Offset of the CRC field in a local file header
+constexpr qint64 localHeaderCrcOffset = 14;
+
+constexpr auto spreadsheetNs = "http://schemas.openxmlformats.org/spreadsheetml/2006/main";
+constexpr auto relationshipsNs = "http://schemas.openxmlformats.org/officeDocument/2006/relationships";
+
+};
+
+Utils::XlsxStreamWriter::XlsxStreamWriter(QIODevice* device)
+    : m_device(device) {
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDate date = now.date();
+    const QTime time = now.time();
+    m_dosTime = static_cast<quint16>((time.hour() << 11) | (time.minute() << 5) | (time.second() / 2));
+    m_dosDate = static_cast<quint16>(((std::max(date.year(), 1980) - 1980) << 9) | (date.month() << 5) | date.day());
+    m_buffer.reserve(flushThreshold + 4096);
+}
+
+tl::expected<void, QString> Utils::XlsxStreamWriter::beginSheet(const QString& name, const QVector<double>& columnWidths) {
+    if (!m_device || !m_device->isWritable()) {
+        return tl::unexpected(QString("[XW] Output device is not writable"));
+    }
+    if (m_device->isSequential()) {
+        return tl::unexpected(QString("[XW] Output device is not seekable"));
+    }
+    if (m_sheetOpen) {
+        return tl::unexpected(QString("[XW] Previous sheet was not closed"));
+    }
+
+    m_sheetNames.append(sanitizeSheetName(name, m_sheetNames));
+    m_sheetOpen = true;
+    m_currentRow = 0;
+
+    beginEntry(QString("xl/worksheets/sheet%1.xml").arg(m_sheetNames.size()));
+
+    append(R"(<?xml version="1.0" encoding="UTF-8" standalone="yes"?>)" "\n");
+    append(QByteArray("<worksheet xmlns=\"") + spreadsheetNs + "\" xmlns:r=\"" + relationshipsNs + "\">");
+
+    // The first sheet is the selected one; every sheet keeps its header row frozen
+    append(QByteArray("<sheetViews><sheetView") + (m_sheetNames.size() == 1 ? " tabSelected=\"1\"" : "")
+           + " workbookViewId=\"0\"><pane ySplit=\"1\" topLeftCell=\"A2\" activePane=\"bottomLeft\" state=\"frozen\"/>"
+             "</sheetView></sheetViews>");
+    append("<sheetFormatPr defaultRowHeight=\"15\"/>");
+
+    if (!columnWidths.isEmpty()) {
+        append("<cols>");
+        for (int i = 0; i < columnWidths.size(); ++i) {
+            const QByteArray column = QByteArray::number(i + 1);
+            append("<col min=\"" + column + "\" max=\"" + column + "\" width=\""
+                   + QByteArray::number(columnWidths[i], 'f', 2) + "\" customWidth=\"1\"/>");
+        }
+        append("</cols>");
+    }
+
+    append("<sheetData>");
+    return {};
+}
+
+void Utils::XlsxStreamWriter::writeHeaderRow(const QStringList& headers) {
+    if (!m_sheetOpen) {
+        return;
+    }
+
+    const QByteArray rowNumber = QByteArray::number(++m_currentRow);
+    QByteArray row = "<row r=\"" + rowNumber + "\">";
+    for (int c = 0; c < headers.size(); ++c) {
+        row += "<c r=\"" + columnName(c) + rowNumber + "\" t=\"s\" s=\"" + QByteArray::number(HeaderStyle) + "\"><v>"
+               + QByteArray::number(sharedString(headers[c])) + "</v></c>";
+    }
+    row += "</row>";
+    append(row);
+    ++m_headerRows;
+}
+
+void Utils::XlsxStreamWriter::writeRow(const QStringList& values, const Style style) {
+    if (!m_sheetOpen) {
+        return;
+    }
+
+    const QByteArray rowNumber = QByteArray::number(++m_currentRow);
+    const QByteArray styleAttribute = style == DefaultStyle ? QByteArray() : " s=\"" + QByteArray::number(style) + "\"";
+
+    QByteArray row = "<row r=\"" + rowNumber + "\">";
+    for (int c = 0; c < values.size(); ++c) {
+        row += "<c r=\"" + columnName(c) + rowNumber + "\"" + styleAttribute;
+        if (values[c].isEmpty()) {
+            row += "/>";
+        } else {
+            row += " t=\"inlineStr\"><is><t xml:space=\"preserve\">" + escaped(values[c]) + "</t></is></c>";
+        }
+    }
+    row += "</row>";
+    append(row);
+    ++m_totalRows;
+}
+
+tl::expected<void, QString> Utils::XlsxStreamWriter::endSheet() {
+    if (!m_sheetOpen) {
+        return tl::unexpected(QString("[XW] No open sheet"));
+    }
+
+    append("</sheetData></worksheet>");
+    endEntry();
+    m_sheetOpen = false;
+
+    if (!m_error.isEmpty()) {
+        return tl::unexpected(m_error);
+    }
+    return {};
+}
+
+tl::expected<void, QString> Utils::XlsxStreamWriter::finish() {
+    if (m_sheetOpen) {
+        if (auto closed = endSheet(); !closed) {
+            return closed;
+        }
+    }
+
+    // A workbook needs at least one sheet
+    if (m_sheetNames.isEmpty()) {
+        if (auto begun = beginSheet("Sheet1", {}); !begun) {
+            return begun;
+        }
+        if (auto closed = endSheet(); !closed) {
+            return closed;
+        }
+    }
+
+    writeEntry("xl/sharedStrings.xml", sharedStringsXml());
+    writeEntry("xl/styles.xml", stylesXml());
+    writeEntry("xl/workbook.xml", workbookXml());
+    writeEntry("xl/_rels/workbook.xml.rels", workbookRelsXml());
+    writeEntry("_rels/.rels", rootRelsXml());
+    writeEntry("[Content_Types].xml", contentTypesXml());
+    writeCentralDirectory();
+
+    if (!m_error.isEmpty()) {
+        return tl::unexpected(m_error);
+    }
+    return {};
+}
+
+QString Utils::XlsxStreamWriter::sanitizeSheetName(const QString& name, const QStringList& taken) {
+    static const QRegularExpression invalid(R"([\[\]:*?/\\])");
+
+    QString base = name;
+    base.replace(invalid, "_");
+    base = base.trimmed();
+    // Excel rejects names that start or end with an apostrophe
+    while (base.startsWith('\'')) base.remove(0, 1);
+    while (base.endsWith('\'')) base.chop(1);
+    if (base.isEmpty()) {
+        base = "Sheet";
+    }
+    base.truncate(31);
+
+    QString candidate = base;
+    for (int suffix = 2; taken.contains(candidate, Qt::CaseInsensitive); ++suffix) {
+        const QString tail = QString(" (%1)").arg(suffix);
+        candidate = base.left(31 - tail.size()) + tail;
+    }
+    return candidate;
+}
+
+void Utils::XlsxStreamWriter::beginEntry(const QString& name) {
+    ZipEntry entry;
+    entry.name = name.toUtf8();
+    entry.offset = m_offset;
+
+    QByteArray header;
+    putU32(header, localHeaderSignature);
+    putU16(header, zipVersion);
+    putU16(header, entryFlags);
+    putU16(header, 0); // stored
+    putU16(header, m_dosTime);
+    putU16(header, m_dosDate);
+    putU32(header, 0); // crc, sizes: patched in endEntry
+    putU32(header, 0);
+    putU32(header, 0);
+    putU16(header, static_cast<quint16>(entry.name.size()));
+    putU16(header, 0);
+    header += entry.name;
+
+    m_entries.append(entry);
+    m_entryOpen = true;
+    writeRaw(header);
+}
+
+void Utils::XlsxStreamWriter::append(const QByteArray& data) {
+    m_buffer += data;
+    if (m_buffer.size() >= flushThreshold) {
+        flushBuffer();
+    }
+}
+
+void Utils::XlsxStreamWriter::append(const char* data) {
+    append(QByteArray(data));
+}
+
+void Utils::XlsxStreamWriter::endEntry() {
+    flushBuffer();
+
+    m_entryOpen = false;
+    patchLocalHeader(m_entries.last());
+}
+
+void Utils::XlsxStreamWriter::writeEntry(const QString& name, const QByteArray& data) {
+    beginEntry(name);
+    append(data);
+    endEntry();
+}
+
+void Utils::XlsxStreamWriter::flushBuffer() {
+    if (m_buffer.isEmpty()) {
+        return;
+    }
+    if (m_entryOpen) {
+        ZipEntry& entry = m_entries.last();
+        entry.crc = crc32(entry.crc, m_buffer);
+        entry.size += static_cast<quint32>(m_buffer.size());
+    }
+    writeRaw(m_buffer);
+    m_buffer.clear();
+}
+
+void Utils::XlsxStreamWriter::writeRaw(const QByteArray& data) {
+    if (!m_error.isEmpty()) {
+        return;
+    }
+    if (m_device->write(data) != data.size()) {
+        m_error = "[XW] Error writing workbook: " + m_device->errorString();
+        return;
+    }
+    m_offset += static_cast<quint32>(data.size());
+}
+
+void Utils::XlsxStreamWriter::patchLocalHeader(const ZipEntry& entry) {
+    if (!m_error.isEmpty()) {
+        return;
+    }
+
+    QByteArray fields;
+    putU32(fields, entry.crc);
+    putU32(fields, entry.size); // compressed == uncompressed for stored entries
+    putU32(fields, entry.size);
+
+    // Device positions are relative to where the writer started, like m_offset
+    const qint64 end = m_device->pos();
+    const qint64 start = end - m_offset;
+    if (!m_device->seek(start + entry.offset + localHeaderCrcOffset) || m_device->write(fields) != fields.size() || !m_device->seek(end)) {
+        m_error = "[XW] Error writing workbook: " + m_device->errorString();
+    }
+}
+
+void Utils::XlsxStreamWriter::writeCentralDirectory() {
+    const quint32 directoryOffset = m_offset;
+
+    QByteArray directory;
+    for (const auto& entry : m_entries) {
+        putU32(directory, centralHeaderSignature);
+        putU16(directory, zipVersion); // made by
+        putU16(directory, zipVersion); // needed
+        putU16(directory, entryFlags);
+        putU16(directory, 0);
+        putU16(directory, m_dosTime);
+        putU16(directory, m_dosDate);
+        putU32(directory, entry.crc);
+        putU32(directory, entry.size);
+        putU32(directory, entry.size);
+        putU16(directory, static_cast<quint16>(entry.name.size()));
+        putU16(directory, 0); // extra
+        putU16(directory, 0); // comment
+        putU16(directory, 0); // disk
+        putU16(directory, 0); // internal attributes
+        putU32(directory, 0); // external attributes
+        putU32(directory, entry.offset);
+        directory += entry.name;
+    }
+
+    QByteArray end;
+    putU32(end, endOfCentralDirectorySignature);
+    putU16(end, 0);
+    putU16(end, 0);
+    putU16(end, static_cast<quint16>(m_entries.size()));
+    putU16(end, static_cast<quint16>(m_entries.size()));
+    putU32(end, static_cast<quint32>(directory.size()));
+    putU32(end, directoryOffset);
+    putU16(end, 0);
+
+    writeRaw(directory);
+    writeRaw(end);
+}
+
+QByteArray Utils::XlsxStreamWriter::contentTypesXml() const {
+    QByteArray xml = R"(<?xml version="1.0" encoding="UTF-8" standalone="yes"?>)" "\n"
+        R"(<Types xmlns="http://schemas.openxmlformats.org/package/2006/content-types">)"
+        R"(<Default Extension="rels" ContentType="application/vnd.openxmlformats-package.relationships+xml"/>)"
+        R"(<Default Extension="xml" ContentType="application/xml"/>)"
+        R"(<Override PartName="/xl/workbook.xml" ContentType="application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml"/>)";
+    for (int i = 1; i <= m_sheetNames.size(); ++i) {
+        xml += "<Override PartName=\"/xl/worksheets/sheet" + QByteArray::number(i)
+               + ".xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>";
+    }
+    xml += R"(<Override PartName="/xl/styles.xml" ContentType="application/vnd.openxmlformats-officedocument.spreadsheetml.styles+xml"/>)"
+           R"(<Override PartName="/xl/sharedStrings.xml" ContentType="application/vnd.openxmlformats-officedocument.spreadsheetml.sharedStrings+xml"/>)"
+           "</Types>";
+    return xml;
+}
+
+QByteArray Utils::XlsxStreamWriter::workbookXml() const {
+    QByteArray xml = R"(<?xml version="1.0" encoding="UTF-8" standalone="yes"?>)" "\n";
+    xml += QByteArray("<workbook xmlns=\"") + spreadsheetNs + "\" xmlns:r=\"" + relationshipsNs + "\">";
+    xml += R"(<bookViews><workbookView activeTab="0"/></bookViews><sheets>)";
+    for (int i = 0; i < m_sheetNames.size(); ++i) {
+        const QByteArray id = QByteArray::number(i + 1);
+        xml += "<sheet name=\"" + escaped(m_sheetNames[i]) + "\" sheetId=\"" + id + "\" r:id=\"rId" + id + "\"/>";
+    }
+    xml += "</sheets></workbook>";
+    return xml;
+}
+
+QByteArray Utils::XlsxStreamWriter::workbookRelsXml() const {
+    const auto sheets = static_cast<int>(m_sheetNames.size());
+    QByteArray xml = R"(<?xml version="1.0" encoding="UTF-8" standalone="yes"?>)" "\n"
+        R"(<Relationships xmlns="http://schemas.openxmlformats.org/package/2006/relationships">)";
+    for (int i = 1; i <= sheets; ++i) {
+        xml += "<Relationship Id=\"rId" + QByteArray::number(i)
+               + "\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet\" Target=\"worksheets/sheet"
+               + QByteArray::number(i) + ".xml\"/>";
+    }
+    xml += "<Relationship Id=\"rId" + QByteArray::number(sheets + 1)
+           + R"(" Type="http://schemas.openxmlformats.org/officeDocument/2006/relationships/styles" Target="styles.xml"/>)";
+    xml += "<Relationship Id=\"rId" + QByteArray::number(sheets + 2)
+           + R"(" Type="http://schemas.openxmlformats.org/officeDocument/2006/relationships/sharedStrings" Target="sharedStrings.xml"/>)";
+    xml += "</Relationships>";
+    return xml;
+}
+
+QByteArray Utils::XlsxStreamWriter::sharedStringsXml() const {
+    QByteArray xml = R"(<?xml version="1.0" encoding="UTF-8" standalone="yes"?>)" "\n";
+    xml += QByteArray("<sst xmlns=\"") + spreadsheetNs + "\" count=\"" + QByteArray::number(m_sharedStringRefs)
+           + "\" uniqueCount=\"" + QByteArray::number(m_sharedStrings.size()) + "\">";
+    for (const auto& text : m_sharedStrings) {
+        xml += "<si><t xml:space=\"preserve\">" + escaped(text) + "</t></si>";
+    }
+    xml += "</sst>";
+    return xml;
+}
+
+QByteArray Utils::XlsxStreamWriter::rootRelsXml() {
+    return R"(<?xml version="1.0" encoding="UTF-8" standalone="yes"?>)" "\n"
+        R"(<Relationships xmlns="http://schemas.openxmlformats.org/package/2006/relationships">)"
+        R"(<Relationship Id="rId1" Type="http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument" Target="xl/workbook.xml"/>)"
+        "</Relationships>";
+}
+
+QByteArray Utils::XlsxStreamWriter::stylesXml() {
+    // cellXfs order must match the Style enum
+    return QByteArray(R"(<?xml version="1.0" encoding="UTF-8" standalone="yes"?>)" "\n")
+        + "<styleSheet xmlns=\"" + spreadsheetNs + "\">"
+        R"(<fonts count="2">)"
+            R"(<font><sz val="11"/><name val="Calibri"/><family val="2"/></font>)"
+            R"(<font><b/><sz val="11"/><name val="Calibri"/><family val="2"/></font>)"
+        "</fonts>"
+        R"(<fills count="5">)"
+            R"(<fill><patternFill patternType="none"/></fill>)"
+            R"(<fill><patternFill patternType="gray125"/></fill>)"
+            R"(<fill><patternFill patternType="solid"><fgColor rgb="FFC0C0C0"/><bgColor indexed="64"/></patternFill></fill>)"
+            R"(<fill><patternFill patternType="solid"><fgColor rgb="FFFFFFFF"/><bgColor indexed="64"/></patternFill></fill>)"
+            R"(<fill><patternFill patternType="solid"><fgColor rgb="FFEBEBEB"/><bgColor indexed="64"/></patternFill></fill>)"
+        "</fills>"
+        R"(<borders count="1"><border><left/><right/><top/><bottom/><diagonal/></border></borders>)"
+        R"(<cellStyleXfs count="1"><xf numFmtId="0" fontId="0" fillId="0" borderId="0"/></cellStyleXfs>)"
+        R"(<cellXfs count="4">)"
+            R"(<xf numFmtId="0" fontId="0" fillId="0" borderId="0" xfId="0"/>)"
+            R"(<xf numFmtId="0" fontId="1" fillId="2" borderId="0" xfId="0" applyFont="1" applyFill="1" applyAlignment="1"><alignment horizontal="center"/></xf>)"
+            R"(<xf numFmtId="0" fontId="0" fillId="3" borderId="0" xfId="0" applyFill="1"/>)"
+            R"(<xf numFmtId="0" fontId="0" fillId="4" borderId="0" xfId="0" applyFill="1"/>)"
+        "</cellXfs>"
+        R"(<cellStyles count="1"><cellStyle name="Normal" xfId="0" builtinId="0"/></cellStyles>)"
+        "</styleSheet>";
+}
+
+int Utils::XlsxStreamWriter::sharedString(const QString& text) {
+    ++m_sharedStringRefs;
+    const auto it = m_sharedStringIndex.constFind(text);
+    if (it != m_sharedStringIndex.constEnd()) {
+        return it.value();
+    }
+    const int index = static_cast<int>(m_sharedStrings.size());
+    m_sharedStrings.append(text);
+    m_sharedStringIndex.insert(text, index);
+    return index;
+}
+
+QByteArray Utils::XlsxStreamWriter::columnName(int column) {
+    QByteArray name;
+    for (++column; column > 0; column = (column - 1) / 26) {
+        name.prepend(static_cast<char>('A' + (column - 1) % 26));
+    }
+    return name;
+}
+
+QByteArray Utils::XlsxStreamWriter::escaped(const QString& text) {
+    QString result;
+    result.reserve(text.size());
+    for (const QChar ch : text) {
+        switch (ch.unicode()) {
+        case '&': result += QLatin1String("&amp;"); break;
+        case '<': result += QLatin1String("&lt;"); break;
+        case '>': result += QLatin1String("&gt;"); break;
+        case '"': result += QLatin1String("&quot;"); break;
+        case '\t': case '\n': case '\r': result += ch; break;
+        default:
+            // Other control characters are not allowed in XML 1.0
+            if (ch.unicode() >= 0x20) {
+                result += ch;
+            }
+        }
+    }
+    return result.toUtf8();
+}
+
+quint32 Utils::XlsxStreamWriter::crc32(const quint32 crc, const QByteArray& data) {
+    static const auto table = [] {
+        std::array<quint32, 256> t {};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    quint32 c = crc ^ 0xFFFFFFFFu;
+    for (const char byte : data) {
+        c = table[(c ^ static_cast<quint8>(byte)) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
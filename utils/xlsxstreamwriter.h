@@ -0,0 +1,110 @@
+#ifndef XLSXSTREAMWRITER_H
+#define XLSXSTREAMWRITER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QIODevice>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <tl/expected.hpp>
+
+namespace Utils {
+
+// Forward-only .xlsx writer.
+// Each sheet's XML is written straight into the zip stream while rows are added, so
+// memory use does not grow with the number of rows. The trade-offs that make this possible:
+//  - zip entries are stored (not deflated): files are larger, CPU cost is minimal;
+//  - the device must be seekable: each entry's CRC and size are written back into its local header;
+//  - column widths are fixed per sheet up front instead of measured from the data;
+//  - repeated texts (headers) go to the shared strings table, data cells are inline strings;
+//  - the style table is fixed and written once (see Style).
+// Sheets are written one after the other: beginSheet, rows, endSheet; finish() writes the
+// workbook parts and the zip central directory.
+class XlsxStreamWriter
+{
+public:
+    enum Style {
+        DefaultStyle = 0,
+        HeaderStyle,        // bold, light gray background, centered
+        ZebraWhiteStyle,
+        ZebraGrayStyle
+    };
+
+    explicit XlsxStreamWriter(QIODevice* device);
+
+    // name is sanitized (Excel rules) and made unique; widths are in Excel character units
+    [[nodiscard]] tl::expected<void, QString> beginSheet(const QString& name, const QVector<double>& columnWidths);
+    // Header cells use the shared strings table and the header style; the row stays visible when scrolling
+    void writeHeaderRow(const QStringList& headers);
+    void writeRow(const QStringList& values, Style style = DefaultStyle);
+    [[nodiscard]] tl::expected<void, QString> endSheet();
+
+    [[nodiscard]] tl::expected<void, QString> finish();
+
+    [[nodiscard]] int sheetCount() const { return static_cast<int>(m_sheetNames.size()); }
+    // Data rows only; header rows are counted apart
+    [[nodiscard]] qint64 rowsWritten() const { return m_totalRows; }
+    [[nodiscard]] qint64 headerRowsWritten() const { return m_headerRows; }
+
+    // At most 31 characters, none of []:*?/\ and unique among `taken` (case-insensitive)
+    [[nodiscard]] static QString sanitizeSheetName(const QString& name, const QStringList& taken);
+
+private:
+    struct ZipEntry {
+        QByteArray name;
+        quint32 crc = 0;
+        quint32 size = 0;
+        quint32 offset = 0;
+    };
+
+    static constexpr qsizetype flushThreshold = 64 * 1024;
+
+    QIODevice* m_device;
+    QString m_error;
+
+    QVector<ZipEntry> m_entries;
+    bool m_entryOpen = false;
+    QByteArray m_buffer;
+    quint32 m_offset = 0;
+    quint16 m_dosTime = 0;
+    quint16 m_dosDate = 0;
+
+    QStringList m_sheetNames;
+    bool m_sheetOpen = false;
+    int m_currentRow = 0;
+    qint64 m_totalRows = 0;
+    qint64 m_headerRows = 0;
+
+    QStringList m_sharedStrings;
+    QHash<QString, int> m_sharedStringIndex;
+    int m_sharedStringRefs = 0;
+
+    // zip container
+    void beginEntry(const QString& name);
+    void append(const QByteArray& data);
+    void append(const char* data);
+    void endEntry();
+    void writeEntry(const QString& name, const QByteArray& data);
+    void flushBuffer();
+    void writeRaw(const QByteArray& data);
+    void patchLocalHeader(const ZipEntry& entry);
+    void writeCentralDirectory();
+
+    // workbook parts
+    [[nodiscard]] QByteArray contentTypesXml() const;
+    [[nodiscard]] QByteArray workbookXml() const;
+    [[nodiscard]] QByteArray workbookRelsXml() const;
+    [[nodiscard]] QByteArray sharedStringsXml() const;
+    static QByteArray rootRelsXml();
+    static QByteArray stylesXml();
+
+    int sharedString(const QString& text);
+    static QByteArray columnName(int column);
+    static QByteArray escaped(const QString& text);
+    static quint32 crc32(quint32 crc, const QByteArray& data);
+};
+
+};
+
+#endif // XLSXSTREAMWRITER_H
@@ -0,0 +1,16 @@
+#include "ziparchive.h"
+#include <QtGui/private/qzipreader_p.h>
+
+Utils::ZipArchive::ZipArchive(const QString& filePath)
+    : m_reader(std::make_unique<QZipReader>(filePath)) {
+}
+
+Utils::ZipArchive::~ZipArchive() = default;
+
+bool Utils::ZipArchive::isReadable() const {
+    return m_reader->exists() && m_reader->status() == QZipReader::NoError;
+}
+
+QByteArray Utils::ZipArchive::fileData(const QString& name) const {
+    return m_reader->fileData(name);
+}
@@ -0,0 +1,36 @@
+#ifndef ZIPARCHIVE_H
+#define ZIPARCHIVE_H
+
+#include <QByteArray>
+#include <QString>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+class QZipReader;
+QT_END_NAMESPACE
+
+namespace Utils {
+
+// Read-only access to the entries of a zip package (.xlsx parts).
+// Wraps Qt's zip reader so its private header stays in one translation unit.
+class ZipArchive
+{
+public:
+    explicit ZipArchive(const QString& filePath);
+    ~ZipArchive();
+
+    ZipArchive(const ZipArchive&) = delete;
+    ZipArchive& operator=(const ZipArchive&) = delete;
+
+    // False when the file is missing or is not a readable zip
+    [[nodiscard]] bool isReadable() const;
+    // Uncompressed contents of the entry; empty when it does not exist
+    [[nodiscard]] QByteArray fileData(const QString& name) const;
+
+private:
+    std::unique_ptr<QZipReader> m_reader;
+};
+
+};
+
+#endif // ZIPARCHIVE_H